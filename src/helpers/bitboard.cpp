@@ -0,0 +1,150 @@
+#include "bitboard.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BITBOARD_AVX2_KERNEL
+#endif
+
+// Constructor.
+Bitboard::Bitboard(unsigned int _width, unsigned int _height) : width(_width), height(_height) {
+  wordsPerRow = ((width + 63) / 64 + 3) / 4 * 4;
+  words.assign((size_t) wordsPerRow * height, 0);
+}
+
+// Method that sets the bit of a cell.
+void Bitboard::set(unsigned int x, unsigned int y) {
+  words[(size_t) y * wordsPerRow + x / 64] |= 1ULL << (x % 64);
+}
+
+// Method that clears the bit of a cell.
+void Bitboard::reset(unsigned int x, unsigned int y) {
+  words[(size_t) y * wordsPerRow + x / 64] &= ~(1ULL << (x % 64));
+}
+
+// Method that returns the bit of a cell.
+bool Bitboard::test(unsigned int x, unsigned int y) const {
+  return (words[(size_t) y * wordsPerRow + x / 64] >> (x % 64)) & 1ULL;
+}
+
+// Method that returns the number of set bits.
+unsigned long long Bitboard::count() const {
+  unsigned long long bitsCount = 0;
+  for (uint64_t word : words) {
+    bitsCount += __builtin_popcountll(word);
+  }
+  return bitsCount;
+}
+
+#ifdef BITBOARD_AVX2_KERNEL
+// Function that expands a BFS frontier by one layer within a row, four words (256 cells) at a time. Returns the number of cells in the new layer.
+__attribute__((target("avx2")))
+static unsigned long long expandBitboardRowVectorized(const uint64_t* row, const uint64_t* above, const uint64_t* below, const uint64_t* openRow, uint64_t* visitedRow, uint64_t* nextRow, unsigned int wordsPerRow) {
+  unsigned long long layerSize = 0;
+  uint64_t previousTopBit = 0;
+  for (unsigned int w = 0; w < wordsPerRow; w += 4) {
+    __m256i cells = _mm256_loadu_si256((const __m256i*) (row + w));
+    __m256i vertical = _mm256_setzero_si256();
+    if (above) vertical = _mm256_or_si256(vertical, _mm256_loadu_si256((const __m256i*) (above + w)));
+    if (below) vertical = _mm256_or_si256(vertical, _mm256_loadu_si256((const __m256i*) (below + w)));
+
+    // Shift the cells one column to the right, carrying the top bit of each word into the next word.
+    __m256i topBits = _mm256_permute4x64_epi64(_mm256_srli_epi64(cells, 63), _MM_SHUFFLE(2, 1, 0, 3));
+    topBits = _mm256_blend_epi32(topBits, _mm256_set_epi64x(0, 0, 0, (long long) previousTopBit), 0x03);
+    __m256i shiftedRight = _mm256_or_si256(_mm256_slli_epi64(cells, 1), topBits);
+
+    // Shift the cells one column to the left, carrying the bottom bit of each word into the previous word.
+    uint64_t nextBottomBit = w + 4 < wordsPerRow ? (row[w + 4] & 1ULL) << 63 : 0;
+    __m256i bottomBits = _mm256_permute4x64_epi64(_mm256_slli_epi64(cells, 63), _MM_SHUFFLE(0, 3, 2, 1));
+    bottomBits = _mm256_blend_epi32(bottomBits, _mm256_set_epi64x((long long) nextBottomBit, 0, 0, 0), 0xC0);
+    __m256i shiftedLeft = _mm256_or_si256(_mm256_srli_epi64(cells, 1), bottomBits);
+
+    // Keep the open cells that were not visited yet.
+    __m256i neighbors = _mm256_or_si256(_mm256_or_si256(shiftedRight, shiftedLeft), vertical);
+    __m256i visitedCells = _mm256_loadu_si256((const __m256i*) (visitedRow + w));
+    __m256i layer = _mm256_andnot_si256(visitedCells, _mm256_and_si256(neighbors, _mm256_loadu_si256((const __m256i*) (openRow + w))));
+    _mm256_storeu_si256((__m256i*) (nextRow + w), layer);
+    _mm256_storeu_si256((__m256i*) (visitedRow + w), _mm256_or_si256(visitedCells, layer));
+
+    if (!_mm256_testz_si256(layer, layer)) {
+      for (unsigned int i = 0; i < 4; i++) layerSize += __builtin_popcountll(nextRow[w + i]);
+    }
+    previousTopBit = row[w + 3] >> 63;
+  }
+
+  return layerSize;
+}
+
+// Function that checks whether the CPU supports the vector kernel.
+static bool isBitboardVectorKernelSupported() {
+  return __builtin_cpu_supports("avx2");
+}
+#else
+// Function that expands a BFS frontier by one layer within a row (never chosen without AVX2).
+static unsigned long long expandBitboardRowVectorized(const uint64_t* row, const uint64_t* above, const uint64_t* below, const uint64_t* openRow, uint64_t* visitedRow, uint64_t* nextRow, unsigned int wordsPerRow) {
+  return 0;
+}
+
+// Function that checks whether the CPU supports the vector kernel.
+static bool isBitboardVectorKernelSupported() {
+  return false;
+}
+#endif
+
+// Function that expands a BFS frontier by one layer within the given rows: next = neighbors(frontier) & open & ~visited.
+unsigned long long expandBitboardLayer(const Bitboard& frontier, const Bitboard& open, Bitboard& visited, Bitboard& next, unsigned int firstRow, unsigned int lastRow) {
+  static const bool isVectorized = isBitboardVectorKernelSupported();
+  const unsigned int wordsPerRow = frontier.wordsPerRow;
+  unsigned long long layerSize = 0;
+
+  for (unsigned int y = firstRow; y <= lastRow; y++) {
+    const uint64_t* row = &frontier.words[(size_t) y * wordsPerRow];
+    const uint64_t* above = y > 0 ? row - wordsPerRow : nullptr;
+    const uint64_t* below = y + 1 < frontier.height ? row + wordsPerRow : nullptr;
+    const uint64_t* openRow = &open.words[(size_t) y * wordsPerRow];
+    uint64_t* visitedRow = &visited.words[(size_t) y * wordsPerRow];
+    uint64_t* nextRow = &next.words[(size_t) y * wordsPerRow];
+
+    // Process the whole row four words (256 cells) at a time if the CPU supports AVX2 (the rows are padded to a multiple of four words).
+    if (isVectorized) {
+      layerSize += expandBitboardRowVectorized(row, above, below, openRow, visitedRow, nextRow, wordsPerRow);
+      continue;
+    }
+
+    // Process the words one at a time otherwise.
+    for (unsigned int w = 0; w < wordsPerRow; w++) {
+      uint64_t neighbors = (row[w] << 1) | (row[w] >> 1);
+      if (w > 0) neighbors |= row[w - 1] >> 63;
+      if (w + 1 < wordsPerRow) neighbors |= row[w + 1] << 63;
+      if (above) neighbors |= above[w];
+      if (below) neighbors |= below[w];
+
+      uint64_t layer = neighbors & openRow[w] & ~visitedRow[w];
+      nextRow[w] = layer;
+      visitedRow[w] |= layer;
+      layerSize += __builtin_popcountll(layer);
+    }
+  }
+
+  return layerSize;
+}
+
+// Function that returns the open cells reachable from the start cell (the start cell itself acts as a source even if it is not open).
+Bitboard floodFillBitboard(const Bitboard& open, unsigned int startX, unsigned int startY) {
+  Bitboard visited(open.width, open.height);
+  Bitboard frontier(open.width, open.height);
+  Bitboard next(open.width, open.height);
+  visited.set(startX, startY);
+  frontier.set(startX, startY);
+
+  // Expand the layers until no new cells are reached.
+  while (expandBitboardLayer(frontier, open, visited, next, 0, open.height - 1) > 0) {
+    swap(frontier, next);
+  }
+
+  // Drop the start cell if it is not open.
+  if (!open.test(startX, startY)) {
+    visited.reset(startX, startY);
+  }
+
+  return visited;
+}
@@ -0,0 +1,45 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Structure that represents a grid of bits stored row by row in 64-bit words.
+// Rows are padded to a multiple of four words so that a layer can be processed 256 cells at a time with AVX2 (if the CPU supports it).
+struct Bitboard {
+  // Dimensions of the grid and the number of words in each row.
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int wordsPerRow = 0;
+
+  // The words of all the rows.
+  vector<uint64_t> words;
+
+  // Constructors.
+  Bitboard() = default;
+  Bitboard(unsigned int _width, unsigned int _height);
+
+  // Method that sets the bit of a cell.
+  void set(unsigned int x, unsigned int y);
+
+  // Method that clears the bit of a cell.
+  void reset(unsigned int x, unsigned int y);
+
+  // Method that returns the bit of a cell.
+  bool test(unsigned int x, unsigned int y) const;
+
+  // Method that returns the number of set bits.
+  unsigned long long count() const;
+};
+
+// Function that expands a BFS frontier by one layer within the given rows: next = neighbors(frontier) & open & ~visited.
+// The visited cells are updated with the new layer. Returns the number of cells in the new layer.
+unsigned long long expandBitboardLayer(const Bitboard& frontier, const Bitboard& open, Bitboard& visited, Bitboard& next, unsigned int firstRow, unsigned int lastRow);
+
+// Function that returns the open cells reachable from the start cell (the start cell itself acts as a source even if it is not open).
+Bitboard floodFillBitboard(const Bitboard& open, unsigned int startX, unsigned int startY);
+
+#endif
@@ -1,15 +1,20 @@
 #include "helpers.h"
 
+// The Mersenne Twister random number generator, seeded with the current time until it is seeded explicitly.
+static mt19937 generator((unsigned int) std::chrono::system_clock::now().time_since_epoch().count());
+
+// Function that seeds the random number generator (the same seed gives the same sequence of numbers).
+void seedRandomGenerator(unsigned int seed) {
+  generator.seed(seed);
+}
+
 // Random number generator.
 unsigned int randomGenerator() {
-  // Create a Mersenne Twister random number generator seeded with current time.
-  mt19937 gen(std::chrono::system_clock::now().time_since_epoch().count());
-
   // Create a uniform distribution to generate integers between 0 and RAND_MAX.
   uniform_int_distribution<int> dist(0, RAND_MAX);
 
   // Return a random number.
-  return dist(gen);
+  return dist(generator);
 }
 
 // Function that colors the string.
@@ -12,6 +12,9 @@
 
 using namespace std;
 
+// Function that seeds the random number generator (the same seed gives the same sequence of numbers).
+void seedRandomGenerator(unsigned int seed);
+
 // Random number generator.
 unsigned int randomGenerator();
 
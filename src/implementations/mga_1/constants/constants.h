@@ -2,6 +2,7 @@
 #define CONSTANTS_H
 
 #include <string>
+#include <string_view>
 #include <climits>
 #include "../models/models.h"
 
@@ -15,42 +16,162 @@ const unsigned int MAZE_MAX_HEIGHT = INT_MAX;
 const unsigned int MAZE_MAX_CHECKPOINTS_PERCENTAGE = 100;
 const unsigned int MAZE_WARNING_THRESHOLD_AREA = 10000;
 const unsigned int MAZE_MIN_CHECKPOINTS_NUMBER = 2;
-const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP = 23;
-const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE = 12;
+const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP = 24;
+const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE = 30;
+const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE = 15;
+const unsigned int MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND = 60;
 const unsigned int MAZE_MIN_CHECKPOINTS_SETTING = 0;
 const unsigned int MAZE_MAX_CHECKPOINTS_SETTING = INT_MAX;
+const unsigned int MAZE_MIN_AGENTS = 1;
+const unsigned int MAZE_MAX_AGENTS = 7;
+const unsigned int MAZE_MIN_SEED = 0;
+const unsigned int MAZE_MAX_SEED = INT_MAX;
 
 // Define the symbols used to represent the matrix cell types.
-const string WALL_SYMBOL = "██";
-const string PATH_SYMBOL = "  ";
-const string CHECKPOINT_SYMBOL = "* ";
-const string PASSED_PATH_SYMBOL = "• ";
-const string CURRENT_POSITION_SYMBOL = "• ";
-const string PASSED_CHECKPOINT_SYMBOL = "+ ";
-const string START_SYMBOL = "ST";
-const string END_SYMBOL = "EN";
+constexpr string_view WALL_SYMBOL = "██";
+constexpr string_view PATH_SYMBOL = "  ";
+constexpr string_view CHECKPOINT_SYMBOL = "* ";
+constexpr string_view PASSED_PATH_SYMBOL = "• ";
+constexpr string_view CURRENT_POSITION_SYMBOL = "• ";
+constexpr string_view PASSED_CHECKPOINT_SYMBOL = "+ ";
+constexpr string_view START_SYMBOL = "ST";
+constexpr string_view END_SYMBOL = "EN";
+constexpr string_view AGENT_PATH_SYMBOL = "• ";
+constexpr string_view UNKNOWN_SYMBOL = "E ";
+
+// Define the glyph of a matrix cell type: the escape sequence that sets its colors (foreground, background and style, as colorString
+// joins them) and its symbol.
+struct CellGlyph {
+  string_view escapeSequence;
+  string_view symbol;
+};
+
+// Define the glyphs of the matrix cell types, indexed by their IDs (followed by the path of each agent, in its own color).
+constexpr CellGlyph CELL_GLYPHS[] = {
+    {"\033[32;40m", PATH_SYMBOL},
+    {"\033[37;47m", WALL_SYMBOL},
+    {"\033[33;40;1m", CHECKPOINT_SYMBOL},
+    {"\033[32;40m", PASSED_PATH_SYMBOL},
+    {"\033[37;42;1m", PASSED_CHECKPOINT_SYMBOL},
+    {"\033[32;43m", CURRENT_POSITION_SYMBOL},
+    {"\033[37;42;1m", START_SYMBOL},
+    {"\033[37;41;1m", END_SYMBOL},
+    {"\033[32;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[36;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[35;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[33;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[34;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[31;40;1m", AGENT_PATH_SYMBOL},
+    {"\033[37;40;1m", AGENT_PATH_SYMBOL}
+};
+constexpr unsigned int CELL_GLYPHS_COUNT = sizeof(CELL_GLYPHS) / sizeof(CellGlyph);
+static_assert(CELL_GLYPHS_COUNT == AGENT_PATH_ID + MAZE_MAX_AGENTS, "Every agent needs a glyph.");
+
+// Define the width of a cell printed as its ID (every ID is padded to the width of the largest one, so the rows stay aligned).
+constexpr size_t CELL_ID_WIDTH = 2;
+static_assert(CELL_GLYPHS_COUNT - 1 < 100, "The largest cell ID must fit the width of a cell printed as its ID.");
+
+// Define the glyph of an unknown cell type (without colors) and the escape sequence that resets the colors.
+constexpr CellGlyph UNKNOWN_CELL_GLYPH = {"", UNKNOWN_SYMBOL};
+constexpr string_view RESET_ESCAPE_SEQUENCE = "\033[0m";
+
+// Define the neighbor offsets (up, down, left, right) in the X and Y axis.
+const int NEIGHBOR_OFFSETS[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
 
 // Define other constants.
 const unsigned int ESTIMATED_TIME_UPDATE_INTERVAL_STEPS = 10;
 const unsigned int MAZE_GENERATION_VISUALIZATION_MIN_DURATION_MS = 5000;
 const bool PRINT_MAZE_AS_IDS = false;
+const unsigned int MULTI_SOURCE_BFS_MIN_CHECKPOINTS = 16;
+const double MULTI_SOURCE_BFS_MIN_JUNCTIONS_SHARE = 0.3;
+const double MULTI_SOURCE_BFS_MIN_JUNCTIONS_SHARE_WITHOUT_PREDECESSORS = 0.2;
+const unsigned long long JUNCTION_GRAPH_MAX_STORED_PREDECESSORS = 1 << 24;
+const unsigned int HIERARCHICAL_CLUSTER_SIZE = 16;
+const unsigned long long DISTANCE_MATRIX_MAX_STORED_BYTES = 1ULL << 28;
+const size_t DISTANCE_MATRIX_CACHED_ROWS = 256;
+const unsigned long long CHECKPOINT_DISTANCE_FIELDS_MAX_BYTES = 1ULL << 28;
+const unsigned long long ANNEALING_SEED = 1;
+const unsigned long long ANNEALING_MOVES_PER_ISLAND = 2000000;
+const long long ANNEALING_TIME_LIMIT_MS = 10000;
+const long long ANYTIME_TIME_LIMIT_MS = 200;
+const unsigned int ANYTIME_MAX_BOUNDED_CHECKPOINTS = 2000;
+const long long PORTFOLIO_TIME_LIMIT_MS = 10000;
+const long long PORTFOLIO_HELD_KARP_DELAY_MS = 500;
+const PathSearchAlgorithm DEFAULT_PATH_SEARCH_ALGORITHM = PathSearchAlgorithm::BIDIRECTIONAL_BREADTH_FIRST;
 const string GENERATION_BG_AUDIO_FILE_PATH = "assets/generation.wav";
 const string VISUALIZATION_BG_AUDIO_FILE_PATH = "assets/visualization.wav";
+const string HELD_KARP_TABLE_FILE_PREFIX = "_held_karp_";
+const unsigned long long HELD_KARP_MAX_IN_MEMORY_TABLE_BYTES = 2ULL << 30;
+const bool SOLUTION_CACHE_ENABLED = true;
+const string SOLUTION_CACHE_FILE_PREFIX = "_solution_cache_";
+const size_t SOLUTION_CACHE_MAX_FILES = 16;
+const unsigned long long SOLUTION_CACHE_MAX_BYTES = 512ULL << 20;
 
 // Define the supported solving algorithms.
 const vector<pair<SupportedSolvingAlgorithms, string>> SUPPORTED_SOLVING_ALGORITHMS = {
   { SupportedSolvingAlgorithms::HELD_KARP_PARALLEL, colorString("Held-Karp - Multithreading", "yellow", "default", "underline") + " (the fastest; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) + " checkpoints)" },
   { SupportedSolvingAlgorithms::HELD_KARP, colorString("Held-Karp - Single Thread", "yellow", "default", "underline") +  " (fast; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE, colorString("Held-Karp - Out of Core", "yellow", "default", "underline") + " (slow; non-heuristic; keeps the table on the disk and resumes a stopped run of the same seed; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::BRANCH_AND_BOUND, colorString("Branch and Bound - Multithreading", "yellow", "default", "underline") + " (fast; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND) + " checkpoints)" },
   { SupportedSolvingAlgorithms::BRUTE_FORCE, colorString("Brute Force", "yellow", "default", "underline") + " (slow; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::NEAREST_NEIGHBOR, colorString("Nearest Neighbor + 2-opt/Or-opt", "yellow", "default", "underline") + " (fast; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::GREEDY_EDGE, colorString("Greedy Edge + 2-opt/Or-opt", "yellow", "default", "underline") + " (fast; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::SIMULATED_ANNEALING, colorString("Simulated Annealing - Multithreading", "yellow", "default", "underline") + " (slow; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::ANYTIME, colorString("Anytime - Multithreading", "yellow", "default", "underline") + " (fast; heuristic with an optimality gap; stops after " + to_string(ANYTIME_TIME_LIMIT_MS) + " ms, or right after the adjacency matrix if it takes longer; up to a few thousand checkpoints)" },
+  { SupportedSolvingAlgorithms::PORTFOLIO, colorString("Portfolio - Multithreading", "yellow", "default", "underline") + " (races the solvers that fit and takes the first proven result; stops after " + to_string(PORTFOLIO_TIME_LIMIT_MS / 1000) + " s; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::STEINER_TREE, colorString("Steiner Tree", "yellow", "default", "underline") + " (the fastest; non-heuristic; perfect mazes only; any number of checkpoints)" },
   { SupportedSolvingAlgorithms::NONE, colorString("None", "yellow", "default", "underline") + " (just distribute checkpoints)" },
 };
 const vector<pair<SupportedSolvingAlgorithms, string>> SUPPORTED_SOLVING_ALGORITHMS_NO_COLOR_STRINGS = {
   { SupportedSolvingAlgorithms::HELD_KARP_PARALLEL, "Held-Karp - Multithreading (the fastest; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) + " checkpoints)" },
   { SupportedSolvingAlgorithms::HELD_KARP, "Held-Karp - Single Thread (fast; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE, "Held-Karp - Out of Core (slow; non-heuristic; keeps the table on the disk and resumes a stopped run of the same seed; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::BRANCH_AND_BOUND, "Branch and Bound - Multithreading (fast; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND) + " checkpoints)" },
   { SupportedSolvingAlgorithms::BRUTE_FORCE, "Brute Force (slow; non-heuristic; up to " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE) + " checkpoints)" },
+  { SupportedSolvingAlgorithms::NEAREST_NEIGHBOR, "Nearest Neighbor + 2-opt/Or-opt (fast; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::GREEDY_EDGE, "Greedy Edge + 2-opt/Or-opt (fast; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::SIMULATED_ANNEALING, "Simulated Annealing - Multithreading (slow; heuristic; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::ANYTIME, "Anytime - Multithreading (fast; heuristic with an optimality gap; stops after " + to_string(ANYTIME_TIME_LIMIT_MS) + " ms, or right after the adjacency matrix if it takes longer; up to a few thousand checkpoints)" },
+  { SupportedSolvingAlgorithms::PORTFOLIO, "Portfolio - Multithreading (races the solvers that fit and takes the first proven result; stops after " + to_string(PORTFOLIO_TIME_LIMIT_MS / 1000) + " s; any number of checkpoints)" },
+  { SupportedSolvingAlgorithms::STEINER_TREE, "Steiner Tree (the fastest; non-heuristic; perfect mazes only; any number of checkpoints)" },
   { SupportedSolvingAlgorithms::NONE, "None (just distribute checkpoints)" },
 };
 
+// Define the supported route types.
+const vector<pair<RouteType, string>> SUPPORTED_ROUTE_TYPES = {
+  { RouteType::OPEN_FREE_START, colorString("Open Path - Free Start", "yellow", "default", "underline") + " (the shortest walk through all the checkpoints)" },
+  { RouteType::OPEN_FIXED_START, colorString("Open Path - Fixed Start", "yellow", "default", "underline") + " (the shortest walk from the first checkpoint through all the others)" },
+  { RouteType::CLOSED_TOUR, colorString("Closed Tour", "yellow", "default", "underline") + " (the shortest round trip through all the checkpoints, drawn up to the last one; a single agent only)" },
+};
+
+// Define the supported route types without colors.
+const vector<pair<RouteType, string>> SUPPORTED_ROUTE_TYPES_NO_COLOR_STRINGS = {
+  { RouteType::OPEN_FREE_START, "Open Path - Free Start (the shortest walk through all the checkpoints)" },
+  { RouteType::OPEN_FIXED_START, "Open Path - Fixed Start (the shortest walk from the first checkpoint through all the others)" },
+  { RouteType::CLOSED_TOUR, "Closed Tour (the shortest round trip through all the checkpoints, drawn up to the last one; a single agent only)" },
+};
+
+// Define the supported objectives of the agents.
+const vector<pair<AgentObjective, string>> SUPPORTED_AGENT_OBJECTIVES = {
+  { AgentObjective::MIN_LONGEST_ROUTE, colorString("Shortest Longest Route", "yellow", "default", "underline") + " (all the checkpoints are reached as early as possible)" },
+  { AgentObjective::MIN_TOTAL_LENGTH, colorString("Shortest Total Length", "yellow", "default", "underline") + " (the agents walk as little as possible altogether)" },
+};
+
+// Define the supported objectives of the agents without colors.
+const vector<pair<AgentObjective, string>> SUPPORTED_AGENT_OBJECTIVES_NO_COLOR_STRINGS = {
+  { AgentObjective::MIN_LONGEST_ROUTE, "Shortest Longest Route (all the checkpoints are reached as early as possible)" },
+  { AgentObjective::MIN_TOTAL_LENGTH, "Shortest Total Length (the agents walk as little as possible altogether)" },
+};
+
+// Define the names of the point-to-point search algorithms.
+const vector<pair<PathSearchAlgorithm, string>> PATH_SEARCH_ALGORITHM_NAMES = {
+  { PathSearchAlgorithm::BREADTH_FIRST, "breadth-first search" },
+  { PathSearchAlgorithm::BIDIRECTIONAL_BREADTH_FIRST, "bidirectional breadth-first search" },
+  { PathSearchAlgorithm::A_STAR, "A* with the Manhattan distance" },
+  { PathSearchAlgorithm::JUNCTION_GRAPH, "Dijkstra on the junction graph" },
+  { PathSearchAlgorithm::HIERARCHICAL, "the hierarchical pathfinder" },
+};
+
 // Define the supported checkpoint setting types.
 const vector<pair<CheckpointSettingType, string>> SUPPORTED_CHECKPOINT_SETTING_TYPES = {
   { CheckpointSettingType::NUMBER, colorString("Number", "yellow", "default", "underline") },
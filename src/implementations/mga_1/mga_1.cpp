@@ -119,22 +119,52 @@ void mga1(const string& executablePath) {
     solvingAlgorithm = promptForChoice<SupportedSolvingAlgorithms>("Choose the maze solving algorithm:", SUPPORTED_SOLVING_ALGORITHMS);
   }
 
+  // If the maze is solved, prompt the user to choose where the route starts.
+  RouteType routeType = RouteType::OPEN_FREE_START;
+  if (solvingAlgorithm != SupportedSolvingAlgorithms::NONE) {
+    routeType = promptForChoice<RouteType>("Choose the route type:", SUPPORTED_ROUTE_TYPES);
+  }
+
+  // If the maze is solved with open paths, prompt the user to enter the number of agents and, if there are several, what they minimize.
+  unsigned int agentsCount = MAZE_MIN_AGENTS;
+  AgentObjective agentObjective = AgentObjective::MIN_LONGEST_ROUTE;
+  if (solvingAlgorithm != SupportedSolvingAlgorithms::NONE && routeType != RouteType::CLOSED_TOUR) {
+    agentsCount = promptForParameter("number of agents", MAZE_MIN_AGENTS, MAZE_MAX_AGENTS);
+    if (agentsCount > 1) {
+      agentObjective = promptForChoice<AgentObjective>("Choose what the agents minimize:", SUPPORTED_AGENT_OBJECTIVES);
+    }
+  }
+
   // If the checkpoints value exceeds the maximum allowed for the chosen algorithm, print a warning message and decrease the value to the maximum allowed.
   if ((solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP || solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP_PARALLEL) && checkpointSetting == CheckpointSettingType::NUMBER && checkpointsValue > MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) {
     cout << colorString("The number of checkpoints was decreased from " + to_string(checkpointsValue) + " to the maximum allowed " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) + " for this algorithm.", "white", "red", "bold") << "\n\n";
     checkpointsValue = MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP;
   }
+  if (solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE && checkpointSetting == CheckpointSettingType::NUMBER && checkpointsValue > MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE) {
+    cout << colorString("The number of checkpoints was decreased from " + to_string(checkpointsValue) + " to the maximum allowed " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE) + " for this algorithm.", "white", "red", "bold") << "\n\n";
+    checkpointsValue = MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE;
+  }
   if (solvingAlgorithm == SupportedSolvingAlgorithms::BRUTE_FORCE && checkpointSetting == CheckpointSettingType::NUMBER && checkpointsValue > MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE) {
     cout << colorString("The number of checkpoints was decreased from " + to_string(checkpointsValue) + " to the maximum allowed " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE) + " for this algorithm.", "white", "red", "bold") << "\n\n";
     checkpointsValue = MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE;
   }
+  if (solvingAlgorithm == SupportedSolvingAlgorithms::BRANCH_AND_BOUND && checkpointSetting == CheckpointSettingType::NUMBER && checkpointsValue > MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND) {
+    cout << colorString("The number of checkpoints was decreased from " + to_string(checkpointsValue) + " to the maximum allowed " + to_string(MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND) + " for this algorithm.", "white", "red", "bold") << "\n\n";
+    checkpointsValue = MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND;
+  }
+
+  // Prompt the user to enter the seed (the same seed and parameters generate the same maze again).
+  unsigned int seed = promptForParameter("maze seed (0 for a random one)", MAZE_MIN_SEED, MAZE_MAX_SEED);
 
   // Create the maze.
-  Maze maze(mazeWidth, mazeHeight, checkpointsValue, checkpointSetting, solvingAlgorithm, executablePath);
+  Maze maze(mazeWidth, mazeHeight, checkpointsValue, checkpointSetting, solvingAlgorithm, routeType, agentsCount, agentObjective, seed, executablePath);
 
   // Visualize the maze generation.
   maze.visualizeMazeGeneration(MAZE_GENERATION_VISUALIZATION_MIN_DURATION_MS);
 
+  // Let the user edit the walls of the maze (the solution is repaired after each edit).
+  maze.editWalls();
+
   // Wait for the user to press the "Enter" key.
   waitForEnter("\n" + colorString("Press the \"Enter\" key to continue to the main menu...", "green", "black", "bold"));
 }
@@ -12,7 +12,8 @@ enum MazeCellTypeIds {
   PASSED_CHECKPOINT_ID = 4,
   CURRENT_POSITION_ID = 5,
   START_ID = 6,
-  END_ID = 7
+  END_ID = 7,
+  AGENT_PATH_ID = 8 // The path of the agent i is marked as AGENT_PATH_ID + i.
 };
 
 // Define supported algorithms.
@@ -20,7 +21,37 @@ enum SupportedSolvingAlgorithms {
   HELD_KARP_PARALLEL = 1,
   HELD_KARP = 0,
   BRUTE_FORCE = 2,
-  NONE = 3
+  NONE = 3,
+  HELD_KARP_OUT_OF_CORE = 4,
+  NEAREST_NEIGHBOR = 5,
+  GREEDY_EDGE = 6,
+  SIMULATED_ANNEALING = 7,
+  BRANCH_AND_BOUND = 8,
+  ANYTIME = 9,
+  PORTFOLIO = 10,
+  STEINER_TREE = 11
+};
+
+// Define the supported route types (the route is an open path through all the checkpoints, or a closed tour back to its first checkpoint).
+enum RouteType {
+  OPEN_FREE_START = 0,
+  OPEN_FIXED_START = 1,
+  CLOSED_TOUR = 2
+};
+
+// Define what the agents minimize when the checkpoints are split among several of them.
+enum AgentObjective {
+  MIN_LONGEST_ROUTE = 0,
+  MIN_TOTAL_LENGTH = 1
+};
+
+// Define supported point-to-point path search algorithms.
+enum PathSearchAlgorithm {
+  BREADTH_FIRST = 0,
+  BIDIRECTIONAL_BREADTH_FIRST = 1,
+  A_STAR = 2,
+  JUNCTION_GRAPH = 3,
+  HIERARCHICAL = 4
 };
 
 // Define checkpoint settings type.
@@ -0,0 +1,272 @@
+#include "agent_partition.h"
+
+// Constructor.
+AgentPartition::AgentPartition(const DistanceMatrix& _matrix, unsigned int _agentsCount, bool _isStartFixed, bool _isMinMax)
+    : matrix(&_matrix), agentsCount(max(1u, _agentsCount)), isStartFixed(_isStartFixed), isMinMax(_isMinMax) {}
+
+// Method that clusters the checkpoints, routes every cluster with the solver and rebalances the routes.
+void AgentPartition::solve(ThreadPool* pool, const function<vector<unsigned int>(const vector<unsigned int>&, const DistanceMatrix&)>& solveRoute) {
+  cluster();
+
+  // Route all the clusters, then solve again only the routes that the rebalancing changed.
+  vector<unsigned int> agents(routes.size());
+  iota(agents.begin(), agents.end(), 0);
+  routeAgents(pool, agents, solveRoute);
+  routeAgents(pool, rebalance(), solveRoute);
+}
+
+// Method that clusters the checkpoints with k-medoids (each cluster becomes the route of an agent, not yet ordered).
+void AgentPartition::cluster() {
+  // Split all the checkpoints but the shared start (if it is fixed), with at most one agent per checkpoint.
+  vector<unsigned int> checkpointIds;
+  for (unsigned int i = isStartFixed ? 1 : 0; i < matrix->size; i++) {
+    checkpointIds.push_back(i);
+  }
+  const unsigned int clustersCount = max(1u, min(agentsCount, (unsigned int) checkpointIds.size()));
+  medoids.clear();
+  routes.assign(clustersCount, isStartFixed ? vector<unsigned int>{0} : vector<unsigned int>{});
+  lengths.assign(clustersCount, ULLONG_MAX);
+  iterationsCount = 0;
+  if (checkpointIds.empty()) return;
+
+  // Seed the medoids farthest first, starting from the checkpoint farthest from checkpoint 0.
+  vector<vector<unsigned int>> medoidRows;
+  vector<unsigned int> nearestDistances(matrix->size, UINT_MAX);
+  const vector<unsigned int>& firstRow = matrix->getRow(0);
+  unsigned int nextMedoid = checkpointIds[0];
+  for (unsigned int checkpointId : checkpointIds) {
+    if (firstRow[checkpointId] > firstRow[nextMedoid]) nextMedoid = checkpointId;
+  }
+  while (true) {
+    medoids.push_back(nextMedoid);
+    medoidRows.push_back(matrix->getRow(nextMedoid));
+    for (unsigned int checkpointId : checkpointIds) {
+      nearestDistances[checkpointId] = min(nearestDistances[checkpointId], medoidRows.back()[checkpointId]);
+    }
+    if (medoids.size() == clustersCount) break;
+
+    // The next medoid is the checkpoint farthest from all the medoids so far.
+    for (unsigned int checkpointId : checkpointIds) {
+      if (nearestDistances[checkpointId] > nearestDistances[nextMedoid]) nextMedoid = checkpointId;
+    }
+  }
+
+  vector<vector<unsigned int>> members(clustersCount);
+  while (true) {
+    iterationsCount++;
+
+    // Assign every checkpoint to its nearest medoid (every medoid is the nearest to itself, so no cluster is empty).
+    for (auto& clusterMembers : members) {
+      clusterMembers.clear();
+    }
+    for (unsigned int checkpointId : checkpointIds) {
+      unsigned int nearestCluster = 0;
+      for (unsigned int c = 1; c < clustersCount; c++) {
+        if (medoidRows[c][checkpointId] < medoidRows[nearestCluster][checkpointId]) nearestCluster = c;
+      }
+      members[nearestCluster].push_back(checkpointId);
+    }
+    if (iterationsCount == MAX_ITERATIONS) break;
+
+    // Move every medoid to the candidate with the smallest total distance to the members of its cluster.
+    bool isMedoidMoved = false;
+    for (unsigned int c = 0; c < clustersCount; c++) {
+      const vector<unsigned int>& medoidRow = medoidRows[c];
+      vector<unsigned int> candidates = members[c];
+      const size_t candidatesCount = min((size_t) MEDOID_CANDIDATES, candidates.size());
+      partial_sort(candidates.begin(), candidates.begin() + candidatesCount, candidates.end(), [&](unsigned int first, unsigned int second) {
+        return medoidRow[first] < medoidRow[second];
+      });
+
+      unsigned long long bestCost = 0;
+      for (unsigned int member : members[c]) {
+        bestCost += medoidRow[member];
+      }
+      unsigned int bestMedoid = medoids[c];
+      for (size_t i = 0; i < candidatesCount; i++) {
+        if (candidates[i] == medoids[c]) continue;
+        const vector<unsigned int>& candidateRow = matrix->getRow(candidates[i]);
+        unsigned long long cost = 0;
+        for (unsigned int member : members[c]) {
+          cost += candidateRow[member];
+        }
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestMedoid = candidates[i];
+        }
+      }
+
+      if (bestMedoid != medoids[c]) {
+        medoids[c] = bestMedoid;
+        medoidRows[c] = matrix->getRow(bestMedoid);
+        isMedoidMoved = true;
+      }
+    }
+    if (!isMedoidMoved) break;
+  }
+
+  for (unsigned int c = 0; c < clustersCount; c++) {
+    routes[c].insert(routes[c].end(), members[c].begin(), members[c].end());
+  }
+}
+
+// Method that routes the given agents with the solver in parallel, keeping each new route only if it is not longer than the old one.
+void AgentPartition::routeAgents(ThreadPool* pool, const vector<unsigned int>& agents, const function<vector<unsigned int>(const vector<unsigned int>&, const DistanceMatrix&)>& solveRoute) {
+  auto routeAgentsRange = [&](size_t firstAgent, size_t lastAgent) {
+    for (size_t i = firstAgent; i < lastAgent; i++) {
+      const unsigned int agent = agents[i];
+      const DistanceMatrix routeMatrix = getRouteMatrix(routes[agent]);
+      vector<unsigned int> order = solveRoute(routes[agent], routeMatrix);
+
+      // Keep the checkpoints in their current order if the solver gave no valid order.
+      if (order.size() != routes[agent].size()) {
+        order.resize(routes[agent].size());
+        iota(order.begin(), order.end(), 0);
+      }
+
+      unsigned long long length = 0;
+      for (size_t j = 0; j + 1 < order.size(); j++) {
+        length += routeMatrix.get(order[j], order[j + 1]);
+      }
+      if (length <= lengths[agent]) {
+        vector<unsigned int> route;
+        for (unsigned int index : order) {
+          route.push_back(routes[agent][index]);
+        }
+        routes[agent] = route;
+        lengths[agent] = length;
+      }
+    }
+  };
+
+  if (pool != nullptr && pool->getNumThreads() > 1) {
+    pool->parallelFor(0, agents.size(), 1, routeAgentsRange);
+  } else {
+    routeAgentsRange(0, agents.size());
+  }
+}
+
+// Method that moves single checkpoints between the routes while the objective improves. Returns the agents whose routes changed.
+vector<unsigned int> AgentPartition::rebalance() {
+  // Every pass reads distances all over the matrix, so the matrices computed on demand are not rebalanced.
+  if (routes.size() < 2 || matrix->isOnDemand() || matrix->size > MAX_REBALANCED_CHECKPOINTS) return {};
+
+  // The shared start stays at the front of every route.
+  const size_t firstMovable = isStartFixed ? 1 : 0;
+  vector<bool> isChanged(routes.size(), false);
+  bool isImproved = true;
+  while (isImproved) {
+    isImproved = false;
+    for (unsigned int from = 0; from < routes.size(); from++) {
+      size_t position = firstMovable;
+
+      // Every agent keeps at least one checkpoint of its own.
+      while (position < routes[from].size() && routes[from].size() > firstMovable + 1) {
+        const vector<unsigned int>& fromRoute = routes[from];
+        const unsigned int checkpoint = fromRoute[position];
+
+        // Find the length of the route without the checkpoint (its neighbors are joined directly).
+        unsigned long long removedLength = lengths[from];
+        if (position > 0 && position + 1 < fromRoute.size()) removedLength += matrix->get(fromRoute[position - 1], fromRoute[position + 1]);
+        if (position > 0) removedLength -= matrix->get(fromRoute[position - 1], checkpoint);
+        if (position + 1 < fromRoute.size()) removedLength -= matrix->get(checkpoint, fromRoute[position + 1]);
+
+        // Find the cheapest place for the checkpoint in every other route, and take the move that improves the objective the most.
+        pair<unsigned long long, unsigned long long> bestObjective = getObjective(lengths);
+        int bestTo = -1;
+        size_t bestPlace = 0;
+        unsigned long long bestAddedLength = 0;
+        for (unsigned int to = 0; to < routes.size(); to++) {
+          if (to == from) continue;
+          const vector<unsigned int>& toRoute = routes[to];
+          unsigned long long addedLength = ULLONG_MAX;
+          size_t place = firstMovable;
+          for (size_t p = firstMovable; p <= toRoute.size(); p++) {
+            unsigned long long added = 0;
+            if (p > 0) added += matrix->get(toRoute[p - 1], checkpoint);
+            if (p < toRoute.size()) added += matrix->get(checkpoint, toRoute[p]);
+            if (p > 0 && p < toRoute.size()) added -= matrix->get(toRoute[p - 1], toRoute[p]);
+            if (added < addedLength) {
+              addedLength = added;
+              place = p;
+            }
+          }
+
+          vector<unsigned long long> movedLengths = lengths;
+          movedLengths[from] = removedLength;
+          movedLengths[to] += addedLength;
+          const pair<unsigned long long, unsigned long long> objective = getObjective(movedLengths);
+          if (objective < bestObjective) {
+            bestObjective = objective;
+            bestTo = (int) to;
+            bestPlace = place;
+            bestAddedLength = addedLength;
+          }
+        }
+
+        // Move the checkpoint (the next one slides into its position).
+        if (bestTo == -1) {
+          position++;
+          continue;
+        }
+        routes[from].erase(routes[from].begin() + (long) position);
+        routes[bestTo].insert(routes[bestTo].begin() + (long) bestPlace, checkpoint);
+        lengths[from] = removedLength;
+        lengths[bestTo] += bestAddedLength;
+        isChanged[from] = true;
+        isChanged[bestTo] = true;
+        movesCount++;
+        isImproved = true;
+      }
+    }
+  }
+
+  vector<unsigned int> changedAgents;
+  for (unsigned int agent = 0; agent < routes.size(); agent++) {
+    if (isChanged[agent]) changedAgents.push_back(agent);
+  }
+  return changedAgents;
+}
+
+// Method that returns the matrix of the distances between the checkpoints of a route.
+DistanceMatrix AgentPartition::getRouteMatrix(const vector<unsigned int>& route) {
+  // The rows of a matrix computed on demand are taken from the rows of the whole matrix.
+  if (matrix->isOnDemand()) {
+    return {(unsigned int) route.size(), [this, route](unsigned int row, vector<unsigned int>& distances) {
+      const vector<unsigned int>& fullRow = matrix->getRow(route[row]);
+      for (size_t j = 0; j < route.size(); j++) {
+        distances[j] = fullRow[route[j]];
+      }
+    }, ROUTE_MATRIX_CACHED_ROWS};
+  }
+
+  // Otherwise copy the distances, stored in the same width as in the whole matrix.
+  DistanceMatrix routeMatrix((unsigned int) route.size(), matrix->isCompact ? 0 : ULLONG_MAX);
+  for (unsigned int i = 0; i < route.size(); i++) {
+    for (unsigned int j = i + 1; j < route.size(); j++) {
+      routeMatrix.set(i, j, matrix->get(route[i], route[j]));
+    }
+  }
+  return routeMatrix;
+}
+
+// Method that returns the objective of the route lengths (the longest route and the total length, in the order of their priority).
+pair<unsigned long long, unsigned long long> AgentPartition::getObjective(const vector<unsigned long long>& routeLengths) const {
+  unsigned long long longestLength = 0;
+  unsigned long long totalLength = 0;
+  for (unsigned long long length : routeLengths) {
+    longestLength = max(longestLength, length);
+    totalLength += length;
+  }
+  return isMinMax ? make_pair(longestLength, totalLength) : make_pair(totalLength, longestLength);
+}
+
+// Method that returns the length of the longest route.
+unsigned long long AgentPartition::getLongestLength() const {
+  return lengths.empty() ? 0 : *max_element(lengths.begin(), lengths.end());
+}
+
+// Method that returns the total length of the routes.
+unsigned long long AgentPartition::getTotalLength() const {
+  return accumulate(lengths.begin(), lengths.end(), 0ULL);
+}
@@ -0,0 +1,79 @@
+#ifndef AGENT_PARTITION_H
+#define AGENT_PARTITION_H
+
+#include <vector>
+#include <climits>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include "../distance_matrix/distance_matrix.h"
+#include "../thread_pool/thread_pool.h"
+
+using namespace std;
+
+// Structure that splits the checkpoints among several agents and routes each agent through its share with a single-tour solver.
+// The route of every agent is an open path, and if the start is fixed, all the agents start from checkpoint 0.
+// The checkpoints are first clustered with k-medoids on the distance matrix. The medoids are seeded farthest first. Then every checkpoint
+// joins its nearest medoid, and every cluster moves its medoid to the member with the smallest total distance to the other members
+// (trying the members nearest to the old medoid), until the medoids settle. The clusters are routed by the solver in parallel.
+// Then single checkpoints are moved to the cheapest place in another route while that improves the objective (the longest route first
+// and the total length second, or the other way round), and the routes that changed are solved again.
+// Only the rows of the medoids and of their candidates are read while clustering, so the matrix may compute its rows on demand.
+struct AgentPartition {
+  // The largest number of the k-medoids iterations and the number of the members nearest to a medoid that are tried as the new one.
+  static constexpr unsigned int MAX_ITERATIONS = 50;
+  static constexpr unsigned int MEDOID_CANDIDATES = 32;
+
+  // The largest number of checkpoints that are moved between the routes (every pass tries every checkpoint in every other route),
+  // and the number of rows cached by the matrix of a route whose rows are computed on demand.
+  static constexpr unsigned int MAX_REBALANCED_CHECKPOINTS = 2000;
+  static constexpr size_t ROUTE_MATRIX_CACHED_ROWS = 256;
+
+  // The distances between all the checkpoints.
+  const DistanceMatrix* matrix = nullptr;
+
+  // The number of agents, whether they all start from checkpoint 0, and whether the longest route is minimized before the total length.
+  unsigned int agentsCount = 1;
+  bool isStartFixed = false;
+  bool isMinMax = true;
+
+  // The medoid of each agent, the checkpoint IDs along the route of each agent and the length of each route.
+  vector<unsigned int> medoids;
+  vector<vector<unsigned int>> routes;
+  vector<unsigned long long> lengths;
+
+  // The number of the k-medoids iterations and of the checkpoints moved between the routes.
+  unsigned int iterationsCount = 0;
+  unsigned long long movesCount = 0;
+
+  // Constructor.
+  AgentPartition(const DistanceMatrix& _matrix, unsigned int _agentsCount, bool _isStartFixed, bool _isMinMax);
+
+  // Method that clusters the checkpoints, routes every cluster with the solver and rebalances the routes.
+  // The solver gets the checkpoint IDs of a route and the matrix of the distances between them, and returns the order of their indices.
+  void solve(ThreadPool* pool, const function<vector<unsigned int>(const vector<unsigned int>&, const DistanceMatrix&)>& solveRoute);
+
+  // Method that clusters the checkpoints with k-medoids (each cluster becomes the route of an agent, not yet ordered).
+  void cluster();
+
+  // Method that routes the given agents with the solver in parallel, keeping each new route only if it is not longer than the old one.
+  void routeAgents(ThreadPool* pool, const vector<unsigned int>& agents, const function<vector<unsigned int>(const vector<unsigned int>&, const DistanceMatrix&)>& solveRoute);
+
+  // Method that moves single checkpoints between the routes while the objective improves. Returns the agents whose routes changed.
+  vector<unsigned int> rebalance();
+
+  // Method that returns the matrix of the distances between the checkpoints of a route.
+  DistanceMatrix getRouteMatrix(const vector<unsigned int>& route);
+
+  // Method that returns the objective of the route lengths (the longest route and the total length, in the order of their priority).
+  pair<unsigned long long, unsigned long long> getObjective(const vector<unsigned long long>& routeLengths) const;
+
+  // Method that returns the length of the longest route.
+  unsigned long long getLongestLength() const;
+
+  // Method that returns the total length of the routes.
+  unsigned long long getTotalLength() const;
+};
+
+#endif
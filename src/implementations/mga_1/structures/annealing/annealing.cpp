@@ -0,0 +1,166 @@
+#include "annealing.h"
+
+// Constructor.
+Annealing::Island::Island(const Tour& _tour, unsigned long long seed) : tour(_tour), generator(seed) {
+  length = tour.getLength();
+  bestOrder = tour.getOrder();
+  bestLength = length;
+}
+
+// Constructor.
+Annealing::Annealing(const Tour& startTour, unsigned int islandsCount, unsigned long long seed) {
+  averageEdge = max(1.0, (double) startTour.getLength() / max(1u, startTour.size));
+  for (unsigned int i = 0; i < max(1u, islandsCount); i++) {
+    islands.emplace_back(startTour, seed + i * 0x9E3779B97F4A7C15ULL);
+  }
+}
+
+// Method that anneals the islands for the given number of moves per island or until the time limit (0 for none) runs out.
+unsigned long long Annealing::run(ThreadPool* pool, unsigned long long movesPerIsland, long long timeLimitMs, SolverContext* context) {
+  const auto startTime = chrono::high_resolution_clock::now();
+  const double startTemperature = averageEdge * START_TEMPERATURE_RATIO;
+  const double endTemperature = averageEdge * END_TEMPERATURE_RATIO;
+  const unsigned long long cycleMoves = max(1ULL, min(movesPerIsland, COOLING_CYCLE_MOVES));
+
+  unsigned long long movesCount = 0;
+  long long lastEpochMs = 0;
+  for (unsigned long long epochStart = 0; epochStart < movesPerIsland; epochStart += EPOCH_MOVES) {
+    const unsigned long long epochMoves = min(EPOCH_MOVES, movesPerIsland - epochStart);
+    const auto epochStartTime = chrono::high_resolution_clock::now();
+    if (context != nullptr && context->shouldStop()) break;
+
+    // Skip the epoch if the last one took longer than the time left, so that the deadline is kept rather than overrun by an epoch.
+    if (context != nullptr && context->hasDeadline && lastEpochMs > context->getRemainingMs()) break;
+    if (timeLimitMs > 0 && chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count() >= timeLimitMs) break;
+
+    // Cool down with the share of the moves done in the current cooling cycle.
+    const unsigned long long cycleStart = epochStart % cycleMoves;
+    const double progress = (double) cycleStart / cycleMoves;
+    const double nextProgress = min(1.0, (double) (cycleStart + epochMoves) / cycleMoves);
+    const double epochStartTemperature = startTemperature * pow(endTemperature / startTemperature, progress);
+    const double epochEndTemperature = startTemperature * pow(endTemperature / startTemperature, nextProgress);
+
+    // Run the epoch on all the islands, and exchange the best tours once all of them are done.
+    auto runIslands = [&](size_t firstIsland, size_t lastIsland) {
+      for (size_t i = firstIsland; i < lastIsland; i++) {
+        runEpoch(islands[i], epochMoves, epochStartTemperature, epochEndTemperature);
+      }
+    };
+    if (pool != nullptr && pool->getNumThreads() > 1) {
+      pool->parallelFor(0, islands.size(), 1, runIslands);
+    } else {
+      runIslands(0, islands.size());
+    }
+    movesCount += epochMoves * islands.size();
+    migrate();
+    lastEpochMs = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - epochStartTime).count();
+
+    // Share the best tour of the islands.
+    if (context != nullptr && getBestLength() < context->bestLength) {
+      context->offerOrder(getBestOrder(), getBestLength(), "simulated annealing");
+    }
+  }
+
+  return movesCount;
+}
+
+// Method that returns the best order found by any island.
+vector<unsigned int> Annealing::getBestOrder() const {
+  const Island* bestIsland = &islands[0];
+  for (const Island& island : islands) {
+    if (island.bestLength < bestIsland->bestLength) bestIsland = &island;
+  }
+  return bestIsland->bestOrder;
+}
+
+// Method that returns the length of the best order found by any island.
+unsigned long long Annealing::getBestLength() const {
+  unsigned long long bestLength = ULLONG_MAX;
+  for (const Island& island : islands) {
+    bestLength = min(bestLength, island.bestLength);
+  }
+  return bestLength;
+}
+
+// Method that runs one epoch of an island, cooling it from one temperature to another.
+void Annealing::runEpoch(Island& island, unsigned long long moves, double startTemperature, double endTemperature) {
+  const double coolingFactor = pow(endTemperature / startTemperature, 1.0 / max(1ULL, moves));
+  double temperature = startTemperature;
+  for (unsigned long long move = 0; move < moves; move++, temperature *= coolingFactor) {
+    tryMove(island, temperature);
+  }
+
+  // Keep the tour the island ended the epoch with if it is its best so far.
+  if (island.length < island.bestLength) {
+    island.bestLength = island.length;
+    island.bestOrder = island.tour.getOrder();
+  }
+}
+
+// Method that tries a random move on an island and makes it if the annealing accepts it.
+void Annealing::tryMove(Island& island, double temperature) {
+  Tour& tour = island.tour;
+  if (tour.size < 5) return;
+
+  // Pick a checkpoint and one of its near neighbors.
+  const unsigned int checkpoint = (unsigned int) (island.generator() % tour.size);
+  const unsigned int candidate = tour.neighbors[(size_t) checkpoint * tour.neighborsCount + island.generator() % tour.neighborsCount];
+  const bool isTwoOpt = island.generator() & 1;
+
+  // Evaluate either a 2-opt move that connects the checkpoint to the candidate,
+  // or an Or-opt move of the segment that starts at the checkpoint into the edge that leaves the candidate.
+  long long delta = 0;
+  unsigned int segmentEnd = checkpoint;
+  bool isReversed = false;
+  if (isTwoOpt) {
+    const unsigned int next = tour.getNext(checkpoint);
+    const unsigned int candidateNext = tour.getNext(candidate);
+    if (candidate == next || candidateNext == checkpoint) return;
+    delta = (long long) (tour.getDistance(checkpoint, candidate) + tour.getDistance(next, candidateNext))
+        - (long long) (tour.getDistance(checkpoint, next) + tour.getDistance(candidate, candidateNext));
+  } else {
+    const unsigned int segmentLength = 1 + (unsigned int) (island.generator() % Tour::MAX_SEGMENT_LENGTH);
+    if (segmentLength + 3 > tour.size) return;
+    for (unsigned int k = 1; k < segmentLength; k++) segmentEnd = tour.getNext(segmentEnd);
+    if ((tour.positions[candidate] + tour.size - tour.positions[checkpoint]) % tour.size < segmentLength) return;
+
+    const unsigned int before = tour.getPrevious(checkpoint);
+    const unsigned int after = tour.getNext(segmentEnd);
+    const unsigned int candidateNext = tour.getNext(candidate);
+    if (candidateNext == checkpoint || candidateNext == before) return;
+
+    const unsigned long long forwardCost = tour.getDistance(candidate, checkpoint) + tour.getDistance(segmentEnd, candidateNext);
+    const unsigned long long reversedCost = tour.getDistance(candidate, segmentEnd) + tour.getDistance(checkpoint, candidateNext);
+    isReversed = reversedCost <= forwardCost;
+    delta = (long long) (min(forwardCost, reversedCost) + tour.getDistance(before, after))
+        - (long long) (tour.getDistance(before, checkpoint) + tour.getDistance(segmentEnd, after) + tour.getDistance(candidate, candidateNext));
+  }
+
+  // Accept the improving moves, and the worsening ones with the probability that falls with the temperature.
+  if (delta > 0 && (double) (island.generator() >> 11) * 0x1.0p-53 >= exp(-(double) delta / temperature)) return;
+  if (isTwoOpt) {
+    tour.makeTwoOptMove(checkpoint, tour.getNext(checkpoint), candidate, tour.getNext(candidate));
+  } else {
+    tour.makeOrOptMove(checkpoint, segmentEnd, candidate, isReversed);
+  }
+  island.length = (unsigned long long) ((long long) island.length + delta);
+}
+
+// Method that lets every island take over the best tour of the previous island in the ring if it is shorter than its own.
+void Annealing::migrate() {
+  // Read all the best tours first, so that the exchange does not depend on the order of the islands.
+  vector<vector<unsigned int>> migratingOrders(islands.size());
+  for (size_t i = 0; i < islands.size(); i++) {
+    const Island& previousIsland = islands[(i + islands.size() - 1) % islands.size()];
+    if (previousIsland.bestLength < islands[i].bestLength) migratingOrders[i] = previousIsland.bestOrder;
+  }
+
+  for (size_t i = 0; i < islands.size(); i++) {
+    if (migratingOrders[i].empty()) continue;
+    Island& island = islands[i];
+    island.tour.setOrder(migratingOrders[i]);
+    island.length = island.tour.getLength();
+    island.bestOrder = migratingOrders[i];
+    island.bestLength = island.length;
+  }
+}
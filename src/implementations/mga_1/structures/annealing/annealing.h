@@ -0,0 +1,75 @@
+#ifndef ANNEALING_H
+#define ANNEALING_H
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include "../tour/tour.h"
+#include "../thread_pool/thread_pool.h"
+#include "../solver_context/solver_context.h"
+
+using namespace std;
+
+// Structure that solves the checkpoints tour with simulated annealing on several islands at once (one per thread).
+// Every island anneals its own copy of the same starting tour with random 2-opt and Or-opt moves taken from the neighbor lists,
+// all of them reading the same distance matrix. The islands run in epochs of a fixed number of moves, and after each epoch every
+// island takes over the best tour of the previous island in the ring if it is shorter than its own best. The epochs end together,
+// and the temperature of an epoch depends only on how many epochs came before it (a run without a move limit reheats after every
+// cooling cycle), so the tours after each epoch depend only on the seed and the number of islands. The time limit only decides
+// after which epoch the run stops.
+// With a solver context, the run also stops when the context does, and the best tour is offered to it after every epoch.
+struct Annealing {
+  // The number of moves each island tries per epoch.
+  static constexpr unsigned long long EPOCH_MOVES = 20000;
+
+  // The number of moves each island tries per cooling cycle (at most the moves of the whole run).
+  static constexpr unsigned long long COOLING_CYCLE_MOVES = 2000000;
+
+  // The temperatures at the start and at the end of a cooling cycle, relative to the average edge of the starting tour.
+  static constexpr double START_TEMPERATURE_RATIO = 0.1;
+  static constexpr double END_TEMPERATURE_RATIO = 0.001;
+
+  // Structure that represents an island: its tour, its random generator and the best tour it has seen.
+  struct Island {
+    Tour tour;
+    mt19937_64 generator;
+    unsigned long long length = 0;
+    vector<unsigned int> bestOrder;
+    unsigned long long bestLength = 0;
+
+    // Constructor.
+    Island(const Tour& _tour, unsigned long long seed);
+  };
+
+  // The islands.
+  vector<Island> islands;
+
+  // The temperature scale (the average edge of the starting tour).
+  double averageEdge = 0;
+
+  // Constructor.
+  Annealing(const Tour& startTour, unsigned int islandsCount, unsigned long long seed);
+
+  // Method that anneals the islands for the given number of moves per island or until the time limit (0 for none) runs out.
+  // Returns the number of moves tried.
+  unsigned long long run(ThreadPool* pool, unsigned long long movesPerIsland, long long timeLimitMs = 0, SolverContext* context = nullptr);
+
+  // Method that returns the best order found by any island.
+  vector<unsigned int> getBestOrder() const;
+
+  // Method that returns the length of the best order found by any island.
+  unsigned long long getBestLength() const;
+
+  // Method that runs one epoch of an island, cooling it from one temperature to another.
+  static void runEpoch(Island& island, unsigned long long moves, double startTemperature, double endTemperature);
+
+  // Method that tries a random move on an island and makes it if the annealing accepts it.
+  static void tryMove(Island& island, double temperature);
+
+  // Method that lets every island take over the best tour of the previous island in the ring if it is shorter than its own.
+  void migrate();
+};
+
+#endif
@@ -0,0 +1,499 @@
+#include "branch_and_bound.h"
+
+// Constructor.
+BranchAndBound::BranchAndBound(const DistanceMatrix& matrix, bool _isOpen, bool _isStartFixed) : isOpen(_isOpen), isStartFixed(_isOpen && _isStartFixed) {
+  size = matrix.size + (isOpen && matrix.size > 0);
+  distances.assign((size_t) size * size, 0);
+  initialStates.assign((size_t) size * size, EDGE_FREE);
+  for (unsigned int i = 0; i < matrix.size; i++) {
+    for (unsigned int j = 0; j < matrix.size; j++) {
+      const unsigned int distance = matrix.get(i, j);
+      distances[(size_t) i * size + j] = distance == DistanceMatrix::UNREACHABLE ? 0 : distance;
+      if (i == j || distance == DistanceMatrix::UNREACHABLE) initialStates[(size_t) i * size + j] = EDGE_EXCLUDED;
+    }
+  }
+  if (isOpen) initialStates[(size_t) size * size - 1] = EDGE_EXCLUDED;
+  if (isStartFixed && size > 2) initialStates[size - 1] = initialStates[(size_t) (size - 1) * size] = EDGE_INCLUDED;
+}
+
+// Method that sets the starting best tour (all the checkpoints in the order of the cycle, including the virtual one).
+void BranchAndBound::setIncumbent(const vector<unsigned int>& cycle) {
+  if (cycle.size() != size) return;
+  unsigned long long length = 0;
+  for (unsigned int i = 0; i < size; i++) {
+    const unsigned int from = cycle[i];
+    const unsigned int to = cycle[(i + 1) % size];
+    if (size > 1 && initialStates[(size_t) from * size + to] == EDGE_EXCLUDED) return;
+    length += getDistance(from, to);
+  }
+
+  // A path from a fixed start must go from the virtual checkpoint to checkpoint 0.
+  if (isStartFixed && size > 2) {
+    const size_t virtualPosition = find(cycle.begin(), cycle.end(), size - 1) - cycle.begin();
+    if (cycle[(virtualPosition + 1) % size] != 0 && cycle[(virtualPosition + size - 1) % size] != 0) return;
+  }
+  if (length < bestLength) {
+    bestCycle = cycle;
+    bestLength = length;
+  }
+}
+
+// Method that searches for the shortest tour (in parallel if a thread pool is given) until it is complete or the context stops it.
+void BranchAndBound::solve(ThreadPool* pool, SolverContext* _context) {
+  context = _context;
+  // With fewer than 4 checkpoints all the tours have the same edges.
+  if (size < 4) {
+    if (bestCycle.empty()) {
+      bestCycle.resize(size);
+      iota(bestCycle.begin(), bestCycle.end(), 0);
+      bestLength = 0;
+      for (unsigned int i = 0; i < size && size > 1; i++) bestLength += getDistance(i, (i + 1) % size);
+    }
+    if (context != nullptr) {
+      context->offerOrder(getOrder(), bestLength, "branch and bound");
+      context->offerLowerBound(bestLength, "branch and bound (optimal)");
+    }
+    return;
+  }
+
+  // Start from the root, with all the edges free (besides the missing ones).
+  Node root;
+  root.penalties.assign(size, 0);
+  openNodesBytes = getNodeBytes(root);
+  openNodes.push_back(root);
+
+  auto runWorkers = [&](size_t firstWorker, size_t lastWorker) {
+    for (size_t worker = firstWorker; worker < lastWorker; worker++) {
+      runWorker();
+    }
+  };
+  if (pool != nullptr && pool->getNumThreads() > 1) {
+    pool->parallelFor(0, pool->getNumThreads(), 1, runWorkers);
+  } else {
+    runWorkers(0, 1);
+  }
+
+  // A complete search proves that no tour is shorter than the best one known.
+  if (context != nullptr && !isInterrupted && getBoundLength() != ULLONG_MAX) {
+    context->offerLowerBound(getBoundLength(), "branch and bound (optimal)");
+  }
+}
+
+// Method that returns the checkpoint IDs of the best tour starting from checkpoint 0 (or along the path, if it is open, from checkpoint 0 if its start is fixed).
+vector<unsigned int> BranchAndBound::getOrder() const {
+  if (bestCycle.empty()) return {};
+  const unsigned int start = isOpen ? size - 1 : 0;
+  const unsigned int first = (unsigned int) (find(bestCycle.begin(), bestCycle.end(), start) - bestCycle.begin()) + isOpen;
+  vector<unsigned int> checkpointsOrder;
+  for (unsigned int i = 0; i < size - isOpen; i++) {
+    checkpointsOrder.push_back(bestCycle[(first + i) % size]);
+  }
+
+  // The cycle may run from the virtual checkpoint to the end of the path rather than to its start.
+  if (isStartFixed && checkpointsOrder[0] != 0) reverse(checkpointsOrder.begin(), checkpointsOrder.end());
+  return checkpointsOrder;
+}
+
+// Method that returns the length of the best tour (of the path, if it is open).
+unsigned long long BranchAndBound::getLength() const {
+  return bestLength;
+}
+
+// Method that takes open nodes from the pool and dives from them until the pool is empty and no other worker can add to it.
+void BranchAndBound::runWorker() {
+  Node node;
+  vector<uint8_t> states;
+  vector<Node> stack;
+  while (takeNode(node)) {
+    // Explore the node, and then the children that did not fit the pool (the deepest one first).
+    explore(node, states, stack);
+    while (!stack.empty() && !isStopped()) {
+      node = move(stack.back());
+      stack.pop_back();
+      if (!isPruned(node.bound)) explore(node, states, stack);
+    }
+    stack.clear();
+
+    lock_guard<mutex> lock(openNodesMutex);
+    busyWorkers--;
+  }
+}
+
+// Method that rebuilds the edge states of a node from its decisions and dives from it (if it is feasible).
+void BranchAndBound::explore(Node& node, vector<uint8_t>& states, vector<Node>& stack) {
+  states = initialStates;
+  bool isFeasible = true;
+  for (const Decision& decision : node.decisions) {
+    const size_t index = (size_t) decision.from * size + decision.to;
+    if (states[index] != EDGE_FREE && states[index] != (decision.isIncluded ? EDGE_INCLUDED : EDGE_EXCLUDED)) isFeasible = false;
+    states[index] = states[(size_t) decision.to * size + decision.from] = decision.isIncluded ? EDGE_INCLUDED : EDGE_EXCLUDED;
+  }
+  if (isFeasible && propagate(states)) dive(node, states, stack);
+}
+
+// Method that takes the open node with the smallest bound that can still beat the best tour. Returns false once the search is over or stopped.
+bool BranchAndBound::takeNode(Node& node) {
+  while (!isStopped()) {
+    {
+      lock_guard<mutex> lock(openNodesMutex);
+      while (!openNodes.empty()) {
+        pop_heap(openNodes.begin(), openNodes.end(), isWorseNode);
+        node = move(openNodes.back());
+        openNodes.pop_back();
+        openNodesBytes -= getNodeBytes(node);
+        if (isPruned(node.bound)) continue;
+        busyWorkers++;
+        return true;
+      }
+
+      // The search is over once no worker is left to add more nodes.
+      if (busyWorkers == 0) return false;
+    }
+    this_thread::yield();
+  }
+  return false;
+}
+
+// Method that dives from a node, always into the child that excludes the branching edge, and adds the other children to the pool
+// (or to the stack of the worker, if the pool is full).
+void BranchAndBound::dive(Node& node, vector<uint8_t>& states, vector<Node>& stack) {
+  OneTree tree;
+  while (!isPruned(node.bound) && !isStopped()) {
+    const bool isRoot = node.decisions.empty();
+    double bound = node.bound;
+    const BoundResult result = computeBound(states, node.penalties, isRoot, tree, bound);
+    nodesCount++;
+    if (isRoot) {
+      rootBound = bound;
+      if (context != nullptr && bound > 0) context->offerLowerBound((unsigned long long) ceil(bound - 1e-6), "branch and bound (root)");
+    }
+    if (result != BoundResult::BRANCH || isStopped()) return;
+    node.bound = bound;
+
+    // Branch on the longest free edge of the tree at the checkpoint of the largest degree.
+    unsigned int checkpoint = 0;
+    for (unsigned int i = 0; i < size; i++) {
+      if (tree.degrees[i] > tree.degrees[checkpoint]) checkpoint = i;
+    }
+    Decision decision = {0, 0, false};
+    double longestEdge = -numeric_limits<double>::infinity();
+    for (const pair<unsigned int, unsigned int>& edge : tree.edges) {
+      if (edge.first != checkpoint && edge.second != checkpoint) continue;
+      if (states[(size_t) edge.first * size + edge.second] != EDGE_FREE) continue;
+      const double length = (double) getDistance(edge.first, edge.second) + node.penalties[edge.first] + node.penalties[edge.second];
+      if (length > longestEdge) {
+        longestEdge = length;
+        decision = {edge.first, edge.second, false};
+      }
+    }
+    if (longestEdge == -numeric_limits<double>::infinity()) return;
+
+    // Leave the child that includes the edge for later.
+    Node includingChild;
+    includingChild.bound = bound;
+    includingChild.decisions = node.decisions;
+    includingChild.decisions.push_back({decision.from, decision.to, true});
+    includingChild.penalties = node.penalties;
+    {
+      lock_guard<mutex> lock(openNodesMutex);
+      const size_t nodeBytes = getNodeBytes(includingChild);
+      if (openNodesBytes + nodeBytes <= MAX_OPEN_NODES_BYTES) {
+        openNodesBytes += nodeBytes;
+        openNodes.push_back(move(includingChild));
+        push_heap(openNodes.begin(), openNodes.end(), isWorseNode);
+      }
+    }
+    if (!includingChild.penalties.empty()) stack.push_back(move(includingChild));
+
+    // Go on with the child that excludes it.
+    node.decisions.push_back(decision);
+    if (!applyDecision(states, decision)) return;
+  }
+}
+
+// Method that bounds a node with the given edge states, tuning its penalties. Keeps the best 1-tree and the best bound.
+BranchAndBound::BoundResult BranchAndBound::computeBound(const vector<uint8_t>& states, vector<double>& penalties, bool isRoot, OneTree& tree, double& bound) {
+  vector<double> bestPenalties = penalties;
+  double bestBound = -numeric_limits<double>::infinity();
+  double step = isRoot ? ROOT_STEP : NODE_STEP;
+  const unsigned int iterations = isRoot ? ROOT_ITERATIONS : NODE_ITERATIONS;
+
+  OneTree currentTree;
+  unsigned int stalledIterations = 0;
+  for (unsigned int iteration = 0; iteration < iterations && step >= MIN_STEP && !isStopped(); iteration++) {
+    if (!buildOneTree(states, penalties, currentTree)) return BoundResult::INFEASIBLE;
+
+    // The length of the 1-tree without the penalties is a lower bound of every tour of the node.
+    double penaltiesSum = 0;
+    for (double penalty : penalties) penaltiesSum += penalty;
+    const double currentBound = currentTree.length - 2 * penaltiesSum;
+    if (currentBound > bestBound) {
+      stalledIterations = 0;
+      bestBound = currentBound;
+      bestPenalties = penalties;
+      tree = currentTree;
+    }
+
+    // A 1-tree with all the degrees 2 is the shortest tour of the node.
+    unsigned long long squaredNorm = 0;
+    for (unsigned int degree : currentTree.degrees) {
+      squaredNorm += (unsigned long long) (((long long) degree - 2) * ((long long) degree - 2));
+    }
+    if (squaredNorm == 0) {
+      offerTour(currentTree.edges);
+      bound = currentBound;
+      return BoundResult::SOLVED;
+    }
+    if (isPruned(bestBound)) {
+      bound = bestBound;
+      return BoundResult::PRUNED;
+    }
+
+    // Move the penalties along the degrees, by a step relative to the gap to the best tour.
+    const unsigned long long boundLength = getBoundLength();
+    const double gap = boundLength == ULLONG_MAX ? max(1.0, 0.05 * fabs(currentBound)) : max(1.0, (double) boundLength - currentBound);
+    const double stepLength = step * gap / (double) squaredNorm;
+    for (unsigned int i = 0; i < size; i++) {
+      penalties[i] += stepLength * ((double) currentTree.degrees[i] - 2);
+    }
+    if (++stalledIterations == STALL_ITERATIONS) {
+      stalledIterations = 0;
+      step /= 2;
+
+      // Share the bound of the root as it rises, since the root alone may take all the time the context has.
+      if (isRoot && context != nullptr && bestBound > 0) context->offerLowerBound((unsigned long long) ceil(bestBound - 1e-6), "branch and bound (root)");
+    }
+  }
+
+  penalties = bestPenalties;
+  bound = bestBound;
+  return isPruned(bestBound) ? BoundResult::PRUNED : BoundResult::BRANCH;
+}
+
+// Method that builds the shortest 1-tree with the given penalties that has all the included edges and none of the excluded ones.
+// Returns false if there is none.
+bool BranchAndBound::buildOneTree(const vector<uint8_t>& states, const vector<double>& penalties, OneTree& tree) const {
+  tree.edges.clear();
+  tree.degrees.assign(size, 0);
+  tree.length = 0;
+
+  // Grow the spanning tree of all the checkpoints but 0 (Prim), taking the included edges before any free one.
+  // The key of a checkpoint is the rank of its best edge to the tree (0 for an included one, 1 for a free one, 2 for none) and its length.
+  vector<bool> isInTree(size, false);
+  vector<uint8_t> keyRanks(size, 2);
+  vector<double> keyLengths(size, numeric_limits<double>::infinity());
+  vector<unsigned int> parents(size, 0);
+  isInTree[0] = true;
+  isInTree[1] = true;
+  unsigned int current = 1;
+  for (unsigned int added = 2; added < size; added++) {
+    unsigned int next = 0;
+    for (unsigned int i = 2; i < size; i++) {
+      if (isInTree[i]) continue;
+      const uint8_t state = states[(size_t) current * size + i];
+      if (state != EDGE_EXCLUDED) {
+        const uint8_t rank = state == EDGE_INCLUDED ? 0 : 1;
+        const double length = (double) getDistance(current, i) + penalties[current] + penalties[i];
+        if (rank < keyRanks[i] || (rank == keyRanks[i] && length < keyLengths[i])) {
+          keyRanks[i] = rank;
+          keyLengths[i] = length;
+          parents[i] = current;
+        }
+      }
+      if (next == 0 || keyRanks[i] < keyRanks[next] || (keyRanks[i] == keyRanks[next] && keyLengths[i] < keyLengths[next])) next = i;
+    }
+    if (keyRanks[next] == 2) return false;
+
+    isInTree[next] = true;
+    tree.edges.push_back({parents[next], next});
+    tree.degrees[parents[next]]++;
+    tree.degrees[next]++;
+    tree.length += keyLengths[next];
+    current = next;
+  }
+
+  // Connect checkpoint 0 by its two shortest edges, taking the included ones first.
+  unsigned int first = 0;
+  unsigned int second = 0;
+  auto isBetter = [&](unsigned int i, unsigned int j) {
+    if (j == 0) return true;
+    const bool isIncluded = states[i] == EDGE_INCLUDED;
+    if (isIncluded != (states[j] == EDGE_INCLUDED)) return isIncluded;
+    return getDistance(0, i) + penalties[i] < getDistance(0, j) + penalties[j];
+  };
+  for (unsigned int i = 1; i < size; i++) {
+    if (states[i] == EDGE_EXCLUDED) continue;
+    if (isBetter(i, first)) {
+      second = first;
+      first = i;
+    } else if (isBetter(i, second)) {
+      second = i;
+    }
+  }
+  if (second == 0) return false;
+  for (unsigned int i : {first, second}) {
+    tree.edges.push_back({0, i});
+    tree.degrees[0]++;
+    tree.degrees[i]++;
+    tree.length += (double) getDistance(0, i) + penalties[0] + penalties[i];
+  }
+
+  return true;
+}
+
+// Method that sets the state of an edge and derives the states that follow from it. Returns false if no tour is left.
+bool BranchAndBound::applyDecision(vector<uint8_t>& states, const Decision& decision) const {
+  const size_t index = (size_t) decision.from * size + decision.to;
+  const uint8_t state = decision.isIncluded ? EDGE_INCLUDED : EDGE_EXCLUDED;
+  if (states[index] != EDGE_FREE) return states[index] == state;
+  states[index] = states[(size_t) decision.to * size + decision.from] = state;
+  return propagate(states);
+}
+
+// Method that fixes the edges forced by the degrees and excludes the edges that would close a cycle too early.
+// Returns false if no tour is left.
+bool BranchAndBound::propagate(vector<uint8_t>& states) const {
+  auto setState = [&](unsigned int i, unsigned int j, uint8_t state) {
+    states[(size_t) i * size + j] = states[(size_t) j * size + i] = state;
+  };
+
+  bool isChanged = true;
+  while (isChanged) {
+    isChanged = false;
+
+    // A checkpoint with two included edges loses the others, and a checkpoint with only two edges left keeps them.
+    for (unsigned int i = 0; i < size; i++) {
+      unsigned int includedCount = 0;
+      unsigned int freeCount = 0;
+      for (unsigned int j = 0; j < size; j++) {
+        includedCount += states[(size_t) i * size + j] == EDGE_INCLUDED;
+        freeCount += states[(size_t) i * size + j] == EDGE_FREE;
+      }
+      if (includedCount > 2 || includedCount + freeCount < 2) return false;
+      if (freeCount == 0) continue;
+      if (includedCount == 2 || includedCount + freeCount == 2) {
+        const uint8_t state = includedCount == 2 ? EDGE_EXCLUDED : EDGE_INCLUDED;
+        for (unsigned int j = 0; j < size; j++) {
+          if (states[(size_t) i * size + j] == EDGE_FREE) setState(i, j, state);
+        }
+        isChanged = true;
+      }
+    }
+    if (isChanged) continue;
+
+    // Follow the paths of the included edges: the edge between the ends of a path would close a cycle through only a part of the checkpoints.
+    vector<bool> isVisited(size, false);
+    for (unsigned int start = 0; start < size; start++) {
+      if (isVisited[start]) continue;
+      unsigned int degree = 0;
+      for (unsigned int j = 0; j < size; j++) degree += states[(size_t) start * size + j] == EDGE_INCLUDED;
+      if (degree != 1) continue;
+
+      unsigned int previous = start;
+      unsigned int current = start;
+      unsigned int length = 1;
+      isVisited[start] = true;
+      while (true) {
+        unsigned int next = size;
+        for (unsigned int j = 0; j < size && next == size; j++) {
+          if (j != previous && states[(size_t) current * size + j] == EDGE_INCLUDED) next = j;
+        }
+        if (next == size) break;
+        previous = current;
+        current = next;
+        isVisited[current] = true;
+        length++;
+      }
+      if (length < size && states[(size_t) start * size + current] == EDGE_FREE) {
+        setState(start, current, EDGE_EXCLUDED);
+        isChanged = true;
+      }
+    }
+
+    // The checkpoints left unvisited with included edges are on cycles, which must go through all the checkpoints.
+    for (unsigned int start = 0; start < size; start++) {
+      if (isVisited[start]) continue;
+      unsigned int previous = size;
+      unsigned int current = start;
+      unsigned int length = 0;
+      while (!isVisited[current]) {
+        isVisited[current] = true;
+        length++;
+        unsigned int next = size;
+        for (unsigned int j = 0; j < size && next == size; j++) {
+          if (j != previous && states[(size_t) current * size + j] == EDGE_INCLUDED) next = j;
+        }
+        if (next == size) break;
+        previous = current;
+        current = next;
+      }
+      if (length > 1 && length < size) return false;
+    }
+  }
+
+  return true;
+}
+
+// Method that records the tour made of the given edges if it is shorter than the best tour.
+void BranchAndBound::offerTour(const vector<pair<unsigned int, unsigned int>>& edges) {
+  unsigned long long length = 0;
+  vector<vector<unsigned int>> adjacent(size);
+  for (const pair<unsigned int, unsigned int>& edge : edges) {
+    length += getDistance(edge.first, edge.second);
+    adjacent[edge.first].push_back(edge.second);
+    adjacent[edge.second].push_back(edge.first);
+  }
+  if (length >= bestLength) return;
+
+  // Walk the cycle from checkpoint 0.
+  vector<unsigned int> cycle = {0};
+  unsigned int previous = 0;
+  unsigned int current = adjacent[0][0];
+  while (current != 0) {
+    cycle.push_back(current);
+    const unsigned int next = adjacent[current][0] == previous ? adjacent[current][1] : adjacent[current][0];
+    previous = current;
+    current = next;
+  }
+
+  lock_guard<mutex> lock(bestCycleMutex);
+  if (length < bestLength) {
+    bestCycle = cycle;
+    bestLength = length;
+    if (context != nullptr) context->offerOrder(getOrder(), length, "branch and bound");
+  }
+}
+
+// Method that checks whether the context stops the search (and records that the search was interrupted).
+bool BranchAndBound::isStopped() {
+  if (context == nullptr || !context->shouldStop()) return false;
+  isInterrupted = true;
+  return true;
+}
+
+// Method that returns the length a tour has to beat (the best length, or the best length of the context if that is shorter).
+unsigned long long BranchAndBound::getBoundLength() const {
+  return context != nullptr ? min((unsigned long long) bestLength, (unsigned long long) context->bestLength) : (unsigned long long) bestLength;
+}
+
+// Method that returns whether a lower bound cannot lead to a tour shorter than the best one (the lengths are integers).
+bool BranchAndBound::isPruned(double bound) const {
+  const unsigned long long currentBestLength = getBoundLength();
+  return currentBestLength != ULLONG_MAX && ceil(bound - 1e-6) >= (double) currentBestLength;
+}
+
+// Method that returns whether the first open node should be explored after the second one (the smallest bound first, and the deepest node among the equal bounds).
+bool BranchAndBound::isWorseNode(const Node& first, const Node& second) {
+  if (first.bound != second.bound) return first.bound > second.bound;
+  return first.decisions.size() < second.decisions.size();
+}
+
+// Method that returns the memory an open node takes.
+size_t BranchAndBound::getNodeBytes(const Node& node) {
+  return sizeof(Node) + node.decisions.capacity() * sizeof(Decision) + node.penalties.capacity() * sizeof(double);
+}
+
+// Method that returns the distance between two checkpoints.
+unsigned long long BranchAndBound::getDistance(unsigned int i, unsigned int j) const {
+  return distances[(size_t) i * size + j];
+}
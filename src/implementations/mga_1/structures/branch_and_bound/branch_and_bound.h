@@ -0,0 +1,176 @@
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <cstdint>
+#include <climits>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include "../distance_matrix/distance_matrix.h"
+#include "../thread_pool/thread_pool.h"
+#include "../solver_context/solver_context.h"
+
+using namespace std;
+
+// Structure that solves the shortest cycle through all the checkpoints exactly with branch and bound over the edges.
+// Every node of the search fixes some edges in or out of the tour, and is bounded by the Held-Karp 1-tree: a spanning tree of all the
+// checkpoints but 0 plus the two shortest edges of checkpoint 0, with penalties on the checkpoints tuned by subgradient optimization
+// to push every degree to 2. A 1-tree with all the degrees 2 is a tour, so such a node is solved. Otherwise the search branches on a
+// free edge of the tree at a checkpoint of a larger degree: one child excludes the edge, the other includes it.
+// The search dives depth first (always into the excluding child, leaving the including one in the pool of open nodes), and every time
+// a dive ends it restarts from the open node with the smallest bound. The workers dive in parallel, sharing the pool and the best tour.
+// Only the branching decisions and the penalties are kept for every open node. Once the pool holds MAX_OPEN_NODES_BYTES, a worker keeps
+// the children it leaves for later on a stack of its own and explores them depth first, so the memory stays polynomial in the number of checkpoints.
+// For an open path an extra virtual checkpoint at zero distance from all the others closes the tour, so the tour through it is the path.
+// If the path has to start from checkpoint 0, the edge between the virtual checkpoint and checkpoint 0 is included from the root.
+// With a solver context, the nodes are also pruned against the best route of the context, the search stops when the context does,
+// and it offers the context every better tour, the root bound and, once the search is complete, the best length as the lower bound.
+struct BranchAndBound {
+  // The largest numbers of the subgradient iterations at the root and at the other nodes (which start from the penalties of their parent).
+  static constexpr unsigned int ROOT_ITERATIONS = 20000;
+  static constexpr unsigned int NODE_ITERATIONS = 300;
+
+  // The first subgradient step (relative to the gap to the best tour) at the root and at the other nodes. The step is halved after
+  // STALL_ITERATIONS iterations without a better bound, and the optimization stops once it falls below MIN_STEP.
+  static constexpr double ROOT_STEP = 2.0;
+  static constexpr double NODE_STEP = 0.5;
+  static constexpr unsigned int STALL_ITERATIONS = 100;
+  static constexpr double MIN_STEP = 0.0001;
+
+  // The largest memory of the pool of open nodes (beyond it, the nodes are explored depth first by the worker that creates them).
+  static constexpr size_t MAX_OPEN_NODES_BYTES = 1ULL << 28;
+
+  // The states of the edges.
+  static constexpr uint8_t EDGE_FREE = 0;
+  static constexpr uint8_t EDGE_INCLUDED = 1;
+  static constexpr uint8_t EDGE_EXCLUDED = 2;
+
+  // Structure that represents a branching decision: an edge fixed in or out of the tour.
+  struct Decision {
+    unsigned int from;
+    unsigned int to;
+    bool isIncluded;
+  };
+
+  // Structure that represents an open node of the search: its decisions, the bound of its parent and the penalties to start from.
+  struct Node {
+    double bound = -numeric_limits<double>::infinity();
+    vector<Decision> decisions;
+    vector<double> penalties;
+  };
+
+  // Structure that represents a 1-tree: its edges, the degrees of the checkpoints and its length with the penalties.
+  struct OneTree {
+    vector<pair<unsigned int, unsigned int>> edges;
+    vector<unsigned int> degrees;
+    double length = 0;
+  };
+
+  // The results of bounding a node.
+  enum class BoundResult {
+    INFEASIBLE,
+    PRUNED,
+    SOLVED,
+    BRANCH
+  };
+
+  // Whether the tour is an open path (through the virtual checkpoint, the last ID) and the number of checkpoints (including it).
+  bool isOpen = false;
+  unsigned int size = 0;
+
+  // Whether the open path has to start from checkpoint 0.
+  bool isStartFixed = false;
+
+  // The distances between the checkpoints (row-major) and the states of the edges before any decision (the missing edges are excluded).
+  vector<unsigned long long> distances;
+  vector<uint8_t> initialStates;
+
+  // The open nodes (a heap with the smallest bound on top), their memory and the number of workers that are exploring a node.
+  vector<Node> openNodes;
+  size_t openNodesBytes = 0;
+  mutex openNodesMutex;
+  unsigned int busyWorkers = 0;
+
+  // The best tour found so far (all the checkpoints in the order of the cycle) and its length.
+  vector<unsigned int> bestCycle;
+  atomic<unsigned long long> bestLength{ULLONG_MAX};
+  mutex bestCycleMutex;
+
+  // The bound at the root and the number of bounded nodes.
+  double rootBound = 0;
+  atomic<unsigned long long> nodesCount{0};
+
+  // The context the search reports to and stops with (if any), and whether it was stopped before it was complete.
+  SolverContext* context = nullptr;
+  atomic<bool> isInterrupted{false};
+
+  // Constructor.
+  BranchAndBound(const DistanceMatrix& matrix, bool _isOpen = false, bool _isStartFixed = false);
+
+  // Method that sets the starting best tour (all the checkpoints in the order of the cycle, including the virtual one).
+  void setIncumbent(const vector<unsigned int>& cycle);
+
+  // Method that searches for the shortest tour (in parallel if a thread pool is given) until it is complete or the context stops it.
+  void solve(ThreadPool* pool = nullptr, SolverContext* _context = nullptr);
+
+  // Method that returns the checkpoint IDs of the best tour starting from checkpoint 0 (or along the path, if it is open, from checkpoint 0 if its start is fixed).
+  vector<unsigned int> getOrder() const;
+
+  // Method that returns the length of the best tour (of the path, if it is open).
+  unsigned long long getLength() const;
+
+  // Method that takes open nodes from the pool and dives from them until the pool is empty and no other worker can add to it.
+  void runWorker();
+
+  // Method that rebuilds the edge states of a node from its decisions and dives from it (if it is feasible).
+  void explore(Node& node, vector<uint8_t>& states, vector<Node>& stack);
+
+  // Method that takes the open node with the smallest bound that can still beat the best tour. Returns false once the search is over or stopped.
+  bool takeNode(Node& node);
+
+  // Method that dives from a node, always into the child that excludes the branching edge, and adds the other children to the pool
+  // (or to the stack of the worker, if the pool is full).
+  void dive(Node& node, vector<uint8_t>& states, vector<Node>& stack);
+
+  // Method that bounds a node with the given edge states, tuning its penalties. Keeps the best 1-tree and the best bound.
+  BoundResult computeBound(const vector<uint8_t>& states, vector<double>& penalties, bool isRoot, OneTree& tree, double& bound);
+
+  // Method that builds the shortest 1-tree with the given penalties that has all the included edges and none of the excluded ones.
+  // Returns false if there is none.
+  bool buildOneTree(const vector<uint8_t>& states, const vector<double>& penalties, OneTree& tree) const;
+
+  // Method that sets the state of an edge and derives the states that follow from it. Returns false if no tour is left.
+  bool applyDecision(vector<uint8_t>& states, const Decision& decision) const;
+
+  // Method that fixes the edges forced by the degrees and excludes the edges that would close a cycle too early.
+  // Returns false if no tour is left.
+  bool propagate(vector<uint8_t>& states) const;
+
+  // Method that records the tour made of the given edges if it is shorter than the best tour.
+  void offerTour(const vector<pair<unsigned int, unsigned int>>& edges);
+
+  // Method that checks whether the context stops the search (and records that the search was interrupted).
+  bool isStopped();
+
+  // Method that returns the length a tour has to beat (the best length, or the best length of the context if that is shorter).
+  unsigned long long getBoundLength() const;
+
+  // Method that returns whether a lower bound cannot lead to a tour shorter than the best one (the lengths are integers).
+  bool isPruned(double bound) const;
+
+  // Method that returns whether the first open node should be explored after the second one (the smallest bound first, and the deepest node among the equal bounds).
+  static bool isWorseNode(const Node& first, const Node& second);
+
+  // Method that returns the memory an open node takes.
+  static size_t getNodeBytes(const Node& node);
+
+  // Method that returns the distance between two checkpoints.
+  unsigned long long getDistance(unsigned int i, unsigned int j) const;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "brute_force.h"
+
+// Constructor.
+BruteForce::BruteForce(const DistanceMatrix& matrix, bool _isOpen, bool _isStartFixed) : isOpen(_isOpen), isStartFixed(_isOpen && _isStartFixed) {
+  size = matrix.size + (isOpen && !isStartFixed && matrix.size > 0);
+
+  // Copy the distances into a dense row-major matrix (after the virtual start, if any).
+  const unsigned int shift = isOpen && !isStartFixed ? 1 : 0;
+  distances.assign((size_t) size * size, 0);
+  for (unsigned int i = 0; i < matrix.size; i++) {
+    for (unsigned int j = 0; j < matrix.size; j++) {
+      unsigned int distance = matrix.get(i, j);
+      distances[(size_t) (i + shift) * size + j + shift] = distance == DistanceMatrix::UNREACHABLE ? UINT32_MAX : distance;
+    }
+  }
+
+  // A path from a fixed start ends anywhere, so the cycle returns to the start for free.
+  if (isStartFixed) {
+    for (unsigned int i = 0; i < size; i++) distances[(size_t) i * size] = 0;
+  }
+
+  // Sort the other checkpoints of each one by their distance, and find the shortest edge into each checkpoint from a real one.
+  nearestCheckpoints.assign(size, {});
+  shortestEdges.assign(size, 0);
+  for (unsigned int i = 0; i < size; i++) {
+    for (unsigned int j = shift; j < size; j++) {
+      if (j != i && getDistance(i, j) != UINT32_MAX) nearestCheckpoints[i].push_back(j);
+    }
+    sort(nearestCheckpoints[i].begin(), nearestCheckpoints[i].end(), [&](unsigned int first, unsigned int second) {
+      return getDistance(i, first) < getDistance(i, second);
+    });
+  }
+  for (unsigned int j = shift; j < size; j++) {
+    unsigned long long shortestEdge = ULLONG_MAX;
+    for (unsigned int i = shift; i < size; i++) {
+      if (i != j && getDistance(i, j) != UINT32_MAX) shortestEdge = min(shortestEdge, (unsigned long long) getDistance(i, j));
+    }
+    if (shortestEdge != ULLONG_MAX) shortestEdges[j] = shortestEdge;
+  }
+}
+
+// Method that searches all the orders (in parallel if a thread pool is given) until it is complete or the context stops it.
+void BruteForce::solve(ThreadPool* pool, SolverContext* _context) {
+  context = _context;
+  if (size == 0) return;
+
+  // Start from checkpoint 0, with the shortest edges into all the others still to pay.
+  const uint32_t unvisited = (uint32_t) (((1ULL << size) - 1) & ~1ULL);
+  unsigned long long remainingBound = 0;
+  for (unsigned int i = 1; i < size; i++) remainingBound += shortestEdges[i];
+
+  // Enumerate the prefixes of the first checkpoints, and let the threads search from them.
+  vector<vector<unsigned int>> prefixes = {{0}};
+  for (unsigned int depth = 1; depth < min(SPLIT_DEPTH, size); depth++) {
+    vector<vector<unsigned int>> longerPrefixes;
+    for (const vector<unsigned int>& prefix : prefixes) {
+      for (unsigned int checkpoint : nearestCheckpoints[prefix.back()]) {
+        if (find(prefix.begin(), prefix.end(), checkpoint) != prefix.end()) continue;
+        longerPrefixes.push_back(prefix);
+        longerPrefixes.back().push_back(checkpoint);
+      }
+    }
+    prefixes = longerPrefixes;
+  }
+
+  auto searchPrefixes = [&](size_t firstPrefix, size_t lastPrefix) {
+    unsigned long long prefixesCount = 0;
+    for (size_t p = firstPrefix; p < lastPrefix; p++) {
+      // Walk the prefix, checking it the same way the search checks its extensions.
+      vector<unsigned int> order = {0};
+      uint32_t prefixUnvisited = unvisited;
+      unsigned long long length = 0;
+      unsigned long long prefixBound = remainingBound;
+      bool isValid = true;
+      for (unsigned int k = 1; k < prefixes[p].size() && isValid; k++) {
+        const unsigned int checkpoint = prefixes[p][k];
+        prefixUnvisited &= ~((uint32_t) 1 << checkpoint);
+        isValid = !isMirrorSkipped(order, checkpoint, prefixUnvisited);
+        length += getDistance(order.back(), checkpoint);
+        prefixBound -= shortestEdges[checkpoint];
+        order.push_back(checkpoint);
+      }
+      if (isValid) search(order, prefixUnvisited, length, prefixBound, prefixesCount);
+    }
+    visitedPrefixes += prefixesCount;
+  };
+  if (pool != nullptr && pool->getNumThreads() > 1) {
+    pool->parallelFor(0, prefixes.size(), 1, searchPrefixes);
+  } else {
+    searchPrefixes(0, prefixes.size());
+  }
+
+  // A complete search proves that no route is shorter than the best one known.
+  if (context != nullptr && !isInterrupted && getBoundLength() != ULLONG_MAX) {
+    context->offerLowerBound(getBoundLength(), "brute force (optimal)");
+  }
+}
+
+// Method that returns the checkpoint IDs of the shortest cycle starting from checkpoint 0, or of the shortest open path (empty if there is none).
+vector<unsigned int> BruteForce::getOrder() const {
+  vector<unsigned int> order = bestOrder;
+
+  // Drop the virtual start.
+  if (isOpen && !isStartFixed && !order.empty()) {
+    order.erase(order.begin());
+    for (unsigned int& checkpointId : order) checkpointId--;
+  }
+
+  return order;
+}
+
+// Method that returns the length of the best order (of the path, if it is open).
+unsigned long long BruteForce::getLength() const {
+  return bestLength;
+}
+
+// Method that extends the prefix with every checkpoint not visited yet that can still lead to a shorter order.
+void BruteForce::search(vector<unsigned int>& order, uint32_t unvisited, unsigned long long length, unsigned long long remainingBound, unsigned long long& prefixesCount) {
+  // Unwind once the context stops the search (checking its clock only every few prefixes).
+  if (isInterrupted) return;
+  if ((++prefixesCount & (STOP_CHECK_PREFIXES - 1)) == 0 && context != nullptr && context->shouldStop()) {
+    isInterrupted = true;
+    return;
+  }
+  const unsigned int last = order.back();
+
+  // Close the cycle once all the checkpoints are visited.
+  if (unvisited == 0) {
+    if (getDistance(last, 0) == UINT32_MAX) return;
+    length += getDistance(last, 0);
+    if (length >= getBoundLength()) return;
+
+    lock_guard<mutex> lock(bestOrderMutex);
+    if (length < bestLength) {
+      bestLength = length;
+      bestOrder = order;
+      if (context != nullptr) context->offerOrder(getOrder(), length, "brute force");
+    }
+    return;
+  }
+
+  for (unsigned int checkpoint : nearestCheckpoints[last]) {
+    if (!(unvisited & ((uint32_t) 1 << checkpoint))) continue;
+
+    // Skip the checkpoint if the prefix through it cannot beat the best order, or if it only leads to mirror images.
+    const unsigned long long nextLength = length + getDistance(last, checkpoint);
+    const unsigned long long nextBound = remainingBound - shortestEdges[checkpoint];
+    if (nextLength + nextBound >= getBoundLength()) continue;
+    const uint32_t nextUnvisited = unvisited & ~((uint32_t) 1 << checkpoint);
+    if (isMirrorSkipped(order, checkpoint, nextUnvisited)) continue;
+
+    order.push_back(checkpoint);
+    search(order, nextUnvisited, nextLength, nextBound, prefixesCount);
+    order.pop_back();
+  }
+}
+
+// Method that returns the length a prefix has to beat (the best length, or the best length of the context if that is shorter).
+unsigned long long BruteForce::getBoundLength() const {
+  return context != nullptr ? min((unsigned long long) bestLength, (unsigned long long) context->bestLength) : (unsigned long long) bestLength;
+}
+
+// Method that checks whether the prefix can be extended by a checkpoint without leaving only mirror images of the enumerated orders.
+bool BruteForce::isMirrorSkipped(const vector<unsigned int>& order, unsigned int checkpoint, uint32_t unvisited) const {
+  // The second checkpoint is compared to the last one, so the last one must be able to have a larger ID.
+  if (order.size() < 2 || size < 4 || isStartFixed) return false;
+  const unsigned int second = order[1];
+  return unvisited == 0 ? checkpoint < second : (unvisited >> (second + 1)) == 0;
+}
+
+// Method that returns the distance between two checkpoints.
+uint32_t BruteForce::getDistance(unsigned int i, unsigned int j) const {
+  return distances[(size_t) i * size + j];
+}
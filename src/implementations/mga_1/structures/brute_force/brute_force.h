@@ -0,0 +1,85 @@
+#ifndef BRUTE_FORCE_H
+#define BRUTE_FORCE_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include "../distance_matrix/distance_matrix.h"
+#include "../thread_pool/thread_pool.h"
+#include "../solver_context/solver_context.h"
+
+using namespace std;
+
+// Structure that solves the shortest cycle through all the checkpoints exactly by enumerating the orders with a depth-first search.
+// Checkpoint 0 is the fixed start, and a cycle and its mirror image are the same, so only the orders whose second checkpoint has
+// a smaller ID than the last one are enumerated. The length of the prefix is kept as the search goes, together with the sum of the
+// shortest edges into the checkpoints not visited yet (each of them still has to be entered once), and a prefix is cut off once
+// the two together reach the best length. The next checkpoints are tried from the nearest, so that short orders are found early.
+// The prefixes of the first SPLIT_DEPTH checkpoints are split among the threads, which share the best length.
+// For an open path the start is a virtual checkpoint at zero distance from all the others, so the cycle through it is the shortest path.
+// For an open path from a fixed start, checkpoint 0 stays the start and the edges back to it are free instead (the paths are then
+// not the same as their mirror images, so all the orders are enumerated).
+// With a solver context, the prefixes are also cut off against the best route of the context, the search stops when the context does,
+// and a complete search offers the context the best length as proven optimal.
+struct BruteForce {
+  // The number of checkpoints (including the start) fixed by the prefixes that are split among the threads.
+  static constexpr unsigned int SPLIT_DEPTH = 3;
+
+  // The number of prefixes a thread extends between the checks of the context (a power of 2).
+  static constexpr unsigned long long STOP_CHECK_PREFIXES = 4096;
+
+  // Whether the walk is an open path (through the virtual start) rather than a cycle, and whether the path starts from checkpoint 0 instead.
+  bool isOpen = false;
+  bool isStartFixed = false;
+
+  // The number of checkpoints (including the virtual start).
+  unsigned int size = 0;
+
+  // The distances between the checkpoints (row-major, UINT32_MAX if there is no path), the other checkpoints of each one from
+  // the nearest (without the missing edges and the virtual start) and the shortest edge into each checkpoint from a real one.
+  vector<uint32_t> distances;
+  vector<vector<unsigned int>> nearestCheckpoints;
+  vector<unsigned long long> shortestEdges;
+
+  // The best order found so far (starting from checkpoint 0) and its length.
+  vector<unsigned int> bestOrder;
+  atomic<unsigned long long> bestLength{ULLONG_MAX};
+  mutex bestOrderMutex;
+
+  // The number of prefixes extended by the search.
+  atomic<unsigned long long> visitedPrefixes{0};
+
+  // The context the search reports to and stops with (if any), and whether it was stopped before it was complete.
+  SolverContext* context = nullptr;
+  atomic<bool> isInterrupted{false};
+
+  // Constructor.
+  explicit BruteForce(const DistanceMatrix& matrix, bool _isOpen = false, bool _isStartFixed = false);
+
+  // Method that searches all the orders (in parallel if a thread pool is given) until it is complete or the context stops it.
+  void solve(ThreadPool* pool = nullptr, SolverContext* _context = nullptr);
+
+  // Method that returns the checkpoint IDs of the shortest cycle starting from checkpoint 0, or of the shortest open path (empty if there is none).
+  // The path starts from checkpoint 0 if its start is fixed.
+  vector<unsigned int> getOrder() const;
+
+  // Method that returns the length of the best order (of the path, if it is open).
+  unsigned long long getLength() const;
+
+  // Method that extends the prefix with every checkpoint not visited yet that can still lead to a shorter order.
+  void search(vector<unsigned int>& order, uint32_t unvisited, unsigned long long length, unsigned long long remainingBound, unsigned long long& prefixesCount);
+
+  // Method that returns the length a prefix has to beat (the best length, or the best length of the context if that is shorter).
+  unsigned long long getBoundLength() const;
+
+  // Method that checks whether the prefix can be extended by a checkpoint without leaving only mirror images of the enumerated orders.
+  bool isMirrorSkipped(const vector<unsigned int>& order, unsigned int checkpoint, uint32_t unvisited) const;
+
+  // Method that returns the distance between two checkpoints.
+  uint32_t getDistance(unsigned int i, unsigned int j) const;
+};
+
+#endif
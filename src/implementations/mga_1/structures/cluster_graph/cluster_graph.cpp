@@ -0,0 +1,266 @@
+#include "cluster_graph.h"
+
+// Constructor.
+ClusterGraph::ClusterGraph(const vector<vector<unsigned int>>& maze, unsigned int _clusterSize) : clusterSize(_clusterSize) {
+  height = maze.size();
+  width = height > 0 ? maze[0].size() : 0;
+  clustersX = (width + clusterSize - 1) / clusterSize;
+  clustersY = (height + clusterSize - 1) / clusterSize;
+  clusterEntrances.resize(clustersX * clustersY);
+  clusterDistances.resize(clustersX * clustersY);
+  cellEntranceIds.assign(width * height, -1);
+
+  // Build the clusters in parallel (every cluster only writes its own entrances and distances).
+  atomic<int> nextCluster(0);
+  auto threadFunction = [&]() {
+    for (int cluster = nextCluster++; cluster < (int) (clustersX * clustersY); cluster = nextCluster++) {
+      buildCluster(maze, cluster);
+    }
+  };
+  vector<thread> threads;
+  unsigned int numThreads = max(1u, min(thread::hardware_concurrency(), clustersX * clustersY));
+  threads.reserve(numThreads);
+  for (unsigned int i = 0; i < numThreads; i++) {
+    threads.emplace_back(threadFunction);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Method that recomputes the clusters affected by a change of the given cell (its own cluster and the clusters across its borders).
+void ClusterGraph::updateCell(const vector<vector<unsigned int>>& maze, int x, int y) {
+  const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  const int cell = y * (int) width + x;
+  vector<int> clusters = {getCluster(cell)};
+  for (auto offset : offsets) {
+    int neighborX = x + offset[0];
+    int neighborY = y + offset[1];
+    if (neighborX < 0 || neighborY < 0 || neighborX >= (int) width || neighborY >= (int) height) continue;
+    int cluster = getCluster(neighborY * (int) width + neighborX);
+    if (find(clusters.begin(), clusters.end(), cluster) == clusters.end()) {
+      clusters.push_back(cluster);
+    }
+  }
+  for (int cluster : clusters) {
+    buildCluster(maze, cluster);
+  }
+}
+
+// Method that returns the shortest path between two cells (empty if there is none) and counts the expanded cells and nodes.
+vector<Cell> ClusterGraph::getPath(const vector<vector<unsigned int>>& maze, int sourceCell, int targetCell, unsigned long long& expandedNodes) {
+  if (sourceCell == targetCell) return {{sourceCell % (int) width, sourceCell / (int) width}};
+  const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  const int sourceCluster = getCluster(sourceCell);
+  const int targetCluster = getCluster(targetCell);
+
+  // Connect the source and the target to the entrances of their clusters.
+  vector<unsigned int> sourceDistances, targetDistances;
+  vector<int> sourceParents, targetParents;
+  expandedNodes += findClusterDistances(maze, sourceCell, sourceDistances, sourceParents);
+  expandedNodes += findClusterDistances(maze, targetCell, targetDistances, targetParents);
+
+  // The direct walk inside a shared cluster is the first candidate.
+  unsigned long long best = UINT_MAX;
+  int bestEntrance = -1;
+  if (sourceCluster == targetCluster) {
+    best = sourceDistances[getClusterOffset(targetCell)];
+  }
+
+  // Run A* over the entrances with the Manhattan distance to the target as the heuristic.
+  auto getHeuristic = [&](int cell) {
+    return (unsigned long long) (abs(cell % (int) width - targetCell % (int) width) + abs(cell / (int) width - targetCell / (int) width));
+  };
+  if (searchStamps.size() != (size_t) width * height || ++currentSearchStamp == 0) {
+    searchStamps.assign((size_t) width * height, 0);
+    searchCosts.resize((size_t) width * height);
+    searchParents.resize((size_t) width * height);
+    currentSearchStamp = 1;
+  }
+  priority_queue<pair<unsigned long long, int>, vector<pair<unsigned long long, int>>, greater<>> queue;
+  auto relax = [&](int entrance, unsigned long long cost, int parent) {
+    if (searchStamps[entrance] != currentSearchStamp || cost < searchCosts[entrance]) {
+      searchStamps[entrance] = currentSearchStamp;
+      searchCosts[entrance] = cost;
+      searchParents[entrance] = parent;
+      queue.push({cost + getHeuristic(entrance), entrance});
+    }
+  };
+  for (int entrance : clusterEntrances[sourceCluster]) {
+    if (sourceDistances[getClusterOffset(entrance)] != UINT_MAX) {
+      relax(entrance, sourceDistances[getClusterOffset(entrance)], -1);
+    }
+  }
+  while (!queue.empty()) {
+    auto [estimate, cell] = queue.top();
+    queue.pop();
+    if (estimate >= best) break;
+    const unsigned long long cost = searchCosts[cell];
+    if (cost + getHeuristic(cell) < estimate) continue;
+    expandedNodes++;
+
+    // Leave through the target cluster.
+    const int cluster = getCluster(cell);
+    if (cluster == targetCluster && targetDistances[getClusterOffset(cell)] != UINT_MAX && cost + targetDistances[getClusterOffset(cell)] < best) {
+      best = cost + targetDistances[getClusterOffset(cell)];
+      bestEntrance = cell;
+    }
+
+    // Move to the other entrances of the cluster.
+    const vector<int>& entrances = clusterEntrances[cluster];
+    const vector<unsigned int>& distances = clusterDistances[cluster];
+    const size_t row = (size_t) cellEntranceIds[cell] * entrances.size();
+    for (size_t j = 0; j < entrances.size(); j++) {
+      if (entrances[j] != cell && distances[row + j] != UINT_MAX) {
+        relax(entrances[j], cost + distances[row + j], cell);
+      }
+    }
+
+    // Step over the borders of the cluster.
+    for (auto offset : offsets) {
+      int neighborX = cell % (int) width + offset[0];
+      int neighborY = cell / (int) width + offset[1];
+      if (neighborX < 0 || neighborY < 0 || neighborX >= (int) width || neighborY >= (int) height || maze[neighborY][neighborX] == WALL_ID) continue;
+      int neighbor = neighborY * (int) width + neighborX;
+      if (getCluster(neighbor) != cluster) {
+        relax(neighbor, cost + 1, cell);
+      }
+    }
+  }
+  if (best == UINT_MAX) return {};
+
+  // Refine the route into cells, searching only inside the clusters it passes through.
+  vector<int> cells;
+  if (bestEntrance == -1) {
+    for (int cell = targetCell; cell != -1; cell = sourceParents[getClusterOffset(cell)]) cells.push_back(cell);
+    reverse(cells.begin(), cells.end());
+  } else {
+    // Collect the entrances of the route.
+    vector<int> route;
+    for (int entrance = bestEntrance; entrance != -1; entrance = searchParents[entrance]) route.push_back(entrance);
+    reverse(route.begin(), route.end());
+
+    // Walk from the source to the first entrance.
+    for (int cell = route[0]; cell != -1; cell = sourceParents[getClusterOffset(cell)]) cells.push_back(cell);
+    reverse(cells.begin(), cells.end());
+
+    // Walk between the consecutive entrances (a single step if they lie in different clusters).
+    vector<unsigned int> distances;
+    vector<int> parents;
+    for (size_t i = 1; i < route.size(); i++) {
+      if (getCluster(route[i - 1]) != getCluster(route[i])) {
+        cells.push_back(route[i]);
+        continue;
+      }
+      expandedNodes += findClusterDistances(maze, route[i - 1], distances, parents, route[i]);
+      size_t legStart = cells.size();
+      for (int cell = route[i]; cell != route[i - 1]; cell = parents[getClusterOffset(cell)]) cells.push_back(cell);
+      reverse(cells.begin() + (long) legStart, cells.end());
+    }
+
+    // Walk from the last entrance to the target.
+    for (int cell = targetParents[getClusterOffset(route.back())]; cell != -1; cell = targetParents[getClusterOffset(cell)]) cells.push_back(cell);
+  }
+
+  // Convert the cell indices to cells.
+  vector<Cell> path;
+  path.reserve(cells.size());
+  for (int cell : cells) {
+    path.emplace_back(cell % (int) width, cell / (int) width);
+  }
+
+  return path;
+}
+
+// Method that returns the cluster of a cell.
+int ClusterGraph::getCluster(int cell) const {
+  return (int) ((cell / (int) width) / clusterSize * clustersX + (cell % (int) width) / clusterSize);
+}
+
+// Method that recomputes the entrances and the distances between them of a cluster.
+void ClusterGraph::buildCluster(const vector<vector<unsigned int>>& maze, int cluster) {
+  const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  const int firstX = (int) ((cluster % clustersX) * clusterSize);
+  const int firstY = (int) ((cluster / clustersX) * clusterSize);
+  const int lastX = min(firstX + (int) clusterSize, (int) width) - 1;
+  const int lastY = min(firstY + (int) clusterSize, (int) height) - 1;
+
+  // Drop the old entrances.
+  vector<int>& entrances = clusterEntrances[cluster];
+  for (int entrance : entrances) {
+    cellEntranceIds[entrance] = -1;
+  }
+  entrances.clear();
+
+  // Every open border cell with an open neighbor in another cluster is an entrance.
+  for (int y = firstY; y <= lastY; y++) {
+    for (int x = firstX; x <= lastX; x++) {
+      if ((x != firstX && x != lastX && y != firstY && y != lastY) || maze[y][x] == WALL_ID) continue;
+      for (auto offset : offsets) {
+        int neighborX = x + offset[0];
+        int neighborY = y + offset[1];
+        if (neighborX < 0 || neighborY < 0 || neighborX >= (int) width || neighborY >= (int) height) continue;
+        if (neighborX >= firstX && neighborX <= lastX && neighborY >= firstY && neighborY <= lastY) continue;
+        if (maze[neighborY][neighborX] != WALL_ID) {
+          cellEntranceIds[y * width + x] = (int) entrances.size();
+          entrances.push_back(y * (int) width + x);
+          break;
+        }
+      }
+    }
+  }
+
+  // Find the in-cluster distances between each pair of entrances.
+  const size_t entrancesQuantity = entrances.size();
+  vector<unsigned int>& clusterDistanceMatrix = clusterDistances[cluster];
+  clusterDistanceMatrix.assign(entrancesQuantity * entrancesQuantity, UINT_MAX);
+  vector<unsigned int> distances;
+  vector<int> parents;
+  for (size_t i = 0; i < entrancesQuantity; i++) {
+    findClusterDistances(maze, entrances[i], distances, parents);
+    for (size_t j = 0; j < entrancesQuantity; j++) {
+      clusterDistanceMatrix[i * entrancesQuantity + j] = distances[getClusterOffset(entrances[j])];
+    }
+  }
+}
+
+// Method that runs BFS from a cell without leaving its cluster (stops early once the target cell is reached, if given).
+unsigned long long ClusterGraph::findClusterDistances(const vector<vector<unsigned int>>& maze, int sourceCell, vector<unsigned int>& distances, vector<int>& parents, int targetCell) const {
+  const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  const int cluster = getCluster(sourceCell);
+  const int firstX = (int) ((cluster % clustersX) * clusterSize);
+  const int firstY = (int) ((cluster / clustersX) * clusterSize);
+  const int lastX = min(firstX + (int) clusterSize, (int) width) - 1;
+  const int lastY = min(firstY + (int) clusterSize, (int) height) - 1;
+  distances.assign(clusterSize * clusterSize, UINT_MAX);
+  parents.assign(clusterSize * clusterSize, -1);
+
+  // Run BFS over the open cells of the cluster.
+  vector<int> queue = {sourceCell};
+  queue.reserve(clusterSize * clusterSize);
+  distances[getClusterOffset(sourceCell)] = 0;
+  unsigned long long expandedNodes = 0;
+  for (size_t head = 0; head < queue.size(); head++) {
+    const int cell = queue[head];
+    expandedNodes++;
+    if (cell == targetCell) break;
+    const unsigned int distance = distances[getClusterOffset(cell)];
+    for (auto offset : offsets) {
+      int neighborX = cell % (int) width + offset[0];
+      int neighborY = cell / (int) width + offset[1];
+      if (neighborX < firstX || neighborY < firstY || neighborX > lastX || neighborY > lastY || maze[neighborY][neighborX] == WALL_ID) continue;
+      int neighbor = neighborY * (int) width + neighborX;
+      if (distances[getClusterOffset(neighbor)] != UINT_MAX) continue;
+      distances[getClusterOffset(neighbor)] = distance + 1;
+      parents[getClusterOffset(neighbor)] = cell;
+      queue.push_back(neighbor);
+    }
+  }
+
+  return expandedNodes;
+}
+
+// Method that returns the position of a cell inside its cluster.
+int ClusterGraph::getClusterOffset(int cell) const {
+  return (int) (((cell / (int) width) % clusterSize) * clusterSize + (cell % (int) width) % clusterSize);
+}
@@ -0,0 +1,69 @@
+#ifndef CLUSTER_GRAPH_H
+#define CLUSTER_GRAPH_H
+
+#include <vector>
+#include <queue>
+#include <climits>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include "../cell/cell.h"
+#include "../../models/models.h"
+
+using namespace std;
+
+// Structure that represents the abstract graph of a hierarchical (HPA*-style) pathfinder.
+// The grid is partitioned into square clusters. Every open cell with an open neighbor in another cluster becomes an entrance node,
+// the entrances of a cluster are connected by their precomputed in-cluster distances, and neighboring entrances of two clusters
+// are connected by a single step. Since every border crossing is an entrance, the distances on the abstract graph are exact.
+// Queries search the abstract graph and then refine only the clusters the chosen route passes through.
+struct ClusterGraph {
+  // Dimensions of the maze the graph was built for and the side of a cluster.
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int clusterSize = 0;
+
+  // The number of clusters along each axis.
+  unsigned int clustersX = 0;
+  unsigned int clustersY = 0;
+
+  // The cell indices of the entrances of each cluster.
+  vector<vector<int>> clusterEntrances;
+
+  // The in-cluster distances between each pair of entrances of each cluster (row-major, UINT_MAX if not connected inside the cluster).
+  vector<vector<unsigned int>> clusterDistances;
+
+  // The index of each cell among the entrances of its cluster (-1 if the cell is not an entrance).
+  vector<int> cellEntranceIds;
+
+  // Reusable per-cell buffers of the abstract search (an entry is valid only if its stamp matches the current search).
+  vector<unsigned int> searchStamps;
+  vector<unsigned long long> searchCosts;
+  vector<int> searchParents;
+  unsigned int currentSearchStamp = 0;
+
+  // Constructors.
+  ClusterGraph() = default;
+  ClusterGraph(const vector<vector<unsigned int>>& maze, unsigned int _clusterSize);
+
+  // Method that recomputes the clusters affected by a change of the given cell (its own cluster and the clusters across its borders).
+  void updateCell(const vector<vector<unsigned int>>& maze, int x, int y);
+
+  // Method that returns the shortest path between two cells (empty if there is none) and counts the expanded cells and nodes.
+  vector<Cell> getPath(const vector<vector<unsigned int>>& maze, int sourceCell, int targetCell, unsigned long long& expandedNodes);
+
+  // Method that returns the cluster of a cell.
+  int getCluster(int cell) const;
+
+  // Method that recomputes the entrances and the distances between them of a cluster.
+  void buildCluster(const vector<vector<unsigned int>>& maze, int cluster);
+
+  // Method that runs BFS from a cell without leaving its cluster (stops early once the target cell is reached, if given).
+  // The distances and the parent cells are indexed by the position of the cell inside the cluster. Returns the number of cells expanded.
+  unsigned long long findClusterDistances(const vector<vector<unsigned int>>& maze, int sourceCell, vector<unsigned int>& distances, vector<int>& parents, int targetCell = -1) const;
+
+  // Method that returns the position of a cell inside its cluster.
+  int getClusterOffset(int cell) const;
+};
+
+#endif
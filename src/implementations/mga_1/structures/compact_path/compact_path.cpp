@@ -0,0 +1,146 @@
+#include "compact_path.h"
+
+// Constructors.
+CompactPath::CompactPath(unsigned int _width, int _startCell) : width(_width), startCell(_startCell), endCell(_startCell) {}
+
+CompactPath::CompactPath(const vector<Cell>& cells, unsigned int _width) : width(_width) {
+  if (cells.empty()) return;
+  startCell = endCell = cells[0].y * (int) width + cells[0].x;
+
+  // Encode the direction of each step between the consecutive cells.
+  for (size_t i = 1; i < cells.size(); i++) {
+    int dx = cells[i].x - cells[i - 1].x;
+    int dy = cells[i].y - cells[i - 1].y;
+    addSteps(dy < 0 ? 0 : dy > 0 ? 1 : dx < 0 ? 2 : 3);
+  }
+}
+
+CompactPath::CompactPath(const View& view) : CompactPath(view.path->width, view.isReversed ? view.path->endCell : view.path->startCell) {
+  appendSteps(*view.path, 0, view.path->length, view.isReversed);
+}
+
+// Method that appends a number of steps in the given direction.
+void CompactPath::addSteps(unsigned int direction, unsigned int count) {
+  length += count;
+  endCell += getOffset(direction) * (int) count;
+
+  // Extend the last run if it goes the same way and split the rest into runs of at most 64 steps.
+  if (!runs.empty() && (runs.back() & 3u) == direction && (runs.back() >> 2) < 63) {
+    unsigned int extension = min(count, 63u - (runs.back() >> 2));
+    runs.back() += (uint8_t) (extension << 2);
+    count -= extension;
+  }
+  while (count > 0) {
+    unsigned int run = min(count, 64u);
+    runs.push_back((uint8_t) (((run - 1) << 2) | direction));
+    count -= run;
+  }
+}
+
+// Method that appends the steps [firstStep, lastStep) of another path, walked forwards or backwards.
+void CompactPath::appendSteps(const CompactPath& other, unsigned int firstStep, unsigned int lastStep, bool isReversed) {
+  if (firstStep >= lastStep) return;
+
+  // Step k of the reversed path is step (length - 1 - k) of the path, taken in the opposite direction.
+  unsigned int first = isReversed ? other.length - lastStep : firstStep;
+  unsigned int last = isReversed ? other.length - firstStep : lastStep;
+
+  // Collect the overlap of each run with the range, in the walking order.
+  vector<pair<unsigned int, unsigned int>> overlaps;
+  unsigned int position = 0;
+  for (uint8_t run : other.runs) {
+    unsigned int runEnd = position + (run >> 2) + 1;
+    if (runEnd > first && position < last) {
+      overlaps.emplace_back(run & 3u, min(runEnd, last) - max(position, first));
+    }
+    if (runEnd >= last) break;
+    position = runEnd;
+  }
+  if (isReversed) {
+    for (auto it = overlaps.rbegin(); it != overlaps.rend(); it++) {
+      addSteps(it->first ^ 1u, it->second);
+    }
+  } else {
+    for (auto [direction, count] : overlaps) {
+      addSteps(direction, count);
+    }
+  }
+}
+
+// Methods that return the iterators to the first and past the last cell.
+CompactPath::Iterator CompactPath::begin() const {
+  return View{this, false}.begin();
+}
+
+CompactPath::Iterator CompactPath::end() const {
+  return View{this, false}.end();
+}
+
+// Method that returns a view of the path walked from the last cell to the first one (does not copy the path).
+CompactPath::View CompactPath::reversed() const {
+  return {this, true};
+}
+
+// Method that checks whether the path has no cells.
+bool CompactPath::empty() const {
+  return startCell == -1;
+}
+
+// Method that decodes the path into cells.
+vector<Cell> CompactPath::toCells() const {
+  vector<Cell> cells;
+  if (empty()) return cells;
+  cells.reserve(length + 1);
+  for (Cell cell : *this) {
+    cells.push_back(cell);
+  }
+  return cells;
+}
+
+// Method that returns the cell index offset of a direction.
+int CompactPath::getOffset(unsigned int direction) const {
+  const int offsets[4] = {-(int) width, (int) width, -1, 1};
+  return offsets[direction];
+}
+
+// Methods that return the iterators to the first and past the last cell of the view.
+CompactPath::Iterator CompactPath::View::begin() const {
+  return {path, isReversed, isReversed ? path->runs.size() - 1 : 0, 0, 0, isReversed ? path->endCell : path->startCell};
+}
+
+CompactPath::Iterator CompactPath::View::end() const {
+  return {path, isReversed, 0, 0, path->empty() ? 0 : path->length + 1, -1};
+}
+
+// Method that returns the current cell.
+Cell CompactPath::Iterator::operator*() const {
+  return {cell % (int) path->width, cell / (int) path->width};
+}
+
+// Method that moves to the next cell.
+CompactPath::Iterator& CompactPath::Iterator::operator++() {
+  position++;
+  if (position > path->length) return *this;
+
+  // Take a step of the current run and move to the next run once it is exhausted.
+  uint8_t currentRun = path->runs[run];
+  cell += path->getOffset(isReversed ? (currentRun & 3u) ^ 1u : currentRun & 3u);
+  if (++runStep > (unsigned int) (currentRun >> 2)) {
+    runStep = 0;
+    if (isReversed) {
+      run--;
+    } else {
+      run++;
+    }
+  }
+  return *this;
+}
+
+// Overload of the == and != operators (iterators of the same path are compared by position).
+bool CompactPath::Iterator::operator==(const Iterator& iterator) const {
+  return position == iterator.position;
+}
+
+bool CompactPath::Iterator::operator!=(const Iterator& iterator) const {
+  return position != iterator.position;
+}
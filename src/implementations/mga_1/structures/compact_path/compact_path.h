@@ -0,0 +1,88 @@
+#ifndef COMPACT_PATH_H
+#define COMPACT_PATH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "../cell/cell.h"
+
+using namespace std;
+
+// Structure that represents a path as its first cell and the 2-bit direction codes (indices into NEIGHBOR_OFFSETS) of its steps.
+// Consecutive steps in the same direction are run-length encoded: each byte holds the direction in its lower 2 bits and
+// the run length minus one in its upper 6 bits, so a straight corridor of up to 64 steps takes a single byte.
+struct CompactPath {
+  // Width of the maze the cell indices refer to.
+  unsigned int width = 0;
+
+  // The cell indices of the first and the last cell.
+  int startCell = -1;
+  int endCell = -1;
+
+  // The number of steps from the first to the last cell.
+  unsigned int length = 0;
+
+  // The direction runs.
+  vector<uint8_t> runs;
+
+  // Structure that decodes the cells of the path on the fly, forwards or backwards.
+  struct Iterator {
+    const CompactPath* path;
+    bool isReversed;
+    size_t run;
+    unsigned int runStep;
+    unsigned int position;
+    int cell;
+
+    // Method that returns the current cell.
+    Cell operator*() const;
+
+    // Method that moves to the next cell.
+    Iterator& operator++();
+
+    // Overload of the == and != operators (iterators of the same path are compared by position).
+    bool operator==(const Iterator& iterator) const;
+    bool operator!=(const Iterator& iterator) const;
+  };
+
+  // Structure that represents a view of the path in either direction.
+  struct View {
+    const CompactPath* path;
+    bool isReversed;
+
+    // Methods that return the iterators to the first and past the last cell of the view.
+    Iterator begin() const;
+    Iterator end() const;
+  };
+
+  // Constructors.
+  CompactPath() = default;
+  CompactPath(unsigned int _width, int _startCell);
+  CompactPath(const vector<Cell>& cells, unsigned int _width);
+  explicit CompactPath(const View& view);
+
+  // Method that appends a number of steps in the given direction.
+  void addSteps(unsigned int direction, unsigned int count = 1);
+
+  // Method that appends the steps [firstStep, lastStep) of another path, walked forwards or backwards.
+  void appendSteps(const CompactPath& other, unsigned int firstStep, unsigned int lastStep, bool isReversed = false);
+
+  // Methods that return the iterators to the first and past the last cell.
+  Iterator begin() const;
+  Iterator end() const;
+
+  // Method that returns a view of the path walked from the last cell to the first one (does not copy the path).
+  View reversed() const;
+
+  // Method that checks whether the path has no cells.
+  bool empty() const;
+
+  // Method that decodes the path into cells.
+  vector<Cell> toCells() const;
+
+  // Method that returns the cell index offset of a direction.
+  int getOffset(unsigned int direction) const;
+};
+
+#endif
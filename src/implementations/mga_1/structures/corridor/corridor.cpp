@@ -0,0 +1,4 @@
+#include "corridor.h"
+
+// Constructor.
+Corridor::Corridor(int _from, int _to, int startCell, unsigned int width) : from(_from), to(_to), path(width, startCell) {}
@@ -0,0 +1,22 @@
+#ifndef CORRIDOR_H
+#define CORRIDOR_H
+
+#include "../compact_path/compact_path.h"
+
+using namespace std;
+
+// Structure that represents a corridor (a chain of degree-2 cells) between two junction graph nodes.
+// The cells are not stored explicitly: the corridor keeps its walk from the "from" node to the "to" node as a compact path.
+struct Corridor {
+  // The nodes at both ends of the corridor.
+  int from;
+  int to;
+
+  // The walk from the cell of the "from" node to the cell of the "to" node.
+  CompactPath path;
+
+  // Constructor.
+  Corridor(int _from, int _to, int startCell, unsigned int width);
+};
+
+#endif
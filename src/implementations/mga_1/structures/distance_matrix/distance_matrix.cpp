@@ -0,0 +1,123 @@
+#include "distance_matrix.h"
+
+// Constructors.
+DistanceMatrix::DistanceMatrix(unsigned int _size, unsigned long long maxDistance) : size(_size) {
+  // Use 16-bit storage if the largest distance and the unreachable marker both fit.
+  isCompact = maxDistance < UINT16_MAX;
+  size_t pairs = (size_t) size * (size - (size > 0)) / 2;
+  if (isCompact) {
+    compactDistances.assign(pairs, 0);
+  } else {
+    distances.assign(pairs, 0);
+  }
+}
+
+DistanceMatrix::DistanceMatrix(unsigned int _size, function<void(unsigned int, vector<unsigned int>&)> _rowProvider, size_t _cacheCapacity)
+    : size(_size), rowProvider(std::move(_rowProvider)), cacheCapacity(_cacheCapacity > 0 ? _cacheCapacity : 1) {}
+
+// Method that returns the distance between two checkpoints.
+unsigned int DistanceMatrix::get(unsigned int i, unsigned int j) const {
+  if (i == j) return 0;
+  if (isOnDemand()) return getRow(i)[j];
+  if (i > j) swap(i, j);
+  if (isCompact) {
+    uint16_t distance = compactDistances[getTriangleIndex(i, j)];
+    return distance == UINT16_MAX ? UNREACHABLE : distance;
+  }
+  return distances[getTriangleIndex(i, j)];
+}
+
+// Method that sets the distance between two checkpoints (not safe while other threads read the matrix).
+void DistanceMatrix::set(unsigned int i, unsigned int j, unsigned int distance) {
+  if (i == j) return;
+  if (i > j) swap(i, j);
+  if (isOnDemand()) {
+    overrides[i][j] = distance;
+    overrides[j][i] = distance;
+  } else if (isCompact) {
+    compactDistances[getTriangleIndex(i, j)] = (uint16_t) min(distance, (unsigned int) UINT16_MAX);
+  } else {
+    distances[getTriangleIndex(i, j)] = distance;
+  }
+
+  // The cached rows may hold the old distance.
+  version = getNextVersion();
+}
+
+// Method that drops the cached rows and the overrides (after the distances the rows are computed from have changed).
+void DistanceMatrix::invalidate() {
+  version = getNextVersion();
+  overrides.clear();
+}
+
+// Method that returns the distances from a checkpoint to all the checkpoints as a contiguous row.
+const vector<unsigned int>& DistanceMatrix::getRow(unsigned int i) const {
+  RowCache& cache = getThreadCache();
+
+  // Move a cached row to the front.
+  auto cached = cache.index.find(i);
+  if (cached != cache.index.end()) {
+    cache.rows.splice(cache.rows.begin(), cache.rows, cached->second);
+    return cached->second->second;
+  }
+
+  // Evict the least recently used row if the cache is full.
+  if (cache.rows.size() >= cacheCapacity) {
+    cache.index.erase(cache.rows.back().first);
+    cache.rows.pop_back();
+  }
+
+  // Compute (applying the overrides) or unpack the row.
+  cache.rows.emplace_front(i, vector<unsigned int>(size, 0));
+  vector<unsigned int>& row = cache.rows.front().second;
+  if (isOnDemand()) {
+    rowProvider(i, row);
+    auto rowOverrides = overrides.find(i);
+    if (rowOverrides != overrides.end()) {
+      for (const auto& [j, distance] : rowOverrides->second) {
+        row[j] = distance;
+      }
+    }
+  } else {
+    for (unsigned int j = 0; j < size; j++) {
+      row[j] = get(i, j);
+    }
+  }
+  cache.index[i] = cache.rows.begin();
+
+  return row;
+}
+
+// Method that returns the row cache of the calling thread for the current version of the matrix.
+DistanceMatrix::RowCache& DistanceMatrix::getThreadCache() const {
+  // The caches of the thread, from the most to the least recently used one.
+  static thread_local list<RowCache> threadCaches;
+
+  // Move the cache of this version to the front, or reuse the least recently used cache for it.
+  auto cache = find_if(threadCaches.begin(), threadCaches.end(), [this](const RowCache& threadCache) { return threadCache.version == version; });
+  if (cache == threadCaches.end()) {
+    if (threadCaches.size() < THREAD_CACHES_COUNT) threadCaches.emplace_back();
+    cache = prev(threadCaches.end());
+    cache->version = version;
+    cache->rows.clear();
+    cache->index.clear();
+  }
+  threadCaches.splice(threadCaches.begin(), threadCaches, cache);
+  return threadCaches.front();
+}
+
+// Method that checks whether the rows are computed on demand.
+bool DistanceMatrix::isOnDemand() const {
+  return (bool) rowProvider;
+}
+
+// Method that returns the position of a pair (i < j) in the upper triangle.
+size_t DistanceMatrix::getTriangleIndex(unsigned int i, unsigned int j) const {
+  return (size_t) i * (2 * (size_t) size - i - 1) / 2 + (j - i - 1);
+}
+
+// Method that returns a version no matrix has had yet.
+uint64_t DistanceMatrix::getNextVersion() {
+  static atomic<uint64_t> nextVersion{1};
+  return nextVersion++;
+}
@@ -0,0 +1,86 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// Structure that represents the symmetric matrix of the distances between the checkpoints.
+// The distances are stored either as the upper triangle in 16-bit or 32-bit integers (whichever fits the largest possible distance),
+// or not stored at all and computed one row at a time on demand, with the most recently used rows kept in a bounded cache.
+// Every thread that reads rows keeps the caches of the last THREAD_CACHES_COUNT matrices it read in thread-local storage, so the reads
+// take no lock, a row a thread holds is only evicted by its own later reads, and the caches are freed when the thread (or its pool) ends.
+// Each cache belongs to a version of a matrix: setting a distance or invalidating the rows gives the matrix a new version, so the rows
+// cached before it are never read again. The distances set on an on-demand matrix are kept as overrides and applied to the rows computed after them.
+// UNREACHABLE marks the pairs without a path between them.
+struct DistanceMatrix {
+  static constexpr unsigned int UNREACHABLE = UINT_MAX;
+
+  // The number of matrices each thread keeps the rows of.
+  static constexpr size_t THREAD_CACHES_COUNT = 2;
+
+  // The number of checkpoints.
+  unsigned int size = 0;
+
+  // The stored upper triangle (only one of the two is used).
+  bool isCompact = false;
+  vector<uint16_t> compactDistances;
+  vector<uint32_t> distances;
+
+  // The function that computes a whole row (set only for the on-demand matrices) and the number of rows to cache.
+  function<void(unsigned int, vector<unsigned int>&)> rowProvider;
+  size_t cacheCapacity = 1;
+
+  // Structure that represents the rows cached by a thread for a version of a matrix, in the order of their use, from the most to the least recent one.
+  struct RowCache {
+    uint64_t version = 0;
+    list<pair<unsigned int, vector<unsigned int>>> rows;
+    unordered_map<unsigned int, list<pair<unsigned int, vector<unsigned int>>>::iterator> index;
+  };
+
+  // The version of the matrix, unique among all the matrices (a copy shares the version, and so the cached rows, until either of them changes).
+  uint64_t version = getNextVersion();
+
+  // The distances set on an on-demand matrix, by both of their checkpoints.
+  unordered_map<unsigned int, unordered_map<unsigned int, unsigned int>> overrides;
+
+  // Constructors.
+  DistanceMatrix() = default;
+  DistanceMatrix(unsigned int _size, unsigned long long maxDistance);
+  DistanceMatrix(unsigned int _size, function<void(unsigned int, vector<unsigned int>&)> _rowProvider, size_t _cacheCapacity);
+
+  // Method that returns the distance between two checkpoints.
+  unsigned int get(unsigned int i, unsigned int j) const;
+
+  // Method that sets the distance between two checkpoints (not safe while other threads read the matrix).
+  void set(unsigned int i, unsigned int j, unsigned int distance);
+
+  // Method that drops the cached rows and the overrides (after the distances the rows are computed from have changed).
+  void invalidate();
+
+  // Method that returns the distances from a checkpoint to all the checkpoints as a contiguous row.
+  // The row stays valid until the same thread reads enough other rows to evict it from its cache.
+  const vector<unsigned int>& getRow(unsigned int i) const;
+
+  // Method that returns the row cache of the calling thread for the current version of the matrix.
+  RowCache& getThreadCache() const;
+
+  // Method that checks whether the rows are computed on demand.
+  bool isOnDemand() const;
+
+  // Method that returns the position of a pair (i < j) in the upper triangle.
+  size_t getTriangleIndex(unsigned int i, unsigned int j) const;
+
+  // Method that returns a version no matrix has had yet.
+  static uint64_t getNextVersion();
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "distance_oracle.h"
+
+// Constructor.
+DistanceOracle::DistanceOracle(const vector<vector<unsigned int>>& maze) {
+  height = maze.size();
+  width = height > 0 ? maze[0].size() : 0;
+  parent.assign(width * height, -1);
+  depth.assign(width * height, 0);
+  order.assign(width * height, 0);
+
+  // Count the open cells and the edges between them, and find the root.
+  int root = -1;
+  unsigned int openCellsCount = 0;
+  unsigned long long edgesCount = 0;
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < width; x++) {
+      if (maze[y][x] == WALL_ID) continue;
+      if (root == -1) root = (int) (y * width + x);
+      openCellsCount++;
+      if (x + 1 < width && maze[y][x + 1] != WALL_ID) edgesCount++;
+      if (y + 1 < height && maze[y + 1][x] != WALL_ID) edgesCount++;
+    }
+  }
+
+  // A tree has exactly one edge less than vertices (connectivity is checked by the traversal below).
+  if (root == -1 || edgesCount != openCellsCount - 1) {
+    return;
+  }
+
+  // Traverse the tree iteratively in DFS order.
+  vector<int> dfsCells;
+  dfsCells.reserve(openCellsCount);
+  vector<int> stack = {root};
+  while (!stack.empty()) {
+    int current = stack.back();
+    stack.pop_back();
+    order[current] = dfsCells.size();
+    dfsCells.push_back(current);
+
+    int x = current % (int) width;
+    int y = current / (int) width;
+    const int neighbors[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+    for (const auto& neighbor : neighbors) {
+      if (neighbor[0] < 0 || neighbor[1] < 0 || neighbor[0] >= (int) width || neighbor[1] >= (int) height) continue;
+      if (maze[neighbor[1]][neighbor[0]] == WALL_ID) continue;
+      int next = neighbor[1] * (int) width + neighbor[0];
+      if (next == parent[current]) continue;
+      parent[next] = current;
+      depth[next] = depth[current] + 1;
+      stack.push_back(next);
+    }
+  }
+
+  // Check that all open cells are connected.
+  if (dfsCells.size() != openCellsCount) {
+    return;
+  }
+
+  // Build the sparse table (level k covers ranges of length 2^k).
+  sparseTable.push_back(dfsCells);
+  for (unsigned int length = 2; length <= dfsCells.size(); length *= 2) {
+    const vector<int>& previous = sparseTable.back();
+    vector<int> level(dfsCells.size() - length + 1);
+    for (unsigned int i = 0; i < level.size(); i++) {
+      int left = previous[i];
+      int right = previous[i + length / 2];
+      level[i] = depth[left] <= depth[right] ? left : right;
+    }
+    sparseTable.push_back(std::move(level));
+  }
+
+  isTree = true;
+}
+
+// Method that returns the index of the lowest common ancestor of two cells.
+int DistanceOracle::getLowestCommonAncestor(int a, int b) const {
+  if (a == b) return a;
+
+  // The LCA is the parent of the shallowest cell in the DFS order range (order[a], order[b]].
+  unsigned int left = min(order[a], order[b]) + 1;
+  unsigned int right = max(order[a], order[b]);
+  unsigned int level = 31 - __builtin_clz(right - left + 1);
+  int first = sparseTable[level][left];
+  int second = sparseTable[level][right - (1u << level) + 1];
+  return parent[depth[first] <= depth[second] ? first : second];
+}
+
+// Method that returns the distance between two cells.
+unsigned int DistanceOracle::getDistance(Cell a, Cell b) const {
+  int indexA = a.y * (int) width + a.x;
+  int indexB = b.y * (int) width + b.x;
+  return depth[indexA] + depth[indexB] - 2 * depth[getLowestCommonAncestor(indexA, indexB)];
+}
+
+// Method that returns the indexes of the open cells in the DFS order of the tree (every cell after its parent).
+const vector<int>& DistanceOracle::getCellsInDfsOrder() const {
+  // The first level of the sparse table is the DFS order itself.
+  static const vector<int> noCells;
+  return sparseTable.empty() ? noCells : sparseTable[0];
+}
+
+// Method that returns the path between two cells (both cells included).
+vector<Cell> DistanceOracle::getPath(Cell a, Cell b) const {
+  int current = a.y * (int) width + a.x;
+  int other = b.y * (int) width + b.x;
+  int lca = getLowestCommonAncestor(current, other);
+
+  // Climb from the first cell up to the LCA.
+  vector<Cell> path;
+  path.reserve(depth[current] + depth[other] - 2 * depth[lca] + 1);
+  while (current != lca) {
+    path.emplace_back(current % (int) width, current / (int) width);
+    current = parent[current];
+  }
+  path.emplace_back(lca % (int) width, lca / (int) width);
+
+  // Climb from the second cell up to the LCA and append that part reversed.
+  size_t middle = path.size();
+  while (other != lca) {
+    path.emplace_back(other % (int) width, other / (int) width);
+    other = parent[other];
+  }
+  reverse(path.begin() + (long) middle, path.end());
+
+  return path;
+}
@@ -0,0 +1,47 @@
+#ifndef DISTANCE_ORACLE_H
+#define DISTANCE_ORACLE_H
+
+#include <vector>
+#include <algorithm>
+#include "../cell/cell.h"
+#include "../../models/models.h"
+
+using namespace std;
+
+// Structure that answers distance and path queries on a perfect maze (the open cells form a tree).
+// The distance between two cells is depth(a) + depth(b) - 2 * depth(lca(a, b)), where the lowest common ancestor
+// is found in O(1) with a sparse table built over the DFS order of the tree.
+struct DistanceOracle {
+  // Dimensions of the maze the oracle was built for.
+  unsigned int width = 0;
+  unsigned int height = 0;
+
+  // Whether the open cells of the maze form a single tree, i.e. the oracle can be used.
+  bool isTree = false;
+
+  // Parent cell index, depth and DFS order index of each cell (indexed by y * width + x).
+  vector<int> parent;
+  vector<unsigned int> depth;
+  vector<unsigned int> order;
+
+  // Sparse table over the DFS order, each level stores the cell index with the minimum depth of the range.
+  vector<vector<int>> sparseTable;
+
+  // Constructors.
+  DistanceOracle() = default;
+  explicit DistanceOracle(const vector<vector<unsigned int>>& maze);
+
+  // Method that returns the index of the lowest common ancestor of two cells.
+  int getLowestCommonAncestor(int a, int b) const;
+
+  // Method that returns the distance between two cells.
+  unsigned int getDistance(Cell a, Cell b) const;
+
+  // Method that returns the path between two cells (both cells included).
+  vector<Cell> getPath(Cell a, Cell b) const;
+
+  // Method that returns the indexes of the open cells in the DFS order of the tree (every cell after its parent).
+  const vector<int>& getCellsInDfsOrder() const;
+};
+
+#endif
@@ -0,0 +1,481 @@
+#include "held_karp.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HELD_KARP_AVX2_KERNEL
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HELD_KARP_MAPPED_TABLE
+#endif
+
+// Constructor.
+HeldKarp::HeldKarp(const DistanceMatrix& matrix, bool _isOpen, bool _isStartFixed) : isOpen(_isOpen), isStartFixed(_isOpen && _isStartFixed) {
+  size = matrix.size + (isOpen && !isStartFixed && matrix.size > 0);
+  nodes = size > 0 ? size - 1 : 0;
+
+  // Copy the distances into a dense row-major matrix (after the virtual start, if any) and find the longest one.
+  const unsigned int shift = isOpen && !isStartFixed ? 1 : 0;
+  distances.assign((size_t) size * size, 0);
+  unsigned long long maxDistance = 0;
+  for (unsigned int i = 0; i < matrix.size; i++) {
+    for (unsigned int j = 0; j < matrix.size; j++) {
+      unsigned int distance = matrix.get(i, j);
+      distances[(size_t) (i + shift) * size + j + shift] = distance == DistanceMatrix::UNREACHABLE ? UINT32_MAX : distance;
+      if (distance != DistanceMatrix::UNREACHABLE) maxDistance = max(maxDistance, (unsigned long long) distance);
+    }
+  }
+
+  // A path from a fixed start ends anywhere, so the cycle returns to the start for free.
+  if (isStartFixed) {
+    for (unsigned int i = 0; i < size; i++) distances[(size_t) i * size] = 0;
+  }
+
+  // A walk has at most one edge per checkpoint, so 16 bits suffice if that many longest edges fit (leaving the maximum as the infinity).
+  isCompact = maxDistance * size < UINT16_MAX;
+  isVectorized = isVectorKernelSupported();
+
+  // Compute the binomial coefficients.
+  binomials.assign(nodes + 1, vector<unsigned long long>(nodes + 1, 0));
+  for (unsigned int n = 0; n <= nodes; n++) {
+    binomials[n][0] = 1;
+    for (unsigned int k = 1; k <= n; k++) {
+      binomials[n][k] = binomials[n - 1][k - 1] + (k < n ? binomials[n - 1][k] : 0);
+    }
+  }
+
+  // Compute the first row of each layer (for the layer-ordered table).
+  layerOffsets.assign(nodes + 2, 0);
+  for (unsigned int subsetSize = 0; subsetSize <= nodes; subsetSize++) {
+    layerOffsets[subsetSize + 1] = layerOffsets[subsetSize] + binomials[nodes][subsetSize];
+  }
+}
+
+// Destructor.
+HeldKarp::~HeldKarp() {
+#ifdef HELD_KARP_MAPPED_TABLE
+  if (mappedTable != nullptr) munmap(mappedTable, mappedBytes);
+#endif
+}
+
+// Method that keeps the table in the given file, resuming the run stored in it if it solves the same problem.
+bool HeldKarp::mapTable(const string& filePath) {
+#ifdef HELD_KARP_MAPPED_TABLE
+  const size_t bytes = MAPPED_HEADER_BYTES + getTableBytes();
+  const int file = open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+  if (file == -1) return false;
+
+  // Resume only from a file of the same size that holds the table of the same problem.
+  MappedTableHeader header{};
+  struct stat fileStat{};
+  const bool isResumed = fstat(file, &fileStat) == 0 && (size_t) fileStat.st_size == bytes
+      && pread(file, &header, sizeof(header), 0) == (ssize_t) sizeof(header)
+      && header.magic == MAPPED_TABLE_MAGIC && header.fingerprint == getFingerprint();
+
+  // Otherwise, start a new table (the rows are written in full as they are filled, so the file is not initialized).
+  if (!isResumed) {
+    header = {MAPPED_TABLE_MAGIC, getFingerprint(), 0};
+    bool isCreated = ftruncate(file, 0) == 0 && ftruncate(file, (off_t) bytes) == 0
+        && pwrite(file, &header, sizeof(header), 0) == (ssize_t) sizeof(header);
+#ifdef __linux__
+    // Reserve the disk space up front, so that a full disk fails here rather than on a write to the mapping.
+    isCreated = isCreated && posix_fallocate(file, 0, (off_t) bytes) == 0;
+#endif
+    if (!isCreated) {
+      close(file);
+      unlink(filePath.c_str());
+      return false;
+    }
+  }
+
+  // Map the file (the mapping stays valid after the file is closed). A new file that cannot be mapped is removed, since it holds no layers.
+  void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED) {
+    if (!isResumed) unlink(filePath.c_str());
+    return false;
+  }
+
+  mappedTable = mapping;
+  mappedBytes = bytes;
+  resumedLayers = header.completedLayers;
+  isLayerOrdered = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Method that fills the table (in parallel if a thread pool is given) until it is complete or the context stops it.
+void HeldKarp::solve(ThreadPool* pool, SolverContext* _context) {
+  context = _context;
+  if (mappedTable != nullptr) {
+    if (isCompact) {
+      fillMappedTable((uint16_t*) ((char*) mappedTable + MAPPED_HEADER_BYTES), pool);
+    } else {
+      fillMappedTable((uint32_t*) ((char*) mappedTable + MAPPED_HEADER_BYTES), pool);
+    }
+  } else if (isCompact) {
+    fillTable(compactLengths, pool);
+  } else {
+    fillTable(lengths, pool);
+  }
+
+  // A complete table gives the shortest route.
+  if (context != nullptr && !isInterrupted) {
+    const unsigned long long length = getLength();
+    if (length != ULLONG_MAX) {
+      context->offerOrder(getOrder(), length, "Held-Karp");
+      context->offerLowerBound(length, "Held-Karp (optimal)");
+    }
+  }
+}
+
+// Method that returns the checkpoint IDs of the shortest cycle, starting from checkpoint 0 (empty if there is no cycle).
+vector<unsigned int> HeldKarp::getOrder() const {
+  if (size == 0) return {};
+  vector<unsigned int> order;
+  if (nodes == 0) {
+    order = {0};
+  } else if (isCompact) {
+    order = reconstructOrder(mappedTable != nullptr ? (const uint16_t*) ((const char*) mappedTable + MAPPED_HEADER_BYTES) : compactLengths.data());
+  } else {
+    order = reconstructOrder(mappedTable != nullptr ? (const uint32_t*) ((const char*) mappedTable + MAPPED_HEADER_BYTES) : lengths.data());
+  }
+
+  // Drop the virtual start.
+  if (isOpen && !isStartFixed && !order.empty()) {
+    order.erase(order.begin());
+    for (unsigned int& checkpointId : order) checkpointId--;
+  }
+
+  return order;
+}
+
+// Method that returns the length of the shortest cycle (of the path, if it is open), or ULLONG_MAX if there is none.
+unsigned long long HeldKarp::getLength() const {
+  const vector<unsigned int> order = getOrder();
+  if (order.empty()) return ULLONG_MAX;
+
+  // Sum the edges of the order (shifted past the virtual start, if any).
+  const unsigned int shift = isOpen && !isStartFixed ? 1 : 0;
+  unsigned long long length = 0;
+  for (size_t i = 0; i + 1 < order.size(); i++) {
+    length += getDistance(order[i] + shift, order[i + 1] + shift);
+  }
+  if (!isOpen && order.size() > 1) length += getDistance(order.back(), order[0]);
+  return length;
+}
+
+// Method that returns the number of bytes taken by the table.
+unsigned long long HeldKarp::getTableBytes() const {
+  return ((unsigned long long) 1 << nodes) * nodes * (isCompact ? sizeof(uint16_t) : sizeof(uint32_t));
+}
+
+// Method that returns a hash of the problem, which identifies its table file.
+uint64_t HeldKarp::getFingerprint() const {
+  // FNV-1a over the shape of the problem, the type of the table and the distances.
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  auto addWord = [&hash](uint64_t word) {
+    for (unsigned int byte = 0; byte < 8; byte++) {
+      hash = (hash ^ ((word >> (byte * 8)) & 0xFF)) * 0x100000001B3ULL;
+    }
+  };
+  addWord(size);
+  addWord(isOpen);
+  addWord(isStartFixed);
+  addWord(isCompact);
+  for (uint32_t distance : distances) addWord(distance);
+  return hash;
+}
+
+// Method that fills the table of the given integer type in memory.
+template<typename T>
+void HeldKarp::fillTable(vector<T>& table, ThreadPool* pool) const {
+  if (isStopped()) return;
+  table.assign(((size_t) 1 << nodes) * nodes, numeric_limits<T>::max());
+  fillFirstLayer(table.data());
+  for (unsigned int subsetSize = 2; subsetSize <= nodes && !isStopped(); subsetSize++) {
+    fillLayer(table.data(), subsetSize, pool);
+  }
+}
+
+// Method that fills the mapped table of the given integer type from the first layer not completed yet, committing each layer to the file.
+template<typename T>
+void HeldKarp::fillMappedTable(T* table, ThreadPool* pool) {
+  for (unsigned int subsetSize = max(1u, resumedLayers + 1); subsetSize <= nodes && !isStopped(); subsetSize++) {
+    if (subsetSize == 1) {
+      fillFirstLayer(table);
+    } else {
+      fillLayer(table, subsetSize, pool);
+    }
+
+    // A layer cut short by the context must not be recorded as completed.
+    if (isInterrupted) break;
+    commitLayer(subsetSize, sizeof(T));
+  }
+}
+
+// Method that fills the rows of the single-checkpoint subsets.
+template<typename T>
+void HeldKarp::fillFirstLayer(T* table) const {
+  // The single-checkpoint subsets are reached straight from the start (checkpoint j + 1 is bit j).
+  const T infinity = numeric_limits<T>::max();
+  for (unsigned int j = 0; j < nodes; j++) {
+    T* row = table + getRowIndex((size_t) 1 << j) * nodes;
+    fill(row, row + nodes, infinity);
+    row[j] = (T) min((uint64_t) getDistance(0, j + 1), (uint64_t) infinity);
+  }
+}
+
+// Method that fills the rows of the subsets of the given size, splitting the layer into chunks of consecutive ranks.
+template<typename T>
+void HeldKarp::fillLayer(T* table, unsigned int subsetSize, ThreadPool* pool) const {
+  const T infinity = numeric_limits<T>::max();
+  const unsigned long long layerSize = binomials[nodes][subsetSize];
+
+  // The vector kernel reads whole vectors of checkpoints, so it needs at least one.
+  const bool isVectorKernelUsed = isVectorized && nodes >= VECTOR_BYTES / sizeof(T);
+  const vector<T> columns = isVectorKernelUsed ? getColumns<T>() : vector<T>();
+
+  auto fillChunk = [&](size_t firstRank, size_t lastRank) {
+    size_t mask = getSubset(firstRank, subsetSize);
+    for (size_t rank = firstRank; rank < lastRank; rank++, mask = getNextSubset(mask)) {
+      if ((rank - firstRank) % STOP_CHECK_SUBSETS == 0 && isStopped()) return;
+      // The rows of a mapped table start uninitialized, so the checkpoints outside the subset are set to the infinity first.
+      if (isLayerOrdered) {
+        T* row = table + getRowIndex(mask) * nodes;
+        fill(row, row + nodes, infinity);
+      }
+      if (isVectorKernelUsed) {
+        fillRowVectorized(table, mask, columns.data());
+      } else {
+        fillRow(table, mask);
+      }
+    }
+  };
+  if (pool != nullptr && pool->getNumThreads() > 1) {
+    pool->parallelFor(0, layerSize, max((unsigned long long) MIN_CHUNK_SIZE, layerSize / (pool->getNumThreads() * 8)), fillChunk);
+  } else {
+    fillChunk(0, layerSize);
+  }
+}
+
+// Method that checks whether the context stops the filling (and records that the table is not complete).
+bool HeldKarp::isStopped() const {
+  if (isInterrupted) return true;
+  if (context == nullptr || !context->shouldStop()) return false;
+  isInterrupted = true;
+  return true;
+}
+
+// Method that fills the row of a subset from the rows of its subsets one checkpoint smaller.
+template<typename T>
+void HeldKarp::fillRow(T* table, size_t mask) const {
+  const T infinity = numeric_limits<T>::max();
+  T* row = table + getRowIndex(mask) * nodes;
+  for (size_t lastBits = mask; lastBits != 0; lastBits &= lastBits - 1) {
+    const unsigned int j = __builtin_ctzll(lastBits);
+    const size_t previousMask = mask ^ ((size_t) 1 << j);
+    const T* previousRow = table + getRowIndex(previousMask) * nodes;
+    uint64_t best = infinity;
+    for (size_t previousBits = previousMask; previousBits != 0; previousBits &= previousBits - 1) {
+      const unsigned int i = __builtin_ctzll(previousBits);
+      const uint32_t distance = distances[(size_t) (i + 1) * size + j + 1];
+      if (previousRow[i] == infinity || distance == UINT32_MAX) continue;
+      best = min(best, (uint64_t) previousRow[i] + distance);
+    }
+    row[j] = (T) min(best, (uint64_t) infinity);
+  }
+}
+
+// Method that returns the distances to each checkpoint as columns of the given integer type (the infinity marks the missing edges).
+template<typename T>
+vector<T> HeldKarp::getColumns() const {
+  const T infinity = numeric_limits<T>::max();
+  vector<T> columns((size_t) nodes * nodes);
+  for (unsigned int j = 0; j < nodes; j++) {
+    for (unsigned int i = 0; i < nodes; i++) {
+      columns[(size_t) j * nodes + i] = (T) min((uint64_t) getDistance(i + 1, j + 1), (uint64_t) infinity);
+    }
+  }
+  return columns;
+}
+
+#ifdef HELD_KARP_AVX2_KERNEL
+// Method that fills the row of a subset with the vector kernel (needs at least one vector of checkpoints).
+__attribute__((target("avx2")))
+void HeldKarp::fillRowVectorized(uint16_t* table, size_t mask, const uint16_t* columns) const {
+  uint16_t* row = table + getRowIndex(mask) * nodes;
+  for (size_t lastBits = mask; lastBits != 0; lastBits &= lastBits - 1) {
+    const unsigned int j = __builtin_ctzll(lastBits);
+    const uint16_t* previousRow = table + getRowIndex(mask ^ ((size_t) 1 << j)) * nodes;
+    const uint16_t* column = columns + (size_t) j * nodes;
+
+    // Take the minimum 16 predecessors at a time (the last vector overlaps the previous one instead of reading past the row).
+    __m256i best = _mm256_set1_epi16(-1);
+    for (unsigned int i = 0; i < nodes; i += 16) {
+      const unsigned int offset = min(i, nodes - 16);
+      __m256i previousLengths = _mm256_loadu_si256((const __m256i*) (previousRow + offset));
+      __m256i distances = _mm256_loadu_si256((const __m256i*) (column + offset));
+      best = _mm256_min_epu16(best, _mm256_adds_epu16(previousLengths, distances));
+    }
+
+    // Reduce the vector to its smallest lane.
+    __m128i half = _mm_min_epu16(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    row[j] = (uint16_t) _mm_cvtsi128_si32(_mm_minpos_epu16(half));
+  }
+}
+
+// Method that fills the row of a subset with the vector kernel (needs at least one vector of checkpoints).
+__attribute__((target("avx2")))
+void HeldKarp::fillRowVectorized(uint32_t* table, size_t mask, const uint32_t* columns) const {
+  uint32_t* row = table + getRowIndex(mask) * nodes;
+  const __m256i ones = _mm256_set1_epi32(-1);
+  for (size_t lastBits = mask; lastBits != 0; lastBits &= lastBits - 1) {
+    const unsigned int j = __builtin_ctzll(lastBits);
+    const uint32_t* previousRow = table + getRowIndex(mask ^ ((size_t) 1 << j)) * nodes;
+    const uint32_t* column = columns + (size_t) j * nodes;
+
+    // Take the minimum 8 predecessors at a time, saturating the sums as a + min(b, ~a).
+    __m256i best = ones;
+    for (unsigned int i = 0; i < nodes; i += 8) {
+      const unsigned int offset = min(i, nodes - 8);
+      __m256i previousLengths = _mm256_loadu_si256((const __m256i*) (previousRow + offset));
+      __m256i distances = _mm256_loadu_si256((const __m256i*) (column + offset));
+      __m256i sums = _mm256_add_epi32(previousLengths, _mm256_min_epu32(distances, _mm256_xor_si256(previousLengths, ones)));
+      best = _mm256_min_epu32(best, sums);
+    }
+
+    // Reduce the vector to its smallest lane.
+    __m128i half = _mm_min_epu32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_min_epu32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epu32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    row[j] = (uint32_t) _mm_cvtsi128_si32(half);
+  }
+}
+
+// Method that checks if the CPU supports the vector kernel.
+bool HeldKarp::isVectorKernelSupported() {
+  return __builtin_cpu_supports("avx2");
+}
+#else
+// Method that fills the row of a subset with the vector kernel (never chosen without AVX2).
+void HeldKarp::fillRowVectorized(uint16_t* table, size_t mask, const uint16_t* columns) const {}
+
+// Method that fills the row of a subset with the vector kernel (never chosen without AVX2).
+void HeldKarp::fillRowVectorized(uint32_t* table, size_t mask, const uint32_t* columns) const {}
+
+// Method that checks if the CPU supports the vector kernel.
+bool HeldKarp::isVectorKernelSupported() {
+  return false;
+}
+#endif
+
+// Method that recovers the order from the table of the given integer type.
+template<typename T>
+vector<unsigned int> HeldKarp::reconstructOrder(const T* table) const {
+  const T infinity = numeric_limits<T>::max();
+  const size_t fullMask = ((size_t) 1 << nodes) - 1;
+
+  // Close the cycle through the best last checkpoint.
+  uint64_t bestLength = UINT64_MAX;
+  unsigned int last = 0;
+  const T* fullRow = table + getRowIndex(fullMask) * nodes;
+  for (unsigned int j = 0; j < nodes; j++) {
+    if (fullRow[j] == infinity || getDistance(j + 1, 0) == UINT32_MAX) continue;
+    uint64_t length = (uint64_t) fullRow[j] + getDistance(j + 1, 0);
+    if (length < bestLength) {
+      bestLength = length;
+      last = j;
+    }
+  }
+  if (bestLength == UINT64_MAX) return {};
+
+  // Walk back through the predecessors that produced each length.
+  vector<unsigned int> order;
+  size_t mask = fullMask;
+  while (true) {
+    order.push_back(last + 1);
+    const size_t previousMask = mask ^ ((size_t) 1 << last);
+    if (previousMask == 0) break;
+    const T* row = table + getRowIndex(mask) * nodes;
+    const T* previousRow = table + getRowIndex(previousMask) * nodes;
+    for (size_t previousBits = previousMask; previousBits != 0; previousBits &= previousBits - 1) {
+      const unsigned int i = __builtin_ctzll(previousBits);
+      const T previousLength = previousRow[i];
+      if (previousLength != infinity && getDistance(i + 1, last + 1) != UINT32_MAX
+          && (uint64_t) previousLength + getDistance(i + 1, last + 1) == row[last]) {
+        last = i;
+        break;
+      }
+    }
+    mask = previousMask;
+  }
+  order.push_back(0);
+  reverse(order.begin(), order.end());
+
+  return order;
+}
+
+// Method that returns the distance between two checkpoints.
+uint32_t HeldKarp::getDistance(unsigned int i, unsigned int j) const {
+  return distances[(size_t) i * size + j];
+}
+
+// Method that flushes the rows of a completed layer to the file and then records the layer in the header.
+void HeldKarp::commitLayer(unsigned int subsetSize, size_t elementSize) {
+#ifdef HELD_KARP_MAPPED_TABLE
+  // Flush the pages of the layer (msync needs a page-aligned start).
+  char* base = (char*) mappedTable;
+  const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+  const size_t layerStart = MAPPED_HEADER_BYTES + layerOffsets[subsetSize] * nodes * elementSize;
+  const size_t layerEnd = MAPPED_HEADER_BYTES + layerOffsets[subsetSize + 1] * nodes * elementSize;
+  const size_t alignedStart = layerStart / pageSize * pageSize;
+  msync(base + alignedStart, layerEnd - alignedStart, MS_SYNC);
+
+  // Only then mark the layer as completed, so that a stopped run never skips a layer that did not reach the disk.
+  ((MappedTableHeader*) base)->completedLayers = subsetSize;
+  msync(base, MAPPED_HEADER_BYTES, MS_SYNC);
+#endif
+}
+
+// Method that returns the index of the row of a subset.
+size_t HeldKarp::getRowIndex(size_t mask) const {
+  return isLayerOrdered ? layerOffsets[__builtin_popcountll(mask)] + getRank(mask) : mask;
+}
+
+// Method that returns the subset of the given size at the given rank in the colexicographic order (the order of increasing masks).
+size_t HeldKarp::getSubset(unsigned long long rank, unsigned int subsetSize) const {
+  // Pick the highest element first: the largest c with C(c, k) <= rank.
+  size_t mask = 0;
+  unsigned int c = nodes;
+  for (unsigned int k = subsetSize; k > 0; k--) {
+    while (binomials[c][k] > rank) c--;
+    mask |= (size_t) 1 << c;
+    rank -= binomials[c][k];
+  }
+  return mask;
+}
+
+// Method that returns the rank of a subset among the subsets of the same size in the colexicographic order.
+unsigned long long HeldKarp::getRank(size_t mask) const {
+  // The k-th lowest element c adds the number of the subsets of size k below c.
+  unsigned long long rank = 0;
+  unsigned int k = 1;
+  for (size_t bits = mask; bits != 0; bits &= bits - 1, k++) {
+    rank += binomials[__builtin_ctzll(bits)][k];
+  }
+  return rank;
+}
+
+// Method that returns the next subset of the same size in the colexicographic order.
+size_t HeldKarp::getNextSubset(size_t mask) {
+  size_t lowest = mask & (~mask + 1);
+  size_t ripple = mask + lowest;
+  return ripple | (((mask ^ ripple) >> 2) / lowest);
+}
@@ -0,0 +1,174 @@
+#ifndef HELD_KARP_H
+#define HELD_KARP_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <climits>
+#include <limits>
+#include <atomic>
+#include <algorithm>
+#include "../distance_matrix/distance_matrix.h"
+#include "../thread_pool/thread_pool.h"
+#include "../solver_context/solver_context.h"
+
+using namespace std;
+
+// Structure that solves the shortest cycle through all the checkpoints with the Held-Karp dynamic program.
+// Checkpoint 0 is the fixed start, so only the subsets of the other checkpoints are stored: for every subset and every checkpoint in it,
+// the length of the shortest walk from the start through the subset that ends at that checkpoint. The table is a single flat
+// [subset][checkpoint] buffer of 16-bit integers (or 32-bit ones if the lengths may not fit), and no parents are kept:
+// the order is recovered by finding which predecessor produced each length.
+// The subsets are processed in layers of the same size, so the rows of a layer only read the previous layer and can be filled in parallel.
+// For an open path the start is a virtual checkpoint at zero distance from all the others, so the cycle through it is the shortest path.
+// For an open path from a fixed start, checkpoint 0 stays the start and the edges back to it are free instead.
+// On CPUs with AVX2 the rows are filled by a vector kernel chosen at runtime: the minimum over the predecessors is taken over whole
+// rows with saturating additions (the checkpoints missing from a subset hold the infinity, so they never win), reading the distances
+// to the checkpoint from a transposed copy of the matrix.
+// For tables that do not fit the memory, the table can be kept in a memory-mapped file instead. The rows are then ordered by layer
+// (and by colexicographic rank within a layer), so that each layer is written sequentially, and the file header records the last
+// completed layer, so that a run that was stopped resumes from the next one.
+// With a solver context, the filling stops within a few rows when the context does, and a complete table offers the context
+// the shortest route as proven optimal.
+struct HeldKarp {
+  // The smallest number of subsets handed to a thread at once.
+  static constexpr unsigned long long MIN_CHUNK_SIZE = 256;
+
+  // The number of subsets a thread fills between the checks of the context (a power of 2).
+  static constexpr unsigned long long STOP_CHECK_SUBSETS = 4096;
+
+  // The width of the vector registers used by the vector kernel.
+  static constexpr unsigned int VECTOR_BYTES = 32;
+
+  // The size of the header of the table file (a page, so that the table is page-aligned) and its magic number (with the format version).
+  static constexpr size_t MAPPED_HEADER_BYTES = 4096;
+  static constexpr uint64_t MAPPED_TABLE_MAGIC = 0x484B5441424C0001ULL;
+
+  // Structure that represents the header of the table file.
+  struct MappedTableHeader {
+    uint64_t magic;
+    uint64_t fingerprint;
+    uint32_t completedLayers;
+  };
+
+  // Whether the walk is an open path (through the virtual start) rather than a cycle, and whether the path starts from checkpoint 0 instead.
+  bool isOpen = false;
+  bool isStartFixed = false;
+
+  // The number of checkpoints (including the virtual start) and the number of checkpoints besides the start.
+  unsigned int size = 0;
+  unsigned int nodes = 0;
+
+  // The distances between the checkpoints (row-major, UINT32_MAX if there is no path).
+  vector<uint32_t> distances;
+
+  // The binomial coefficients up to the number of checkpoints besides the start (the sizes of the layers).
+  vector<vector<unsigned long long>> binomials;
+
+  // The table (only one of the two is used).
+  bool isCompact = false;
+  vector<uint16_t> compactLengths;
+  vector<uint32_t> lengths;
+
+  // Whether the rows are filled by the vector kernel (set by the constructor if the CPU supports it).
+  bool isVectorized = false;
+
+  // Whether the rows are ordered by layer rather than by subset, and the first row of each layer.
+  bool isLayerOrdered = false;
+  vector<unsigned long long> layerOffsets;
+
+  // The mapping of the table file (with the header in front of the table) and the number of layers completed by the previous runs.
+  void* mappedTable = nullptr;
+  size_t mappedBytes = 0;
+  unsigned int resumedLayers = 0;
+
+  // The context the filling reports to and stops with (if any), and whether it was stopped before the table was complete.
+  SolverContext* context = nullptr;
+  mutable atomic<bool> isInterrupted{false};
+
+  // Constructors.
+  explicit HeldKarp(const DistanceMatrix& matrix, bool _isOpen = false, bool _isStartFixed = false);
+  HeldKarp(const HeldKarp&) = delete;
+  HeldKarp& operator=(const HeldKarp&) = delete;
+
+  // Destructor.
+  ~HeldKarp();
+
+  // Method that keeps the table in the given file, resuming the run stored in it if it solves the same problem.
+  // Returns false if the file cannot be mapped (a file it created is then removed).
+  bool mapTable(const string& filePath);
+
+  // Method that fills the table (in parallel if a thread pool is given) until it is complete or the context stops it.
+  void solve(ThreadPool* pool = nullptr, SolverContext* _context = nullptr);
+
+  // Method that returns the checkpoint IDs of the shortest cycle starting from checkpoint 0, or of the shortest open path (empty if there is none).
+  // The path starts from checkpoint 0 if its start is fixed.
+  vector<unsigned int> getOrder() const;
+
+  // Method that returns the length of the shortest cycle (of the path, if it is open), or ULLONG_MAX if there is none.
+  unsigned long long getLength() const;
+
+  // Method that returns the number of bytes taken by the table.
+  unsigned long long getTableBytes() const;
+
+  // Method that returns a hash of the problem, which identifies its table file.
+  uint64_t getFingerprint() const;
+
+  // Method that fills the table of the given integer type in memory.
+  template<typename T>
+  void fillTable(vector<T>& table, ThreadPool* pool) const;
+
+  // Method that fills the mapped table of the given integer type from the first layer not completed yet, committing each layer to the file.
+  template<typename T>
+  void fillMappedTable(T* table, ThreadPool* pool);
+
+  // Method that fills the rows of the single-checkpoint subsets.
+  template<typename T>
+  void fillFirstLayer(T* table) const;
+
+  // Method that fills the rows of the subsets of the given size, splitting the layer into chunks of consecutive ranks.
+  template<typename T>
+  void fillLayer(T* table, unsigned int subsetSize, ThreadPool* pool) const;
+
+  // Method that fills the row of a subset from the rows of its subsets one checkpoint smaller.
+  template<typename T>
+  void fillRow(T* table, size_t mask) const;
+
+  // Method that fills the row of a subset with the vector kernel (needs at least one vector of checkpoints).
+  void fillRowVectorized(uint16_t* table, size_t mask, const uint16_t* columns) const;
+  void fillRowVectorized(uint32_t* table, size_t mask, const uint32_t* columns) const;
+
+  // Method that returns the distances to each checkpoint as columns of the given integer type (the infinity marks the missing edges).
+  template<typename T>
+  vector<T> getColumns() const;
+
+  // Method that flushes the rows of a completed layer to the file and then records the layer in the header.
+  void commitLayer(unsigned int subsetSize, size_t elementSize);
+
+  // Method that checks whether the context stops the filling (and records that the table is not complete).
+  bool isStopped() const;
+
+  // Method that checks if the CPU supports the vector kernel.
+  static bool isVectorKernelSupported();
+
+  // Method that returns the index of the row of a subset.
+  size_t getRowIndex(size_t mask) const;
+
+  // Method that returns the subset of the given size at the given rank in the colexicographic order (the order of increasing masks).
+  size_t getSubset(unsigned long long rank, unsigned int subsetSize) const;
+
+  // Method that returns the rank of a subset among the subsets of the same size in the colexicographic order.
+  unsigned long long getRank(size_t mask) const;
+
+  // Method that returns the next subset of the same size in the colexicographic order.
+  static size_t getNextSubset(size_t mask);
+
+  // Method that recovers the order from the table of the given integer type.
+  template<typename T>
+  vector<unsigned int> reconstructOrder(const T* table) const;
+
+  // Method that returns the distance between two checkpoints.
+  uint32_t getDistance(unsigned int i, unsigned int j) const;
+};
+
+#endif
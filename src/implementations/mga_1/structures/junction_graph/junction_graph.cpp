@@ -0,0 +1,222 @@
+#include "junction_graph.h"
+
+// Constructor.
+JunctionGraph::JunctionGraph(const vector<vector<unsigned int>>& maze) {
+  height = maze.size();
+  width = height > 0 ? maze[0].size() : 0;
+  cellNodes.assign(width * height, -1);
+  cellCorridors.assign(width * height, -1);
+  cellOffsets.assign(width * height, 0);
+
+  // Create a node for every open cell whose degree is not 2 (junctions and dead ends).
+  for (int cell = 0; cell < (int) (width * height); cell++) {
+    if (maze[cell / width][cell % width] == WALL_ID) continue;
+    unsigned int degree = 0;
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      degree += getOpenNeighbor(maze, cell, direction) != -1;
+    }
+    if (degree != 2) {
+      addNode(cell);
+    }
+  }
+
+  // Walk all the corridors that leave the nodes.
+  for (int node = 0; node < (int) nodeCells.size(); node++) {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      walkCorridor(maze, node, direction);
+    }
+  }
+
+  // Cycles without any junction are left over, so promote one cell of each to a node.
+  for (int cell = 0; cell < (int) (width * height); cell++) {
+    if (maze[cell / width][cell % width] == WALL_ID || cellNodes[cell] != -1 || cellCorridors[cell] != -1) continue;
+    int node = addNode(cell);
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      walkCorridor(maze, node, direction);
+    }
+  }
+}
+
+// Method that adds a node for a cell.
+int JunctionGraph::addNode(int cell) {
+  cellNodes[cell] = (int) nodeCells.size();
+  nodeCells.push_back(cell);
+  nodeCorridors.emplace_back();
+  return cellNodes[cell];
+}
+
+// Method that walks the corridor that leaves a node in the given direction and adds it to the graph.
+void JunctionGraph::walkCorridor(const vector<vector<unsigned int>>& maze, int node, unsigned int direction) {
+  int next = getOpenNeighbor(maze, nodeCells[node], direction);
+  if (next == -1) return;
+
+  // Skip corridors that were already walked from their other end.
+  if (cellCorridors[next] != -1 || (cellNodes[next] != -1 && cellNodes[next] < node)) return;
+
+  // Follow the degree-2 cells until another node is reached.
+  int corridorId = (int) corridors.size();
+  Corridor corridor(node, -1, nodeCells[node], width);
+  corridor.path.addSteps(direction);
+  int previous = nodeCells[node];
+  int current = next;
+  while (cellNodes[current] == -1) {
+    cellCorridors[current] = corridorId;
+    cellOffsets[current] = corridor.path.length;
+    for (unsigned int nextDirection = 0; nextDirection < 4; nextDirection++) {
+      int neighbor = getOpenNeighbor(maze, current, nextDirection);
+      if (neighbor != -1 && neighbor != previous) {
+        corridor.path.addSteps(nextDirection);
+        previous = current;
+        current = neighbor;
+        break;
+      }
+    }
+  }
+  corridor.to = cellNodes[current];
+
+  // Add the corridor to the graph.
+  corridors.push_back(std::move(corridor));
+  nodeCorridors[node].push_back(corridorId);
+  if (corridors.back().to != node) {
+    nodeCorridors[corridors.back().to].push_back(corridorId);
+  }
+}
+
+// Method that returns the index of the open neighbor of a cell in the given direction (-1 if there is none).
+int JunctionGraph::getOpenNeighbor(const vector<vector<unsigned int>>& maze, int cell, unsigned int direction) const {
+  const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  int x = cell % (int) width + offsets[direction][0];
+  int y = cell / (int) width + offsets[direction][1];
+  if (x < 0 || y < 0 || x >= (int) width || y >= (int) height || maze[y][x] == WALL_ID) return -1;
+  return y * (int) width + x;
+}
+
+// Method that returns the distance from a cell to each end of its corridor, or to its node.
+vector<pair<int, unsigned int>> JunctionGraph::getAttachments(int cell) const {
+  if (cellNodes[cell] != -1) {
+    return {{cellNodes[cell], 0}};
+  }
+  const Corridor& corridor = corridors[cellCorridors[cell]];
+  return {{corridor.from, cellOffsets[cell]}, {corridor.to, corridor.path.length - cellOffsets[cell]}};
+}
+
+// Method that runs Dijkstra from a cell over the nodes (stops early once the target cell is settled, if given).
+unsigned long long JunctionGraph::findNodeDistances(int sourceCell, vector<unsigned int>& distances, vector<int>& predecessorCorridors, int targetCell) const {
+  distances.assign(nodeCells.size(), UINT_MAX);
+  predecessorCorridors.assign(nodeCells.size(), -1);
+
+  // Seed the nodes the source cell is attached to.
+  priority_queue<pair<unsigned int, int>, vector<pair<unsigned int, int>>, greater<>> openList;
+  for (auto [node, distance] : getAttachments(sourceCell)) {
+    if (distance < distances[node]) {
+      distances[node] = distance;
+      openList.emplace(distance, node);
+    }
+  }
+
+  // Run Dijkstra over the corridors.
+  unsigned long long expandedNodes = 0;
+  while (!openList.empty()) {
+    auto [distance, node] = openList.top();
+    openList.pop();
+    if (distance != distances[node]) continue;
+    expandedNodes++;
+
+    // Stop once no unsettled node can lead to a shorter path to the target.
+    if (targetCell != -1 && distance >= getDistance(sourceCell, targetCell, distances)) break;
+
+    for (int corridorId : nodeCorridors[node]) {
+      const Corridor& corridor = corridors[corridorId];
+      int other = corridor.from == node ? corridor.to : corridor.from;
+      if (distance + corridor.path.length < distances[other]) {
+        distances[other] = distance + corridor.path.length;
+        predecessorCorridors[other] = corridorId;
+        openList.emplace(distances[other], other);
+      }
+    }
+  }
+
+  return expandedNodes;
+}
+
+// Method that returns the distance between two cells given the node distances from the source cell.
+unsigned int JunctionGraph::getDistance(int sourceCell, int targetCell, const vector<unsigned int>& distances) const {
+  // The two cells can lie on the same corridor, in which case the direct walk is a candidate.
+  unsigned long long best = UINT_MAX;
+  if (sourceCell == targetCell) return 0;
+  if (cellCorridors[sourceCell] != -1 && cellCorridors[sourceCell] == cellCorridors[targetCell]) {
+    best = max(cellOffsets[sourceCell], cellOffsets[targetCell]) - min(cellOffsets[sourceCell], cellOffsets[targetCell]);
+  }
+
+  // Otherwise the path enters the target through one of its attachment nodes.
+  for (auto [node, distance] : getAttachments(targetCell)) {
+    if (distances[node] != UINT_MAX) {
+      best = min(best, (unsigned long long) distances[node] + distance);
+    }
+  }
+
+  return (unsigned int) min(best, (unsigned long long) UINT_MAX);
+}
+
+// Method that returns the path between two cells given the node distances and predecessors from the source cell.
+CompactPath JunctionGraph::getPath(int sourceCell, int targetCell, const vector<unsigned int>& distances, const vector<int>& predecessorCorridors) const {
+  unsigned int distance = getDistance(sourceCell, targetCell, distances);
+  if (distance == UINT_MAX) return {};
+
+  // Build the walk backwards, from the target to the source (the steps of a corridor walked from its "to" end are reversed).
+  CompactPath walk(width, targetCell);
+  int targetCorridor = cellCorridors[targetCell];
+  if (targetCorridor != -1 && targetCorridor == cellCorridors[sourceCell]
+      && distance == max(cellOffsets[sourceCell], cellOffsets[targetCell]) - min(cellOffsets[sourceCell], cellOffsets[targetCell])) {
+    // Walk directly along the shared corridor.
+    const CompactPath& corridorPath = corridors[targetCorridor].path;
+    if (cellOffsets[targetCell] < cellOffsets[sourceCell]) {
+      walk.appendSteps(corridorPath, cellOffsets[targetCell], cellOffsets[sourceCell]);
+    } else {
+      walk.appendSteps(corridorPath, corridorPath.length - cellOffsets[targetCell], corridorPath.length - cellOffsets[sourceCell], true);
+    }
+  } else {
+    // Walk from the target to the attachment node the shortest path enters through.
+    int node = -1;
+    for (auto [attachmentNode, attachmentDistance] : getAttachments(targetCell)) {
+      if (distances[attachmentNode] != UINT_MAX && distances[attachmentNode] + attachmentDistance == distance) {
+        node = attachmentNode;
+        break;
+      }
+    }
+    if (targetCorridor != -1) {
+      const Corridor& corridor = corridors[targetCorridor];
+      if (corridor.from == node && distances[node] + cellOffsets[targetCell] == distance) {
+        walk.appendSteps(corridor.path, corridor.path.length - cellOffsets[targetCell], corridor.path.length, true);
+      } else {
+        walk.appendSteps(corridor.path, cellOffsets[targetCell], corridor.path.length);
+      }
+    }
+
+    // Follow the predecessor corridors back to the node the source is attached to.
+    while (predecessorCorridors[node] != -1) {
+      const Corridor& corridor = corridors[predecessorCorridors[node]];
+      if (corridor.to == node) {
+        walk.appendSteps(corridor.path, 0, corridor.path.length, true);
+        node = corridor.from;
+      } else {
+        walk.appendSteps(corridor.path, 0, corridor.path.length);
+        node = corridor.to;
+      }
+    }
+
+    // Walk from the attachment node to the source.
+    int sourceCorridor = cellCorridors[sourceCell];
+    if (sourceCorridor != -1) {
+      const Corridor& corridor = corridors[sourceCorridor];
+      if (corridor.from == node && distances[node] == cellOffsets[sourceCell]) {
+        walk.appendSteps(corridor.path, 0, cellOffsets[sourceCell]);
+      } else {
+        walk.appendSteps(corridor.path, 0, corridor.path.length - cellOffsets[sourceCell], true);
+      }
+    }
+  }
+
+  // Return the walk in the order from the source to the target.
+  return CompactPath(walk.reversed());
+}
@@ -0,0 +1,64 @@
+#ifndef JUNCTION_GRAPH_H
+#define JUNCTION_GRAPH_H
+
+#include <vector>
+#include <queue>
+#include <climits>
+#include <algorithm>
+#include "../cell/cell.h"
+#include "../corridor/corridor.h"
+#include "../../models/models.h"
+
+using namespace std;
+
+// Structure that represents the maze contracted into a weighted graph of junctions and dead ends.
+// Every open cell of degree other than 2 becomes a node, and every chain of degree-2 cells between two nodes
+// becomes a single corridor edge weighted by its length. Shortest paths are searched on this graph and expanded
+// back into cells only when needed.
+struct JunctionGraph {
+  // Dimensions of the maze the graph was built for.
+  unsigned int width = 0;
+  unsigned int height = 0;
+
+  // The cell index of each node.
+  vector<int> nodeCells;
+
+  // The corridors and the corridor IDs incident to each node.
+  vector<Corridor> corridors;
+  vector<vector<int>> nodeCorridors;
+
+  // The node ID of each cell (-1 if the cell is not a node).
+  vector<int> cellNodes;
+
+  // The corridor ID of each corridor cell and its offset from the corridor start (-1 and 0 for other cells).
+  vector<int> cellCorridors;
+  vector<unsigned int> cellOffsets;
+
+  // Constructors.
+  JunctionGraph() = default;
+  explicit JunctionGraph(const vector<vector<unsigned int>>& maze);
+
+  // Method that runs Dijkstra from a cell over the nodes (stops early once the target cell is settled, if given).
+  // Returns the number of nodes expanded.
+  unsigned long long findNodeDistances(int sourceCell, vector<unsigned int>& distances, vector<int>& predecessorCorridors, int targetCell = -1) const;
+
+  // Method that returns the distance between two cells given the node distances from the source cell.
+  unsigned int getDistance(int sourceCell, int targetCell, const vector<unsigned int>& distances) const;
+
+  // Method that returns the path between two cells given the node distances and predecessors from the source cell.
+  CompactPath getPath(int sourceCell, int targetCell, const vector<unsigned int>& distances, const vector<int>& predecessorCorridors) const;
+
+  // Method that returns the distance from a cell to each end of its corridor, or to its node.
+  vector<pair<int, unsigned int>> getAttachments(int cell) const;
+
+  // Method that adds a node for a cell.
+  int addNode(int cell);
+
+  // Method that walks the corridor that leaves a node in the given direction and adds it to the graph.
+  void walkCorridor(const vector<vector<unsigned int>>& maze, int node, unsigned int direction);
+
+  // Method that returns the index of the open neighbor of a cell in the given direction (-1 if there is none).
+  int getOpenNeighbor(const vector<vector<unsigned int>>& maze, int cell, unsigned int direction) const;
+};
+
+#endif
@@ -1,13 +1,20 @@
 #include "maze.h"
 
 // Constructor.
-Maze::Maze(unsigned int _width, unsigned int _height, unsigned int _checkpointsValue, CheckpointSettingType _checkpointSettingType, SupportedSolvingAlgorithms _solvingAlgorithm, string _executablePath) {
+Maze::Maze(unsigned int _width, unsigned int _height, unsigned int _checkpointsValue, CheckpointSettingType _checkpointSettingType, SupportedSolvingAlgorithms _solvingAlgorithm, RouteType _routeType, unsigned int _agentsCount, AgentObjective _agentObjective, unsigned int _seed, string _executablePath) {
   this->width = _width;
   this->height = _height;
   this->checkpointsValue = _checkpointsValue;
   this->checkpointSettingType = _checkpointSettingType;
   this->solvingAlgorithm = _solvingAlgorithm;
+  this->routeType = _routeType;
+  this->agentsCount = _agentsCount;
+  this->agentObjective = _agentObjective;
   this->executablePath = std::move(_executablePath);
+
+  // Seed the random number generator, so that the same seed generates the same maze (a random seed if none was given).
+  this->seed = _seed != 0 ? _seed : 1 + randomGenerator() % MAZE_MAX_SEED;
+  seedRandomGenerator(seed);
   generateMaze();
 }
 
@@ -40,7 +47,10 @@ void Maze::visualizeMazeGeneration(unsigned int minVisualizationDurationMs) {
         cout << "  - Checkpoints percentage: " << checkpointsValue << "%" << "\n";
         break;
     }
-    cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n\n";
+    cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n";
+    cout << "  - Route type: " << getRouteTypeName() << "\n";
+    cout << "  - Agents: " << agentsCount << (agentsCount > 1 ? " (" + getAgentObjectiveName() + ")" : "") << "\n";
+    cout << "  - Seed: " << seed << "\n\n";
 
     // Print the maze generation statistics.
     if (minPathLength > 0 || actualNumberOfCheckpoints > 0) {
@@ -49,6 +59,7 @@ void Maze::visualizeMazeGeneration(unsigned int minVisualizationDurationMs) {
     if (minPathLength > 0) {
       cout << "  - Minimum path length: " << minPathLength << " cells.\n";
     }
+    cout << getLegSearchesStatistics();
     if (actualNumberOfCheckpoints > 0) {
       cout << "  - Number of checkpoints: " << actualNumberOfCheckpoints << ".\n\n";
     }
@@ -149,7 +160,10 @@ void Maze::visualizeMazeGeneration(unsigned int minVisualizationDurationMs) {
           cout << "  - Checkpoints percentage: " << checkpointsValue << "%" << "\n";
           break;
       }
-      cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n\n";
+      cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n";
+      cout << "  - Route type: " << getRouteTypeName() << "\n";
+      cout << "  - Agents: " << agentsCount << (agentsCount > 1 ? " (" + getAgentObjectiveName() + ")" : "") << "\n";
+      cout << "  - Seed: " << seed << "\n\n";
 
       // Print the maze generation statistics.
       if (minPathLength > 0 || actualNumberOfCheckpoints > 0) {
@@ -158,6 +172,7 @@ void Maze::visualizeMazeGeneration(unsigned int minVisualizationDurationMs) {
       if (minPathLength > 0) {
         cout << "  - Minimum path length: " << minPathLength << " cells.\n";
       }
+      cout << getLegSearchesStatistics();
       if (actualNumberOfCheckpoints > 0) {
         cout << "  - Number of checkpoints: " << actualNumberOfCheckpoints << ".\n\n";
       }
@@ -299,4 +314,7 @@ void Maze::validateInputParameters() {
   if (height % 2 == 0) {
     height++;
   }
+
+  // Check if the number of agents is within the limits.
+  agentsCount = min(max(agentsCount, MAZE_MIN_AGENTS), MAZE_MAX_AGENTS);
 }
@@ -0,0 +1,211 @@
+#include "maze.h"
+
+// Method that builds the distance oracle of the maze.
+void Maze::buildDistanceOracle() {
+  distanceOracle = DistanceOracle(finalMaze);
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) width * height;
+}
+
+// Method that contracts the maze into a junction graph.
+void Maze::buildJunctionGraph() {
+  junctionGraph = JunctionGraph(finalMaze);
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) width * height;
+}
+
+// Method that partitions the maze into clusters for the hierarchical pathfinder.
+void Maze::buildClusterGraph() {
+  clusterGraph = ClusterGraph(finalMaze, HIERARCHICAL_CLUSTER_SIZE);
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) width * height;
+}
+
+// Method that creates an adjacency matrix of the checkpoints.
+DistanceMatrix Maze::createAdjacencyMatrix(const vector<Cell>& checkpoints) {
+  // Drop the predecessor data of the previous solution.
+  checkpointNodeDistances.clear();
+  checkpointPredecessorCorridors.clear();
+
+  // With too many checkpoints to store all the pairs, compute the rows on demand (one Dijkstra per row) instead.
+  const unsigned long long maxDistance = (unsigned long long) width * height;
+  const unsigned long long storedBytes = (unsigned long long) checkpoints.size() * (checkpoints.size() - 1) / 2 * (maxDistance < UINT16_MAX ? 2 : 4);
+  if (storedBytes > DISTANCE_MATRIX_MAX_STORED_BYTES) {
+    return {(unsigned int) checkpoints.size(), [this, checkpoints](unsigned int row, vector<unsigned int>& distances) {
+      const int source = checkpoints[row].y * (int) width + checkpoints[row].x;
+      vector<unsigned int> nodeDistances;
+      vector<int> predecessorCorridors;
+      if (!distanceOracle.isTree) {
+        junctionGraph.findNodeDistances(source, nodeDistances, predecessorCorridors);
+      }
+      for (unsigned int j = 0; j < checkpoints.size(); j++) {
+        distances[j] = distanceOracle.isTree ? distanceOracle.getDistance(checkpoints[row], checkpoints[j]) : junctionGraph.getDistance(source, checkpoints[j].y * (int) width + checkpoints[j].x, nodeDistances);
+      }
+    }, DISTANCE_MATRIX_CACHED_ROWS};
+  }
+
+  // Keep the junction graph predecessors of each checkpoint only if they fit the memory budget.
+  bool isPredecessorDataKept = !distanceOracle.isTree && checkpoints.size() * junctionGraph.nodeCells.size() <= JUNCTION_GRAPH_MAX_STORED_PREDECESSORS;
+
+  // Multi-source BFS pays off on open grids (where the junction graph barely contracts the maze) with many checkpoints. It keeps no predecessors,
+  // so each leg of the route is searched again later: it has to beat the junction graph by more if the junction graph would keep them.
+  const double junctionsShare = (double) junctionGraph.nodeCells.size() / max(1u, width * height - getTheNumberOfCells(WALL_ID));
+  if (!distanceOracle.isTree
+      && checkpoints.size() >= MULTI_SOURCE_BFS_MIN_CHECKPOINTS
+      && junctionsShare >= (isPredecessorDataKept ? MULTI_SOURCE_BFS_MIN_JUNCTIONS_SHARE : MULTI_SOURCE_BFS_MIN_JUNCTIONS_SHARE_WITHOUT_PREDECESSORS)) {
+    return createAdjacencyMatrixMultiSourceBfs(checkpoints);
+  }
+
+  // Define a matrix to store the adjacency matrix.
+  DistanceMatrix matrix((unsigned int) checkpoints.size(), maxDistance);
+  if (isPredecessorDataKept) {
+    checkpointNodeDistances.resize(checkpoints.size());
+    checkpointPredecessorCorridors.resize(checkpoints.size());
+  }
+
+  // Fill the matrix with the distances between each pair of checkpoints.
+  vector<unsigned int> nodeDistances;
+  vector<int> predecessorCorridors;
+  for (int i = 0; i < checkpoints.size(); i++) {
+    // If the maze is not perfect, run a single Dijkstra from the checkpoint over the junction graph.
+    const int source = checkpoints[i].y * (int) width + checkpoints[i].x;
+    if (!distanceOracle.isTree) {
+      iterationsTookToGenerate += (long long) junctionGraph.findNodeDistances(source, nodeDistances, predecessorCorridors);
+    }
+
+    for (int j = i + 1; j < checkpoints.size(); j++) {
+      // On a perfect maze, answer from the distance oracle instead of searching.
+      if (distanceOracle.isTree) {
+        matrix.set(i, j, distanceOracle.getDistance(checkpoints[i], checkpoints[j]));
+      } else {
+        matrix.set(i, j, junctionGraph.getDistance(source, checkpoints[j].y * (int) width + checkpoints[j].x, nodeDistances));
+      }
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
+    }
+
+    // Keep the predecessor data to expand the chosen legs later.
+    if (isPredecessorDataKept) {
+      checkpointNodeDistances[i] = nodeDistances;
+      checkpointPredecessorCorridors[i] = predecessorCorridors;
+    }
+  }
+
+  // Return the matrix.
+  return matrix;
+}
+
+// Method that returns the shortest path between two checkpoints given by their IDs.
+CompactPath Maze::findShortestPathBetweenCheckpoints(unsigned int firstId, unsigned int secondId, const vector<Cell>& checkpoints) {
+  const Cell& first = checkpoints[firstId];
+  const Cell& second = checkpoints[secondId];
+
+  // On a perfect maze, walk the tree through the lowest common ancestor.
+  if (distanceOracle.isTree) {
+    return {distanceOracle.getPath(first, second), width};
+  }
+
+  // Otherwise, expand the predecessor corridors kept for the first checkpoint.
+  if (firstId < checkpointPredecessorCorridors.size()) {
+    const int source = first.y * (int) width + first.x;
+    const int target = second.y * (int) width + second.x;
+    return junctionGraph.getPath(source, target, checkpointNodeDistances[firstId], checkpointPredecessorCorridors[firstId]);
+  }
+
+  // Without any predecessor data, search the leg with the configured point-to-point search (and count the nodes it expands).
+  SearchResult leg = searchShortestPath(first, second, DEFAULT_PATH_SEARCH_ALGORITHM);
+  legSearchesCount++;
+  legSearchExpandedNodes += leg.expandedNodes;
+  return {leg.path.path, width};
+}
+
+// Method that creates an adjacency matrix of the checkpoints using bit-parallel multi-source BFS.
+DistanceMatrix Maze::createAdjacencyMatrixMultiSourceBfs(const vector<Cell>& checkpoints) {
+  const unsigned int cellsCount = width * height;
+  const unsigned int checkpointsQuantity = checkpoints.size();
+
+  // Define a matrix to store the adjacency matrix.
+  DistanceMatrix matrix(checkpointsQuantity, (unsigned long long) cellsCount);
+
+  // Index the checkpoint IDs by their cell index.
+  vector<int> checkpointIds(cellsCount, -1);
+  for (int i = 0; i < checkpointsQuantity; i++) {
+    checkpointIds[checkpoints[i].y * (int) width + checkpoints[i].x] = i;
+  }
+
+  // Precompute the open directions of each cell, so that the sweeps only follow index offsets.
+  const int offsets[4] = {-(int) width, (int) width, -1, 1};
+  vector<uint8_t> openDirections(cellsCount, 0);
+  for (int cell = 0; cell < cellsCount; cell++) {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      if (getOpenNeighborIndex(cell, direction) != -1) openDirections[cell] |= 1u << direction;
+    }
+  }
+
+  // Each cell keeps one bit per source of the current block: whether the source has reached it, and whether it is in the source's frontier.
+  vector<uint64_t> seen(cellsCount);
+  vector<uint64_t> visit(cellsCount);
+  vector<uint64_t> visitNext(cellsCount);
+
+  // Sweep the maze once for every block of 64 sources.
+  for (unsigned int blockStart = 0; blockStart < checkpointsQuantity; blockStart += 64) {
+    const unsigned int blockSize = min(64u, checkpointsQuantity - blockStart);
+    fill(seen.begin(), seen.end(), 0);
+    fill(visit.begin(), visit.end(), 0);
+
+    // Start a BFS from every source of the block.
+    vector<int> frontier;
+    vector<int> nextFrontier;
+    for (unsigned int bit = 0; bit < blockSize; bit++) {
+      int cell = checkpoints[blockStart + bit].y * (int) width + checkpoints[blockStart + bit].x;
+      seen[cell] |= 1ULL << bit;
+      visit[cell] |= 1ULL << bit;
+      frontier.push_back(cell);
+    }
+
+    // Advance all the sources one layer at a time until the whole block has reached every checkpoint.
+    unsigned long long pairsLeft = (unsigned long long) blockSize * (checkpointsQuantity - 1);
+    for (unsigned int layer = 1; !frontier.empty() && pairsLeft > 0; layer++) {
+      // Push the frontier bits of each cell to its neighbors that have not been reached by the same sources.
+      nextFrontier.clear();
+      for (int cell : frontier) {
+        for (unsigned int direction = 0; direction < 4; direction++) {
+          if (!(openDirections[cell] & (1u << direction))) continue;
+          int neighbor = cell + offsets[direction];
+          uint64_t reached = visit[cell] & ~seen[neighbor];
+          if (reached == 0) continue;
+          if (visitNext[neighbor] == 0) nextFrontier.push_back(neighbor);
+          visitNext[neighbor] |= reached;
+        }
+
+        // Increment the number of iterations to generate the maze.
+        iterationsTookToGenerate++;
+      }
+
+      // Mark the new cells as reached and record the distances to the checkpoints among them.
+      for (int cell : frontier) {
+        visit[cell] = 0;
+      }
+      for (int cell : nextFrontier) {
+        seen[cell] |= visitNext[cell];
+        int checkpointId = checkpointIds[cell];
+        if (checkpointId != -1) {
+          for (uint64_t bits = visitNext[cell]; bits != 0; bits &= bits - 1) {
+            matrix.set(blockStart + __builtin_ctzll(bits), checkpointId, layer);
+            pairsLeft--;
+          }
+        }
+        visit[cell] = visitNext[cell];
+        visitNext[cell] = 0;
+      }
+      swap(frontier, nextFrontier);
+    }
+  }
+
+  // Return the matrix.
+  return matrix;
+}
@@ -0,0 +1,418 @@
+#include "maze.h"
+
+// Method that lets the user turn cells into walls or open them, and prints the maze with the repaired solution after each edit.
+void Maze::editWalls() {
+  // Prompt the user to edit the walls.
+  cout << "\n" << colorString("Would you like to edit the walls of the maze?", "yellow", "black", "bold") << " (" << colorString("Y", "green", "default", "bold") << "/" << colorString("N", "red", "default", "bold") << "):\n";
+  string answer;
+  cout << colorString("-->", "yellow", "black", "bold") << " ";
+  cin >> answer;
+
+  // Check if the user wants to edit the walls.
+  if (answer != "y" && answer != "Y") {
+    return;
+  }
+
+  // Toggle the cells the user enters until a negative column is entered.
+  while (true) {
+    cout << "\n" << colorString("Enter the column and the row of the cell to toggle (a negative column to stop):", "green", "black", "bold") << "\n";
+    cout << colorString("-->", "yellow", "black", "bold") << " ";
+    int x = 0;
+    int y = 0;
+    if (!(cin >> x >> y)) {
+      cout << "\n" << colorString("Invalid input. Please try again.", "red", "black", "bold") << "\n";
+      cin.clear();
+      cin.ignore(numeric_limits<streamsize>::max(), '\n');
+      if (cin.eof()) return;
+      continue;
+    }
+    if (x < 0) {
+      return;
+    }
+
+    // Toggle the cell and print the maze with the repaired solution.
+    const bool isWall = x < (int) width && y >= 0 && y < (int) height && finalMaze[y][x] != WALL_ID;
+    auto startTime = chrono::high_resolution_clock::now();
+    const bool isEdited = setWall(x, y, isWall);
+    unsigned long long timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count();
+    clearConsole();
+    printMazeState(finalMaze);
+    cout << "\n";
+    if (!isEdited) {
+      cout << colorString("The cell cannot be toggled (it is outside the maze or a checkpoint, or the wall would disconnect the checkpoints).", "white", "red", "bold") << "\n";
+      continue;
+    }
+    cout << colorString(isWall ? "The cell is a wall now." : "The cell is open now.", "green", "black", "bold") << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n";
+    if (minPathLength > 0) {
+      cout << "  - Minimum path length: " << minPathLength << " cells.\n";
+    }
+  }
+}
+
+// Method that turns a cell into a wall or opens it and repairs the checkpoint distances and the solution incrementally
+// (the routes of several agents, or the ones whose distance fields would not fit the memory budget, are solved again instead).
+bool Maze::setWall(int x, int y, bool isWall) {
+  // Reject the edits outside the maze, of the checkpoints, and the edits that change nothing.
+  if (x < 0 || y < 0 || x >= (int) width || y >= (int) height) return false;
+  if ((finalMaze[y][x] == WALL_ID) == isWall || finalMaze[y][x] == CHECKPOINT_ID) return false;
+  for (const Cell& checkpoint : solutionCheckpoints) {
+    if (checkpoint.x == x && checkpoint.y == y) return false;
+  }
+
+  // Start the clock of the time limits of the solving algorithms again (the repair counts towards them, as the adjacency matrix does).
+  solvingStartTime = chrono::steady_clock::now();
+
+  // Build the distance fields on the first edit of a solved maze (before the layout changes), if they are used.
+  const bool isSolved = !solutionCheckpoints.empty() && !solutionPaths.empty();
+  const unsigned long long fieldsBytes = (unsigned long long) solutionCheckpoints.size() * width * height * sizeof(unsigned int);
+  const bool isRepaired = isSolved && agentsCount == 1 && fieldsBytes <= CHECKPOINT_DISTANCE_FIELDS_MAX_BYTES;
+  if (isRepaired && checkpointDistanceFields.size() != solutionCheckpoints.size()) {
+    buildCheckpointDistanceFields();
+  }
+
+  // Apply the edit.
+  const unsigned int previousId = finalMaze[y][x];
+  finalMaze[y][x] = isWall ? WALL_ID : PATH_ID;
+  invalidateWallDependentStructures(x, y);
+  if (!isSolved) return true;
+
+  // Without the distance fields, undo a wall that would disconnect the checkpoints, or solve the checkpoints again.
+  if (!isRepaired) {
+    if (isWall && !areSolutionCheckpointsConnected()) {
+      finalMaze[y][x] = previousId;
+      invalidateWallDependentStructures(x, y);
+      return false;
+    }
+    eraseSolutionPaths();
+    resolveSolution();
+    return true;
+  }
+
+  // Repair the distance field of each checkpoint.
+  const int cell = y * (int) width + x;
+  for (auto& field : checkpointDistanceFields) {
+    iterationsTookToGenerate += (long long) (isWall ? repairDistanceFieldAfterClosing(field, cell) : repairDistanceFieldAfterOpening(field, cell));
+  }
+
+  // Undo a wall that would disconnect the checkpoints.
+  if (isWall) {
+    for (const auto& field : checkpointDistanceFields) {
+      for (const Cell& checkpoint : solutionCheckpoints) {
+        if (field[checkpoint.y * width + checkpoint.x] == UINT_MAX) {
+          finalMaze[y][x] = previousId;
+          invalidateWallDependentStructures(x, y);
+          for (auto& fieldToRestore : checkpointDistanceFields) {
+            iterationsTookToGenerate += (long long) repairDistanceFieldAfterOpening(fieldToRestore, cell);
+          }
+          return false;
+        }
+      }
+    }
+  }
+
+  // Update the distances between the checkpoints (creating the matrix first if the solver did not need one).
+  bool isMatrixChanged = false;
+  if (solutionMatrix.isOnDemand()) {
+    // The rows of an on-demand matrix were computed from the structures the edit dropped, so they are read from the repaired distance fields
+    // from now on (comparing all the pairs would cost as much as storing them, so the order is always found again).
+    solutionMatrix = DistanceMatrix(solutionCheckpoints.size(), [this](unsigned int row, vector<unsigned int>& distances) {
+      for (unsigned int j = 0; j < solutionCheckpoints.size(); j++) {
+        distances[j] = checkpointDistanceFields[row][solutionCheckpoints[j].y * width + solutionCheckpoints[j].x];
+      }
+    }, DISTANCE_MATRIX_CACHED_ROWS);
+    isMatrixChanged = true;
+  } else {
+    if (solutionMatrix.size != solutionCheckpoints.size()) {
+      solutionMatrix = DistanceMatrix(solutionCheckpoints.size(), (unsigned long long) width * height);
+    }
+    for (int i = 0; i < solutionCheckpoints.size(); i++) {
+      for (int j = i + 1; j < solutionCheckpoints.size(); j++) {
+        unsigned int distance = checkpointDistanceFields[i][solutionCheckpoints[j].y * width + solutionCheckpoints[j].x];
+        if (solutionMatrix.get(i, j) != distance) {
+          solutionMatrix.set(i, j, distance);
+          isMatrixChanged = true;
+        }
+      }
+    }
+  }
+
+  // Remove the marks of the displayed path.
+  eraseSolutionPaths();
+
+  // Find a new order only if a distance changed, and walk it down the distance fields.
+  if (isMatrixChanged) {
+    solutionOrder = solveTsp(solutionMatrix);
+  }
+  rebuildSolutionPath(solutionOrder);
+
+  return true;
+}
+
+// Method that checks whether all the kept checkpoints can still reach each other.
+bool Maze::areSolutionCheckpointsConnected() {
+  // Run a BFS from the first checkpoint and count the checkpoints it reaches.
+  vector<bool> isReached((size_t) width * height, false);
+  vector<int> queue = {solutionCheckpoints[0].y * (int) width + solutionCheckpoints[0].x};
+  isReached[queue[0]] = true;
+  for (size_t head = 0; head < queue.size(); head++) {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(queue[head], direction);
+      if (neighbor != -1 && !isReached[neighbor]) {
+        isReached[neighbor] = true;
+        queue.push_back(neighbor);
+      }
+    }
+  }
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) queue.size();
+
+  return all_of(solutionCheckpoints.begin(), solutionCheckpoints.end(), [&](const Cell& checkpoint) { return isReached[checkpoint.y * (size_t) width + checkpoint.x]; });
+}
+
+// Method that solves the kept checkpoints again from scratch, for all the agents, and marks the new paths on the maze.
+void Maze::resolveSolution() {
+  // Rebuild the structures the edit dropped and the distances between the checkpoints.
+  buildDistanceOracle();
+  if (!distanceOracle.isTree) {
+    buildJunctionGraph();
+  }
+  solutionMatrix = createAdjacencyMatrix(solutionCheckpoints);
+
+  // Route the agents again and find their paths.
+  vector<vector<Cell>> agentOrders = agentsCount > 1 ? tspMultiAgent(solutionMatrix) : vector<vector<Cell>>{solveTsp(solutionMatrix)};
+  solutionOrder = agentsCount == 1 ? agentOrders[0] : vector<Cell>();
+  solutionPaths.clear();
+  for (const vector<Cell>& agentOrder : agentOrders) {
+    solutionPaths.push_back(constructFinalPath(agentOrder, solutionCheckpoints).path);
+  }
+
+  drawSolutionPaths();
+}
+
+// Method that builds the BFS distance field of each checkpoint.
+void Maze::buildCheckpointDistanceFields() {
+  checkpointDistanceFields.assign(solutionCheckpoints.size(), vector<unsigned int>((size_t) width * height, UINT_MAX));
+
+  // Define a function that runs a BFS from a checkpoint.
+  auto buildField = [&](size_t checkpointId) {
+    vector<unsigned int>& field = checkpointDistanceFields[checkpointId];
+    vector<int> queue = {solutionCheckpoints[checkpointId].y * (int) width + solutionCheckpoints[checkpointId].x};
+    field[queue[0]] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+      const int current = queue[head];
+      for (unsigned int direction = 0; direction < 4; direction++) {
+        int neighbor = getOpenNeighborIndex(current, direction);
+        if (neighbor != -1 && field[neighbor] == UINT_MAX) {
+          field[neighbor] = field[current] + 1;
+          queue.push_back(neighbor);
+        }
+      }
+    }
+  };
+
+  // Run the BFS of the checkpoints on the thread pool, one checkpoint per chunk.
+  ThreadPool pool(max(1u, thread::hardware_concurrency()));
+  pool.parallelFor(0, solutionCheckpoints.size(), 1, [&](size_t firstCheckpoint, size_t lastCheckpoint) {
+    for (size_t checkpointId = firstCheckpoint; checkpointId < lastCheckpoint; checkpointId++) {
+      buildField(checkpointId);
+    }
+  });
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) solutionCheckpoints.size() * width * height;
+}
+
+// Method that repairs a distance field after the given cell was opened (distances can only decrease).
+unsigned long long Maze::repairDistanceFieldAfterOpening(vector<unsigned int>& field, int cell) {
+  // The opened cell is reached through its closest neighbor.
+  for (unsigned int direction = 0; direction < 4; direction++) {
+    int neighbor = getOpenNeighborIndex(cell, direction);
+    if (neighbor != -1 && field[neighbor] != UINT_MAX) {
+      field[cell] = min(field[cell], field[neighbor] + 1);
+    }
+  }
+  if (field[cell] == UINT_MAX) return 1;
+
+  // Propagate the shorter distances outwards for as long as they improve.
+  vector<int> queue = {cell};
+  for (size_t head = 0; head < queue.size(); head++) {
+    const int current = queue[head];
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(current, direction);
+      if (neighbor != -1 && field[neighbor] > field[current] + 1) {
+        field[neighbor] = field[current] + 1;
+        queue.push_back(neighbor);
+      }
+    }
+  }
+
+  return queue.size();
+}
+
+// Method that repairs a distance field after the given cell became a wall (only the cells whose shortest paths all used it are recomputed).
+unsigned long long Maze::repairDistanceFieldAfterClosing(vector<unsigned int>& field, int cell) {
+  if (field[cell] == UINT_MAX) return 1;
+
+  // Find the affected cells in the order of their old distances: a cell is affected if none of its neighbors one step closer is unaffected.
+  vector<int> affected;
+  vector<pair<int, unsigned int>> queue = {{cell, field[cell]}};
+  field[cell] = UINT_MAX;
+  for (size_t head = 0; head < queue.size(); head++) {
+    auto [current, distance] = queue[head];
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(current, direction);
+      if (neighbor == -1 || field[neighbor] != distance + 1) continue;
+
+      // Check whether the neighbor still has a parent one step closer.
+      bool isSupported = false;
+      for (unsigned int parentDirection = 0; parentDirection < 4 && !isSupported; parentDirection++) {
+        int parent = getOpenNeighborIndex(neighbor, parentDirection);
+        isSupported = parent != -1 && field[parent] == distance;
+      }
+      if (!isSupported) {
+        affected.push_back(neighbor);
+        queue.emplace_back(neighbor, field[neighbor]);
+        field[neighbor] = UINT_MAX;
+      }
+    }
+  }
+
+  // Seed the affected cells from their unaffected neighbors and propagate the new distances through them.
+  priority_queue<pair<unsigned int, int>, vector<pair<unsigned int, int>>, greater<>> seeds;
+  for (int affectedCell : affected) {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(affectedCell, direction);
+      if (neighbor != -1 && field[neighbor] != UINT_MAX && field[neighbor] + 1 < field[affectedCell]) {
+        field[affectedCell] = field[neighbor] + 1;
+      }
+    }
+    if (field[affectedCell] != UINT_MAX) {
+      seeds.push({field[affectedCell], affectedCell});
+    }
+  }
+  while (!seeds.empty()) {
+    auto [distance, current] = seeds.top();
+    seeds.pop();
+    if (distance != field[current]) continue;
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(current, direction);
+      if (neighbor != -1 && field[neighbor] > distance + 1) {
+        field[neighbor] = distance + 1;
+        seeds.push({distance + 1, neighbor});
+      }
+    }
+  }
+
+  return queue.size() + affected.size();
+}
+
+// Method that drops the structures that depend on the layout of the walls.
+void Maze::invalidateWallDependentStructures(int x, int y) {
+  distanceOracle = DistanceOracle();
+  junctionGraph = JunctionGraph();
+  checkpointNodeDistances.clear();
+  checkpointPredecessorCorridors.clear();
+
+  // The bitboard and the clusters are cheap to patch in place.
+  if (openCells.width == width && openCells.height == height) {
+    if (finalMaze[y][x] == WALL_ID) {
+      openCells.reset(x, y);
+    } else {
+      openCells.set(x, y);
+    }
+  }
+  if (clusterGraph.cellEntranceIds.size() == (size_t) width * height) {
+    clusterGraph.updateCell(finalMaze, x, y);
+  }
+}
+
+// Method that walks the solution order down the distance fields and marks the resulting path on the maze.
+void Maze::rebuildSolutionPath(const vector<Cell>& checkpointsOrder) {
+  // Index the checkpoint IDs by their cell index.
+  vector<int> checkpointIds((size_t) width * height, -1);
+  for (int i = 0; i < solutionCheckpoints.size(); i++) {
+    checkpointIds[solutionCheckpoints[i].y * (int) width + solutionCheckpoints[i].x] = i;
+  }
+
+  // Find the checkpoint IDs of the order.
+  vector<int> orderIds;
+  for (const Cell& checkpoint : checkpointsOrder) {
+    orderIds.push_back(checkpointIds[checkpoint.y * (int) width + checkpoint.x]);
+  }
+
+  // Walk each leg by stepping to a neighbor one step closer to the next checkpoint, until all the checkpoints are passed.
+  vector<Cell> path = {checkpointsOrder[0]};
+  vector<bool> isPassed(solutionCheckpoints.size(), false);
+  isPassed[orderIds[0]] = true;
+  unsigned int passedCheckpointsCount = 1;
+  for (int i = 0; i + 1 < checkpointsOrder.size() && passedCheckpointsCount < checkpointsOrder.size(); i++) {
+    const vector<unsigned int>& field = checkpointDistanceFields[orderIds[i + 1]];
+    int current = checkpointsOrder[i].y * (int) width + checkpointsOrder[i].x;
+    while (field[current] != 0 && passedCheckpointsCount < checkpointsOrder.size()) {
+      for (unsigned int direction = 0; direction < 4; direction++) {
+        int neighbor = getOpenNeighborIndex(current, direction);
+        if (neighbor != -1 && field[neighbor] + 1 == field[current]) {
+          current = neighbor;
+          break;
+        }
+      }
+      path.emplace_back(current % (int) width, current / (int) width);
+
+      // Count the checkpoints passed on the way.
+      const int checkpointId = checkpointIds[current];
+      if (checkpointId != -1 && !isPassed[checkpointId]) {
+        isPassed[checkpointId] = true;
+        passedCheckpointsCount++;
+      }
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
+    }
+  }
+
+  // Keep the new path and mark it on the maze.
+  solutionPaths = {path};
+  drawSolutionPaths();
+}
+
+// Method that removes the marks of the kept paths from the maze (the solving algorithms look the checkpoints up on the maze).
+void Maze::eraseSolutionPaths() {
+  for (const vector<Cell>& path : solutionPaths) {
+    for (const Cell& pathCell : path) {
+      if (finalMaze[pathCell.y][pathCell.x] != WALL_ID) {
+        finalMaze[pathCell.y][pathCell.x] = PATH_ID;
+      }
+    }
+  }
+  for (const Cell& checkpoint : solutionCheckpoints) {
+    finalMaze[checkpoint.y][checkpoint.x] = CHECKPOINT_ID;
+  }
+}
+
+// Method that marks the kept paths on the maze at once (in the color of each agent, if there are several) and sets the minimum path length.
+void Maze::drawSolutionPaths() {
+  minPathLength = 0;
+  for (unsigned int agent = 0; agent < solutionPaths.size(); agent++) {
+    const vector<Cell>& path = solutionPaths[agent];
+    if (path.empty()) continue;
+    for (const Cell& pathCell : path) {
+      finalMaze[pathCell.y][pathCell.x] = solutionPaths.size() > 1 ? (unsigned int) (AGENT_PATH_ID + agent) : (unsigned int) PASSED_PATH_ID;
+    }
+
+    // Set the minimum path length (of the longest path, or of all the paths together, if the agents minimize their total length).
+    if (agentObjective == AgentObjective::MIN_TOTAL_LENGTH) {
+      minPathLength += (unsigned int) (path.size() - 1);
+    } else {
+      minPathLength = max(minPathLength, (unsigned int) (path.size() - 1));
+    }
+  }
+  for (const Cell& checkpoint : solutionCheckpoints) {
+    finalMaze[checkpoint.y][checkpoint.x] = PASSED_CHECKPOINT_ID;
+  }
+  for (const vector<Cell>& path : solutionPaths) {
+    if (path.empty()) continue;
+    finalMaze[path.front().y][path.front().x] = START_ID;
+    finalMaze[path.back().y][path.back().x] = END_ID;
+  }
+}
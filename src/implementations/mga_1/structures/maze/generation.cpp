@@ -20,7 +20,10 @@ void Maze::generateMaze() {
       cout << "  - Checkpoints percentage: " << checkpointsValue << "%" << "\n";
       break;
   }
-  cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n\n";
+  cout << "  - Solving algorithm: " << getSolvingAlgorithmName() << "\n";
+  cout << "  - Route type: " << getRouteTypeName() << "\n";
+  cout << "  - Agents: " << agentsCount << (agentsCount > 1 ? " (" + getAgentObjectiveName() + ")" : "") << "\n";
+  cout << "  - Seed: " << seed << "\n\n";
 
   // Wait for user input.
   waitForEnter(colorString("Press the \"Enter\" key to start the maze generation...", "green", "black", "bold"));
@@ -196,8 +199,12 @@ unsigned int Maze::distributeCheckpoints() {
   unsigned int maxNumberOfCheckpoints;
   if (solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP_PARALLEL || solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP) {
     maxNumberOfCheckpoints = min(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP, pathCellsCount);
+  } else if (solvingAlgorithm == SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE) {
+    maxNumberOfCheckpoints = min(MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP_OUT_OF_CORE, pathCellsCount);
   } else if (solvingAlgorithm == SupportedSolvingAlgorithms::BRUTE_FORCE) {
     maxNumberOfCheckpoints = min(MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE, pathCellsCount);
+  } else if (solvingAlgorithm == SupportedSolvingAlgorithms::BRANCH_AND_BOUND) {
+    maxNumberOfCheckpoints = min(MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND, pathCellsCount);
   } else {
     maxNumberOfCheckpoints = pathCellsCount;
   }
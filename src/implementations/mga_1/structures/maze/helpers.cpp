@@ -10,6 +10,13 @@ bool Maze::isValidPath(int x, int y) {
   return x >= 0 && y >= 0 && x < width && y < height && finalMaze[y][x] != WALL_ID;
 }
 
+// Method that returns the index of the open neighbor of a cell in the given direction (-1 if there is none).
+int Maze::getOpenNeighborIndex(int cellIndex, unsigned int direction) {
+  int x = cellIndex % (int) width + NEIGHBOR_OFFSETS[direction][0];
+  int y = cellIndex / (int) width + NEIGHBOR_OFFSETS[direction][1];
+  return isValidPath(x, y) ? y * (int) width + x : -1;
+}
+
 // Method that gets all checkpoints from the maze.
 vector<Cell> Maze::getCheckpoints() {
   // Declare the checkpoints vector.
@@ -85,6 +92,78 @@ string Maze::getSolvingAlgorithmName(bool noColors) {
   return solvingAlgorithmName;
 }
 
+// Method that checks whether the chosen solving algorithm proves its route optimal (the Steiner tree only on a perfect maze, otherwise it falls back to the portfolio).
+bool Maze::isSolvingAlgorithmExact() {
+  switch (solvingAlgorithm) {
+    case SupportedSolvingAlgorithms::HELD_KARP:
+    case SupportedSolvingAlgorithms::HELD_KARP_PARALLEL:
+    case SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE:
+    case SupportedSolvingAlgorithms::BRUTE_FORCE:
+    case SupportedSolvingAlgorithms::BRANCH_AND_BOUND:
+      return true;
+    case SupportedSolvingAlgorithms::STEINER_TREE:
+      return distanceOracle.isTree;
+    default:
+      return false;
+  }
+}
+
+// Method that checks whether the route is an open path (rather than a closed tour).
+bool Maze::isRouteOpen() const {
+  return routeType != RouteType::CLOSED_TOUR;
+}
+
+// Method that gets the name of the route type.
+string Maze::getRouteTypeName(bool noColors) {
+  // Define the route types.
+  vector<pair<RouteType, string>> routeTypes = noColors ? SUPPORTED_ROUTE_TYPES_NO_COLOR_STRINGS : SUPPORTED_ROUTE_TYPES;
+
+  // Find the name of the route type.
+  for (auto& type : routeTypes) {
+    if (type.first == routeType) {
+      return type.second;
+    }
+  }
+
+  // Return an empty name if the route type was not found.
+  return "";
+}
+
+// Method that gets the name of the objective of the agents.
+string Maze::getAgentObjectiveName(bool noColors) {
+  // Define the objectives.
+  vector<pair<AgentObjective, string>> objectives = noColors ? SUPPORTED_AGENT_OBJECTIVES_NO_COLOR_STRINGS : SUPPORTED_AGENT_OBJECTIVES;
+
+  // Find the name of the objective.
+  for (auto& objective : objectives) {
+    if (objective.first == agentObjective) {
+      return objective.second;
+    }
+  }
+
+  // Return an empty name if the objective was not found.
+  return "";
+}
+
+// Method that gets the name of a point-to-point search algorithm.
+string Maze::getPathSearchAlgorithmName(PathSearchAlgorithm algorithm) {
+  // Find the name of the search algorithm.
+  for (auto& searchAlgorithm : PATH_SEARCH_ALGORITHM_NAMES) {
+    if (searchAlgorithm.first == algorithm) {
+      return searchAlgorithm.second;
+    }
+  }
+
+  // Return an empty name if the search algorithm was not found.
+  return "";
+}
+
+// Method that gets the statistics of the searches of the legs of the route (empty if no leg was searched).
+string Maze::getLegSearchesStatistics() {
+  if (legSearchesCount == 0) return "";
+  return "  - Legs searched with " + getPathSearchAlgorithmName(DEFAULT_PATH_SEARCH_ALGORITHM) + ": " + splitNumberIntoBlocks(legSearchesCount) + " (" + splitNumberIntoBlocks(legSearchExpandedNodes) + " nodes expanded).\n";
+}
+
 // Method that generates the maze report file.
 string Maze::generateMazeReportFile() {
   // Declare the report.
@@ -92,11 +171,11 @@ string Maze::generateMazeReportFile() {
 
   // Append the maze visualization.
   report << "Maze visualization:\n";
-  report << printMazeState(finalMaze, false, true, true) << "\n";
+  report << printMazeState<false, true>(finalMaze, true) << "\n";
 
   // Append the raw maze.
   report << "Raw maze:\n";
-  report << printMazeState(finalMaze, true, true) << "\n";
+  report << printMazeState<true, false>(finalMaze, true) << "\n";
 
   // Append the maze parameters.
   report << "Maze parameters:\n";
@@ -110,7 +189,10 @@ string Maze::generateMazeReportFile() {
       report << "  - Checkpoints percentage: " << checkpointsValue << "%" << "\n";
       break;
   }
-  report << "  - Solving algorithm: " << getSolvingAlgorithmName(true) << "\n\n";
+  report << "  - Solving algorithm: " << getSolvingAlgorithmName(true) << "\n";
+  report << "  - Route type: " << getRouteTypeName(true) << "\n";
+  report << "  - Agents: " << agentsCount << (agentsCount > 1 ? " (" + getAgentObjectiveName(true) + ")" : "") << "\n";
+  report << "  - Seed: " << seed << "\n\n";
 
   // Append the maze generation statistics.
   if (minPathLength > 0 || actualNumberOfCheckpoints > 0) {
@@ -119,6 +201,7 @@ string Maze::generateMazeReportFile() {
   if (minPathLength > 0) {
     report << "  - Minimum path length: " << minPathLength << " cells.\n";
   }
+  report << getLegSearchesStatistics();
   if (actualNumberOfCheckpoints > 0) {
     report << "  - Number of checkpoints: " << actualNumberOfCheckpoints << ".\n\n";
   }
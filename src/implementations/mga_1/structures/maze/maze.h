@@ -8,15 +8,35 @@
 #include <algorithm>
 #include <utility>
 #include <thread>
+#include <chrono>
 #include <atomic>
 #include <mutex>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
+#include <memory>
+#include <charconv>
 #include <SFML/Audio.hpp>
 #include "../cell/cell.h"
 #include "../path/path.h"
+#include "../compact_path/compact_path.h"
 #include "../direction/direction.h"
+#include "../distance_oracle/distance_oracle.h"
+#include "../search_result/search_result.h"
+#include "../distance_matrix/distance_matrix.h"
+#include "../held_karp/held_karp.h"
+#include "../tour/tour.h"
+#include "../annealing/annealing.h"
+#include "../branch_and_bound/branch_and_bound.h"
+#include "../brute_force/brute_force.h"
+#include "../solver_context/solver_context.h"
+#include "../steiner_tree/steiner_tree.h"
+#include "../agent_partition/agent_partition.h"
+#include "../solution_cache/solution_cache.h"
+#include "../junction_graph/junction_graph.h"
+#include "../cluster_graph/cluster_graph.h"
 #include "../../../../helpers/helpers.h"
+#include "../../../../helpers/bitboard.h"
 #include "../../constants/constants.h"
 #include "../../models/models.h"
 
@@ -32,12 +52,39 @@ class Maze {
   unsigned int checkpointsValue;
   CheckpointSettingType checkpointSettingType;
   SupportedSolvingAlgorithms solvingAlgorithm;
+  RouteType routeType;
+  unsigned int agentsCount;
+  AgentObjective agentObjective;
+  unsigned int seed;
 
   // Maze internal variables.
   vector<vector<unsigned int>> finalMaze;
   vector<vector<vector<unsigned int>>> generationSteps;
   string executablePath;
   time_t generationTimestamp;
+  DistanceOracle distanceOracle;
+  JunctionGraph junctionGraph;
+  ClusterGraph clusterGraph;
+  vector<vector<unsigned int>> checkpointNodeDistances;
+  vector<vector<int>> checkpointPredecessorCorridors;
+  Bitboard openCells;
+
+  // The last solution, kept so that wall edits can repair it (the order only if there is a single agent, and a path per agent),
+  // and the distance field of each checkpoint (built on the first edit, if a single agent is routed and the fields fit the memory budget).
+  vector<Cell> solutionCheckpoints;
+  DistanceMatrix solutionMatrix;
+  vector<Cell> solutionOrder;
+  vector<vector<Cell>> solutionPaths;
+  vector<vector<unsigned int>> checkpointDistanceFields;
+
+  // The time the solving of the checkpoints started (the time limits of the anytime and portfolio modes cover the adjacency matrix too).
+  chrono::steady_clock::time_point solvingStartTime;
+
+  // Point-to-point search buffers, reused between queries and invalidated by bumping the stamp.
+  vector<unsigned int> searchStamps;
+  vector<int> searchParents;
+  vector<unsigned int> searchCosts;
+  unsigned int currentSearchStamp = 0;
 
   // Maze generation statistics.
   long long timePerformanceMs = 0;
@@ -46,10 +93,15 @@ class Maze {
   unsigned int minPathLength = 0;
   unsigned int requestedNumberOfCheckpoints = 0;
   unsigned int actualNumberOfCheckpoints = 0;
+  unsigned long long legSearchesCount = 0;
+  unsigned long long legSearchExpandedNodes = 0;
+
+  // The tests check the internal structures of the maze.
+  friend class MazeTest;
 
  public:
   // Constructor.
-  Maze(unsigned int _width, unsigned int _height, unsigned int _checkpointsValue, CheckpointSettingType checkpointSettingType, SupportedSolvingAlgorithms _solvingAlgorithm, string _executablePath);
+  Maze(unsigned int _width, unsigned int _height, unsigned int _checkpointsValue, CheckpointSettingType checkpointSettingType, SupportedSolvingAlgorithms _solvingAlgorithm, RouteType _routeType, unsigned int _agentsCount, AgentObjective _agentObjective, unsigned int _seed, string _executablePath);
 
   // Method that generates the maze.
   void generateMaze();
@@ -60,26 +112,139 @@ class Maze {
   // Method that generates the solution.
   void generateSolution();
 
-  // Method that returns the shortest path between each pair of checkpoints.
-  vector<Path> findShortestPathsBetweenEachPairOfCheckpoints();
+  // Method that marks the paths of the agents on the maze step by step, all the agents moving at once.
+  void markSolutionPaths(const vector<Path>& paths, const vector<Cell>& checkpoints);
+
+  // Method that builds the distance oracle of the maze.
+  void buildDistanceOracle();
+
+  // Method that contracts the maze into a junction graph.
+  void buildJunctionGraph();
+
+  // Method that partitions the maze into clusters for the hierarchical pathfinder.
+  void buildClusterGraph();
+
+  // Method that returns the shortest path between two checkpoints given by their IDs.
+  CompactPath findShortestPathBetweenCheckpoints(unsigned int firstId, unsigned int secondId, const vector<Cell>& checkpoints);
 
   // Method that returns the shortest path between two cells.
-  Path findShortestPathBetweenCells(Cell startCell, Cell endCell);
+  Path findShortestPathBetweenCells(Cell startCell, Cell endCell, PathSearchAlgorithm algorithm = DEFAULT_PATH_SEARCH_ALGORITHM);
+
+  // Method that searches the shortest path between two cells with the chosen algorithm and reports the expanded nodes.
+  SearchResult searchShortestPath(Cell startCell, Cell endCell, PathSearchAlgorithm algorithm);
+
+  // Method that searches the shortest path between two cells using breadth-first search.
+  SearchResult searchBreadthFirst(Cell startCell, Cell endCell);
+
+  // Method that searches the shortest path between two cells using bidirectional breadth-first search.
+  SearchResult searchBidirectionalBreadthFirst(Cell startCell, Cell endCell);
+
+  // Method that searches the shortest path between two cells using A* with the Manhattan distance heuristic.
+  SearchResult searchAStar(Cell startCell, Cell endCell);
 
-  // Method that creates an adjacency matrix from a list of paths.
-  vector<vector<double>> createAdjacencyMatrix(const vector<Path>& paths);
+  // Method that searches the shortest path between two cells using Dijkstra on the junction graph.
+  SearchResult searchJunctionGraph(Cell startCell, Cell endCell);
+
+  // Method that searches the shortest path between two cells using the hierarchical pathfinder.
+  SearchResult searchHierarchical(Cell startCell, Cell endCell);
+
+  // Method that builds the bitboard of the open cells.
+  void buildOpenCellsBitboard();
+
+  // Method that prepares the search buffers for a new query.
+  void resetSearchBuffers();
+
+  // Method that creates an adjacency matrix of the checkpoints.
+  DistanceMatrix createAdjacencyMatrix(const vector<Cell>& checkpoints);
+
+  // Method that creates an adjacency matrix of the checkpoints using bit-parallel multi-source BFS.
+  DistanceMatrix createAdjacencyMatrixMultiSourceBfs(const vector<Cell>& checkpoints);
+
+  // Method that applies the chosen traveling salesman problem solving algorithm to the adjacency matrix.
+  vector<Cell> solveTsp(const DistanceMatrix& matrix);
 
   // Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in a single thread.
-  vector<Cell> tspHeldKarp(vector<vector<double>> adjacencyMatrix);
+  vector<Cell> tspHeldKarp(const DistanceMatrix& adjacencyMatrix);
 
   // Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in multiple threads.
-  vector<Cell> tspHeldKarpParallel(vector<vector<double>> adjacencyMatrix);
+  vector<Cell> tspHeldKarpParallel(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm with the table kept in a file.
+  vector<Cell> tspHeldKarpOutOfCore(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that implements the traveling salesman problem using a construction heuristic (nearest neighbor or greedy edge) improved by 2-opt and Or-opt.
+  vector<Cell> tspLocalSearch(const DistanceMatrix& adjacencyMatrix, bool isGreedyEdge);
+
+  // Method that implements the traveling salesman problem using simulated annealing on an island per thread.
+  vector<Cell> tspAnnealing(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that implements the traveling salesman problem using branch and bound with 1-tree bounds and runs it in multiple threads.
+  vector<Cell> tspBranchAndBound(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that implements the traveling salesman problem exactly on a perfect maze by walking the Steiner subtree of the checkpoints.
+  vector<Cell> tspSteinerTree(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that implements the traveling salesman problem as an anytime search that has a route at once and improves it until the time limit.
+  vector<Cell> tspAnytime(const DistanceMatrix& adjacencyMatrix);
 
-  // Method that implements the traveling salesman problem using brute force algorithm.
-  vector<Cell> tspBruteForce(vector<vector<double>> adjacencyMatrix);
+  // Method that implements the traveling salesman problem as a portfolio of the solvers that fit the number of checkpoints, raced against each other.
+  vector<Cell> tspPortfolio(const DistanceMatrix& adjacencyMatrix);
 
-  // Method that constructs the final path from the order of the checkpoints and the paths.
-  Path constructFinalPath(vector<Cell> checkpointsOrder, const vector<Path>& paths);
+  // Method that races the solvers on the same matrix, sharing the best route between them, until one of them proves a route optimal
+  // (and the others are cancelled) or the time limit runs out.
+  vector<Cell> tspRace(const DistanceMatrix& adjacencyMatrix, long long timeLimitMs, bool isPortfolio);
+
+  // Method that splits the checkpoints among the agents and routes each agent with the chosen solving algorithm. Returns the order of each agent.
+  vector<vector<Cell>> tspMultiAgent(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that routes a single agent through its checkpoints with the chosen solving algorithm, in a single thread and without any output
+  // (the agents are routed in parallel). Returns the order of the indices of the checkpoints.
+  vector<unsigned int> solveAgentRoute(const vector<Cell>& agentCheckpoints, const DistanceMatrix& agentMatrix, unsigned long long& iterations) const;
+
+  // Method that implements the traveling salesman problem using brute force algorithm (a pruned depth-first search) and runs it in multiple threads.
+  vector<Cell> tspBruteForce(const DistanceMatrix& adjacencyMatrix);
+
+  // Method that constructs the final path from the order of the checkpoints, finding the path of each leg on demand.
+  Path constructFinalPath(const vector<Cell>& checkpointsOrder, const vector<Cell>& checkpoints);
+
+  // Method that returns the length of a route through the checkpoints (including the way back to the first checkpoint, if the route is a closed tour),
+  // read from the matrix, or from the distance oracle if no matrix was needed.
+  unsigned long long getRouteLength(const vector<unsigned int>& order, const vector<Cell>& checkpoints, const DistanceMatrix& matrix) const;
+
+  // Method that lets the user turn cells into walls or open them, and prints the maze with the repaired solution after each edit.
+  void editWalls();
+
+  // Method that turns a cell into a wall or opens it and repairs the checkpoint distances and the solution incrementally
+  // (the routes of several agents, or the ones whose distance fields would not fit the memory budget, are solved again instead).
+  // Returns false if the edit is not allowed (out of bounds, a checkpoint, no change, or it would disconnect the checkpoints).
+  bool setWall(int x, int y, bool isWall);
+
+  // Method that checks whether all the kept checkpoints can still reach each other.
+  bool areSolutionCheckpointsConnected();
+
+  // Method that solves the kept checkpoints again from scratch, for all the agents, and marks the new paths on the maze.
+  void resolveSolution();
+
+  // Method that builds the BFS distance field of each checkpoint.
+  void buildCheckpointDistanceFields();
+
+  // Method that repairs a distance field after the given cell was opened (distances can only decrease).
+  unsigned long long repairDistanceFieldAfterOpening(vector<unsigned int>& field, int cell);
+
+  // Method that repairs a distance field after the given cell became a wall (only the cells whose shortest paths all used it are recomputed).
+  unsigned long long repairDistanceFieldAfterClosing(vector<unsigned int>& field, int cell);
+
+  // Method that drops the structures that depend on the layout of the walls.
+  void invalidateWallDependentStructures(int x, int y);
+
+  // Method that walks the solution order down the distance fields and marks the resulting path on the maze.
+  void rebuildSolutionPath(const vector<Cell>& checkpointsOrder);
+
+  // Method that removes the marks of the kept paths from the maze (the solving algorithms look the checkpoints up on the maze).
+  void eraseSolutionPaths();
+
+  // Method that marks the kept paths on the maze at once (in the color of each agent, if there are several) and sets the minimum path length.
+  void drawSolutionPaths();
 
   // Method that visualizes the maze generation.
   void visualizeMazeGeneration(unsigned int minVisualizationDurationMs);
@@ -90,8 +255,9 @@ class Maze {
   // Method that saves the maze generation steps as a JSON to a file.
   void saveMazeGenerationStepsAsJson();
 
-  // Method that prints the maze state.
-  static string printMazeState(const vector<vector<unsigned int>>& mazeState, bool printAsIDs = PRINT_MAZE_AS_IDS, bool noOutput = false, bool noColors = false);
+  // Method that prints the maze state (returns the frame, which is kept until the next call).
+  template<bool printAsIDs = PRINT_MAZE_AS_IDS, bool noColors = false>
+  static const string& printMazeState(const vector<vector<unsigned int>>& mazeState, bool noOutput = false);
 
   // Method that filters out the steps where anything is not changing.
   void filterSteps();
@@ -105,6 +271,9 @@ class Maze {
   // Method that checks if a cell is valid path.
   bool isValidPath(int x, int y);
 
+  // Method that returns the index of the open neighbor of a cell in the given direction (-1 if there is none).
+  int getOpenNeighborIndex(int cellIndex, unsigned int direction);
+
   // Method that gets all checkpoints from the maze.
   vector<Cell> getCheckpoints();
 
@@ -117,6 +286,24 @@ class Maze {
   // Method that gets the solving algorithm name.
   string getSolvingAlgorithmName(bool noColors = false);
 
+  // Method that checks whether the chosen solving algorithm proves its route optimal.
+  bool isSolvingAlgorithmExact();
+
+  // Method that checks whether the route is an open path (rather than a closed tour).
+  bool isRouteOpen() const;
+
+  // Method that gets the name of the route type.
+  string getRouteTypeName(bool noColors = false);
+
+  // Method that gets the name of the objective of the agents.
+  string getAgentObjectiveName(bool noColors = false);
+
+  // Method that gets the name of a point-to-point search algorithm.
+  static string getPathSearchAlgorithmName(PathSearchAlgorithm algorithm);
+
+  // Method that gets the statistics of the searches of the legs of the route (empty if no leg was searched).
+  string getLegSearchesStatistics();
+
   // Method that generates the maze report file.
   string generateMazeReportFile();
 
@@ -1,109 +1,64 @@
 #include "maze.h"
 
 // Method that prints the maze state.
-string Maze::printMazeState(const vector<vector<unsigned int>>& mazeState, bool printAsIDs, bool noOutput, bool noColors) {
-  string output;
+template<bool printAsIDs, bool noColors>
+const string& Maze::printMazeState(const vector<vector<unsigned int>>& mazeState, bool noOutput) {
+  // The frame is written into the same buffer every time, which keeps its capacity between the frames.
+  static string frame;
+  frame.clear();
+
+  // Reserve room for the largest frame (every cell in its own color run, or as a padded ID of up to 10 digits and a space).
+  size_t maxCellLength = max<size_t>(CELL_ID_WIDTH, 10) + 1;
+  for (const CellGlyph& glyph : CELL_GLYPHS) {
+    maxCellLength = max(maxCellLength, glyph.escapeSequence.size() + glyph.symbol.size() + RESET_ESCAPE_SEQUENCE.size());
+  }
+  size_t maxFrameLength = 0;
   for (const auto& row : mazeState) {
-    for (const auto& cell : row) {
-      switch (cell) {
-        case WALL_ID:
-          if (printAsIDs) {
-            output += to_string(WALL_ID);
-          } else {
-            if (noColors) {
-              output += WALL_SYMBOL;
-            } else {
-              output += colorString(WALL_SYMBOL, "white", "white", "default");
-            }
-          }
-          break;
-        case PATH_ID:
-          if (printAsIDs) {
-            output += to_string(PATH_ID);
-          } else {
-            if (noColors) {
-              output += PATH_SYMBOL;
-            } else {
-              output += colorString(PATH_SYMBOL, "green", "black", "default");
-            }
-          }
-          break;
-        case CHECKPOINT_ID:
-          if (printAsIDs) {
-            output += to_string(CHECKPOINT_ID);
-          } else {
-            if (noColors) {
-              output += CHECKPOINT_SYMBOL;
-            } else {
-              output += colorString(CHECKPOINT_SYMBOL, "yellow", "black", "bold");
-            }
-          }
-          break;
-        case PASSED_CHECKPOINT_ID:
-          if (printAsIDs) {
-            output += to_string(PASSED_CHECKPOINT_ID);
-          } else {
-            if (noColors) {
-              output += PASSED_CHECKPOINT_SYMBOL;
-            } else {
-              output += colorString(PASSED_CHECKPOINT_SYMBOL, "white", "green", "bold");
-            }
-          }
-          break;
-        case PASSED_PATH_ID:
-          if (printAsIDs) {
-            output += to_string(PASSED_PATH_ID);
-          } else {
-            if (noColors) {
-              output += PASSED_PATH_SYMBOL;
-            } else {
-              output += colorString(PASSED_PATH_SYMBOL, "green", "black", "default");
-            }
-          }
-          break;
-        case CURRENT_POSITION_ID:
-          if (printAsIDs) {
-            output += to_string(CURRENT_POSITION_ID);
-          } else {
-            if (noColors) {
-              output += CURRENT_POSITION_SYMBOL;
-            } else {
-              output += colorString(CURRENT_POSITION_SYMBOL, "green", "yellow", "default");
-            }
-          }
-          break;
-        case START_ID:
-          if (printAsIDs) {
-            output += to_string(START_ID);
-          } else {
-            if (noColors) {
-              output += START_SYMBOL;
-            } else {
-              output += colorString(START_SYMBOL, "white", "green", "bold");
-            }
-          }
-          break;
-        case END_ID:
-          if (printAsIDs) {
-            output += to_string(END_ID);
-          } else {
-            if (noColors) {
-              output += END_SYMBOL;
-            } else {
-              output += colorString(END_SYMBOL, "white", "red", "bold");
+    maxFrameLength += row.size() * maxCellLength + RESET_ESCAPE_SEQUENCE.size() + 1;
+  }
+  frame.reserve(maxFrameLength);
+
+  for (const auto& row : mazeState) {
+    // The cells in a row with the same colors share a single escape sequence (the colors are reset at the end of the run).
+    string_view runEscapeSequence;
+    const size_t rowStart = frame.size();
+    for (const unsigned int cell : row) {
+      if constexpr (printAsIDs) {
+        // Separate the cells and pad the ID to the width of the largest one, so that the columns stay aligned.
+        char digits[16];
+        const size_t digitsCount = to_chars(digits, digits + sizeof(digits), cell).ptr - digits;
+        if (frame.size() > rowStart) frame += ' ';
+        if (digitsCount < CELL_ID_WIDTH) frame.append(CELL_ID_WIDTH - digitsCount, ' ');
+        frame.append(digits, digitsCount);
+      } else {
+        const CellGlyph& glyph = cell < CELL_GLYPHS_COUNT ? CELL_GLYPHS[cell] : UNKNOWN_CELL_GLYPH;
+        if constexpr (!noColors) {
+          if (glyph.escapeSequence != runEscapeSequence) {
+            if (!runEscapeSequence.empty()) {
+              frame += RESET_ESCAPE_SEQUENCE;
             }
+            frame += glyph.escapeSequence;
+            runEscapeSequence = glyph.escapeSequence;
           }
-          break;
-        default:
-          output += "E ";
+        }
+        frame += glyph.symbol;
       }
     }
-    output += "\n";
+    if (!runEscapeSequence.empty()) {
+      frame += RESET_ESCAPE_SEQUENCE;
+    }
+    frame += '\n';
   }
 
   if (!noOutput) {
-    fwrite(output.c_str(), sizeof(char), output.size(), stdout);
+    fwrite(frame.data(), sizeof(char), frame.size(), stdout);
   }
 
-  return output;
+  return frame;
 }
+
+// The instances of the method that prints the maze state.
+template const string& Maze::printMazeState<false, false>(const vector<vector<unsigned int>>& mazeState, bool noOutput);
+template const string& Maze::printMazeState<false, true>(const vector<vector<unsigned int>>& mazeState, bool noOutput);
+template const string& Maze::printMazeState<true, false>(const vector<vector<unsigned int>>& mazeState, bool noOutput);
+template const string& Maze::printMazeState<true, true>(const vector<vector<unsigned int>>& mazeState, bool noOutput);
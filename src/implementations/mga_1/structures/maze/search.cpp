@@ -0,0 +1,338 @@
+#include "maze.h"
+
+// Method that returns the shortest path between two cells.
+Path Maze::findShortestPathBetweenCells(Cell startCell, Cell endCell, PathSearchAlgorithm algorithm) {
+  return searchShortestPath(startCell, endCell, algorithm).path;
+}
+
+// Method that searches the shortest path between two cells with the chosen algorithm and reports the expanded nodes.
+SearchResult Maze::searchShortestPath(Cell startCell, Cell endCell, PathSearchAlgorithm algorithm) {
+  switch (algorithm) {
+    case PathSearchAlgorithm::BIDIRECTIONAL_BREADTH_FIRST:
+      return searchBidirectionalBreadthFirst(startCell, endCell);
+    case PathSearchAlgorithm::A_STAR:
+      return searchAStar(startCell, endCell);
+    case PathSearchAlgorithm::JUNCTION_GRAPH:
+      return searchJunctionGraph(startCell, endCell);
+    case PathSearchAlgorithm::HIERARCHICAL:
+      return searchHierarchical(startCell, endCell);
+    default:
+      return searchBreadthFirst(startCell, endCell);
+  }
+}
+
+// Method that searches the shortest path between two cells using breadth-first search.
+SearchResult Maze::searchBreadthFirst(Cell startCell, Cell endCell) {
+  // Prepare the search buffers and the bitboard of the open cells.
+  resetSearchBuffers();
+  if (openCells.width != width || openCells.height != height) {
+    buildOpenCellsBitboard();
+  }
+  const int start = startCell.y * (int) width + startCell.x;
+  const int end = endCell.y * (int) width + endCell.x;
+
+  // Create the frontier bitboards and add the start cell to them.
+  Bitboard visited(width, height);
+  Bitboard frontier(width, height);
+  Bitboard next(width, height);
+  visited.set(startCell.x, startCell.y);
+  frontier.set(startCell.x, startCell.y);
+  searchStamps[start] = currentSearchStamp;
+  searchCosts[start] = 0;
+
+  // Expand whole BFS layers at once until the end cell is reached, processing only the rows the frontier spans.
+  unsigned long long expandedNodes = 0;
+  unsigned long long frontierSize = 1;
+  unsigned int firstRow = startCell.y;
+  unsigned int lastRow = startCell.y;
+  unsigned int layer = 0;
+  bool isFound = start == end;
+  while (!isFound && frontierSize > 0) {
+    expandedNodes += frontierSize;
+    unsigned int expandFirstRow = firstRow > 0 ? firstRow - 1 : 0;
+    unsigned int expandLastRow = min(lastRow + 1, height - 1);
+    frontierSize = expandBitboardLayer(frontier, openCells, visited, next, expandFirstRow, expandLastRow);
+    layer++;
+
+    // Record the distance of the newly reached cells and the rows they span.
+    unsigned int nextFirstRow = UINT_MAX;
+    unsigned int nextLastRow = 0;
+    for (unsigned int y = expandFirstRow; y <= expandLastRow && frontierSize > 0; y++) {
+      for (unsigned int w = 0; w < next.wordsPerRow; w++) {
+        for (uint64_t word = next.words[(size_t) y * next.wordsPerRow + w]; word != 0; word &= word - 1) {
+          int cell = (int) (y * width + w * 64 + __builtin_ctzll(word));
+          searchStamps[cell] = currentSearchStamp;
+          searchCosts[cell] = layer;
+          isFound = isFound || cell == end;
+          nextFirstRow = min(nextFirstRow, y);
+          nextLastRow = y;
+        }
+      }
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
+    }
+
+    // Clear the rows of the expanded frontier so that its buffer can hold the next layer.
+    fill(frontier.words.begin() + (long) firstRow * frontier.wordsPerRow, frontier.words.begin() + (long) (lastRow + 1) * frontier.wordsPerRow, 0);
+    swap(frontier, next);
+    firstRow = nextFirstRow;
+    lastRow = nextLastRow;
+  }
+
+  // Construct the path by walking back through the cells of decreasing distance.
+  vector<Cell> path;
+  if (isFound) {
+    int current = end;
+    path.emplace_back(endCell);
+    while (current != start) {
+      for (unsigned int direction = 0; direction < 4; direction++) {
+        int neighbor = getOpenNeighborIndex(current, direction);
+        if (neighbor != -1 && searchStamps[neighbor] == currentSearchStamp && searchCosts[neighbor] + 1 == searchCosts[current]) {
+          current = neighbor;
+          break;
+        }
+      }
+      path.emplace_back(current % (int) width, current / (int) width);
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
+    }
+    reverse(path.begin(), path.end());
+  }
+
+  // Return the result.
+  double length = path.empty() ? 0 : (double) (path.size() - 1);
+  return {{path, length, {startCell, endCell}}, expandedNodes};
+}
+
+// Method that searches the shortest path between two cells using bidirectional breadth-first search.
+SearchResult Maze::searchBidirectionalBreadthFirst(Cell startCell, Cell endCell) {
+  // Prepare the search buffers (the first half belongs to the forward side, the second half to the backward side).
+  resetSearchBuffers();
+  const int cellsCount = (int) (width * height);
+  const int start = startCell.y * (int) width + startCell.x;
+  const int end = endCell.y * (int) width + endCell.x;
+
+  // Mark the start and the end cells and create a frontier for each side.
+  vector<int> frontiers[2] = {{start}, {end}};
+  for (int side = 0; side < 2; side++) {
+    int cell = frontiers[side][0];
+    searchStamps[side * cellsCount + cell] = currentSearchStamp;
+    searchParents[side * cellsCount + cell] = -1;
+    searchCosts[side * cellsCount + cell] = 0;
+  }
+
+  // Expand the smaller frontier one whole layer at a time until the two searches meet.
+  unsigned long long expandedNodes = 0;
+  int meetingCell = start == end ? start : -1;
+  unsigned int bestLength = UINT_MAX;
+  while (meetingCell == -1 && !frontiers[0].empty() && !frontiers[1].empty()) {
+    int side = frontiers[0].size() <= frontiers[1].size() ? 0 : 1;
+    int otherSide = 1 - side;
+    vector<int> nextFrontier;
+
+    for (int current : frontiers[side]) {
+      expandedNodes++;
+
+      for (unsigned int direction = 0; direction < 4; direction++) {
+        int neighbor = getOpenNeighborIndex(current, direction);
+
+        // Increment the number of iterations to generate the maze.
+        iterationsTookToGenerate++;
+
+        if (neighbor == -1) continue;
+
+        // Check if the neighbor was reached by the other side (the shortest meeting of this layer wins).
+        if (searchStamps[otherSide * cellsCount + neighbor] == currentSearchStamp) {
+          unsigned int length = searchCosts[side * cellsCount + current] + 1 + searchCosts[otherSide * cellsCount + neighbor];
+          if (length < bestLength) {
+            bestLength = length;
+            meetingCell = neighbor;
+            searchParents[side * cellsCount + neighbor] = current;
+          }
+          continue;
+        }
+
+        // Add the neighbor to the next frontier if it was not visited by this side yet.
+        if (searchStamps[side * cellsCount + neighbor] != currentSearchStamp) {
+          searchStamps[side * cellsCount + neighbor] = currentSearchStamp;
+          searchParents[side * cellsCount + neighbor] = current;
+          searchCosts[side * cellsCount + neighbor] = searchCosts[side * cellsCount + current] + 1;
+          nextFrontier.push_back(neighbor);
+        }
+      }
+    }
+
+    frontiers[side] = std::move(nextFrontier);
+  }
+
+  // Construct the path through the meeting cell if the searches met.
+  vector<Cell> path;
+  if (meetingCell != -1) {
+    for (int current = meetingCell; current != -1; current = searchParents[current]) {
+      path.emplace_back(current % (int) width, current / (int) width);
+    }
+    reverse(path.begin(), path.end());
+    for (int current = searchParents[cellsCount + meetingCell]; current != -1; current = searchParents[cellsCount + current]) {
+      path.emplace_back(current % (int) width, current / (int) width);
+    }
+
+    // Increment the number of iterations to generate the maze.
+    iterationsTookToGenerate += (long long) path.size();
+  }
+
+  // Return the result.
+  double length = path.empty() ? 0 : (double) (path.size() - 1);
+  return {{path, length, {startCell, endCell}}, expandedNodes};
+}
+
+// Method that searches the shortest path between two cells using A* with the Manhattan distance heuristic.
+SearchResult Maze::searchAStar(Cell startCell, Cell endCell) {
+  // Prepare the search buffers.
+  resetSearchBuffers();
+  const int start = startCell.y * (int) width + startCell.x;
+  const int end = endCell.y * (int) width + endCell.x;
+
+  // Define the Manhattan distance heuristic (admissible and consistent on a 4-connected grid).
+  auto heuristic = [&](int cell) {
+    return (unsigned int) (abs(cell % (int) width - endCell.x) + abs(cell / (int) width - endCell.y));
+  };
+
+  // Create an open list ordered by the estimated total cost, preferring deeper cells on ties.
+  using Entry = tuple<unsigned int, unsigned int, int>;
+  priority_queue<Entry, vector<Entry>, greater<>> openList;
+  searchStamps[start] = currentSearchStamp;
+  searchParents[start] = -1;
+  searchCosts[start] = 0;
+  openList.emplace(heuristic(start), UINT_MAX, start);
+
+  // Expand the most promising cell until the end cell is reached.
+  unsigned long long expandedNodes = 0;
+  bool isFound = false;
+  while (!openList.empty()) {
+    auto [estimate, inverseCost, current] = openList.top();
+    openList.pop();
+
+    // Skip outdated entries.
+    if (UINT_MAX - inverseCost != searchCosts[current]) continue;
+    expandedNodes++;
+
+    // Stop if the end cell is reached.
+    if (current == end) {
+      isFound = true;
+      break;
+    }
+
+    // Relax the neighbors.
+    for (unsigned int direction = 0; direction < 4; direction++) {
+      int neighbor = getOpenNeighborIndex(current, direction);
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
+
+      if (neighbor == -1) continue;
+      unsigned int cost = searchCosts[current] + 1;
+      if (searchStamps[neighbor] != currentSearchStamp || cost < searchCosts[neighbor]) {
+        searchStamps[neighbor] = currentSearchStamp;
+        searchParents[neighbor] = current;
+        searchCosts[neighbor] = cost;
+        openList.emplace(cost + heuristic(neighbor), UINT_MAX - cost, neighbor);
+      }
+    }
+  }
+
+  // Construct the path if the end cell was found.
+  vector<Cell> path;
+  if (isFound) {
+    for (int current = end; current != -1; current = searchParents[current]) {
+      path.emplace_back(current % (int) width, current / (int) width);
+    }
+    reverse(path.begin(), path.end());
+
+    // Increment the number of iterations to generate the maze.
+    iterationsTookToGenerate += (long long) path.size();
+  }
+
+  // Return the result.
+  double length = path.empty() ? 0 : (double) (path.size() - 1);
+  return {{path, length, {startCell, endCell}}, expandedNodes};
+}
+
+// Method that searches the shortest path between two cells using Dijkstra on the junction graph.
+SearchResult Maze::searchJunctionGraph(Cell startCell, Cell endCell) {
+  // Contract the maze the first time the junction graph is needed.
+  if (junctionGraph.cellNodes.size() != (size_t) width * height) {
+    buildJunctionGraph();
+  }
+
+  // Run Dijkstra from the start cell until the end cell is settled.
+  const int start = startCell.y * (int) width + startCell.x;
+  const int end = endCell.y * (int) width + endCell.x;
+  vector<unsigned int> distances;
+  vector<int> predecessorCorridors;
+  unsigned long long expandedNodes = junctionGraph.findNodeDistances(start, distances, predecessorCorridors, end);
+
+  // Expand the corridors of the path into cells.
+  vector<Cell> path = junctionGraph.getPath(start, end, distances, predecessorCorridors).toCells();
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) (expandedNodes + path.size());
+
+  // Return the result.
+  double length = path.empty() ? 0 : (double) (path.size() - 1);
+  return {{path, length, {startCell, endCell}}, expandedNodes};
+}
+
+// Method that searches the shortest path between two cells using the hierarchical pathfinder.
+SearchResult Maze::searchHierarchical(Cell startCell, Cell endCell) {
+  // Partition the maze the first time the hierarchical pathfinder is needed.
+  if (clusterGraph.cellEntranceIds.size() != (size_t) width * height) {
+    buildClusterGraph();
+  }
+
+  // Search the abstract graph and refine the route inside the clusters it passes through.
+  unsigned long long expandedNodes = 0;
+  vector<Cell> path = clusterGraph.getPath(finalMaze, startCell.y * (int) width + startCell.x, endCell.y * (int) width + endCell.x, expandedNodes);
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) expandedNodes;
+
+  // Return the result.
+  double length = path.empty() ? 0 : (double) (path.size() - 1);
+  return {{path, length, {startCell, endCell}}, expandedNodes};
+}
+
+// Method that builds the bitboard of the open cells.
+void Maze::buildOpenCellsBitboard() {
+  openCells = Bitboard(width, height);
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < width; x++) {
+      if (finalMaze[y][x] != WALL_ID) {
+        openCells.set(x, y);
+      }
+    }
+  }
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) width * height;
+}
+
+// Method that prepares the search buffers for a new query.
+void Maze::resetSearchBuffers() {
+  // Allocate the buffers once per maze size (two halves are used by the bidirectional search).
+  const size_t cellsCount = (size_t) width * height;
+  if (searchStamps.size() != 2 * cellsCount) {
+    searchStamps.assign(2 * cellsCount, 0);
+    searchParents.assign(2 * cellsCount, -1);
+    searchCosts.assign(2 * cellsCount, 0);
+    currentSearchStamp = 0;
+  }
+
+  // Invalidate all the previous marks by bumping the stamp, and clear the buffers when it overflows.
+  currentSearchStamp++;
+  if (currentSearchStamp == 0) {
+    fill(searchStamps.begin(), searchStamps.end(), 0);
+    currentSearchStamp = 1;
+  }
+}
@@ -5,608 +5,828 @@ void Maze::generateSolution() {
   // Set the time point for benchmarking.
   auto stepStartTime = chrono::high_resolution_clock::now();
 
-  // Get the shortest paths between each pair of checkpoints.
-  cout << colorString("Finding the shortest paths between each pair of checkpoints...", "yellow", "black", "bold") << "\n";
-  vector<Path> paths = findShortestPathsBetweenEachPairOfCheckpoints();
-  cout << colorString("DONE!", "green", "black", "bold");
+  // Build the distance oracle.
+  cout << colorString("Building the distance oracle...", "yellow", "black", "bold") << "\n";
+  buildDistanceOracle();
+  cout << colorString(distanceOracle.isTree ? "DONE!" : "DONE! (the maze is not perfect, the junction graph will be used)", "green", "black", "bold");
   unsigned long long timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
   cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
   stepStartTime = chrono::high_resolution_clock::now();
 
-  // Create the adjacency matrix.
-  cout << colorString("Creating the adjacency matrix...", "yellow", "black", "bold") << "\n";
-  vector<vector<double>> matrix = createAdjacencyMatrix(paths);
-  cout << colorString("DONE!", "green", "black", "bold");
-  timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
-  cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
-  stepStartTime = chrono::high_resolution_clock::now();
+  // Contract the maze into a junction graph if the distance oracle cannot be used.
+  if (!distanceOracle.isTree) {
+    cout << colorString("Contracting the maze into a junction graph...", "yellow", "black", "bold") << "\n";
+    buildJunctionGraph();
+    cout << colorString("DONE! (" + to_string(junctionGraph.nodeCells.size()) + " junctions, " + to_string(junctionGraph.corridors.size()) + " corridors)", "green", "black", "bold");
+    timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
+    cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
+    stepStartTime = chrono::high_resolution_clock::now();
+  }
 
-  // Apply the chosen traveling salesman problem solving algorithm.
-  cout << colorString("Applying the chosen TSP solving algorithm...", "yellow", "black", "bold") << "\n";
-  vector<Cell> tspResult;
-  switch (solvingAlgorithm) {
-    case SupportedSolvingAlgorithms::HELD_KARP_PARALLEL:
-      tspResult = tspHeldKarpParallel(matrix);
-      break;
-    case SupportedSolvingAlgorithms::HELD_KARP:
-      tspResult = tspHeldKarp(matrix);
-      break;
-    case SupportedSolvingAlgorithms::BRUTE_FORCE:
-      tspResult = tspBruteForce(matrix);
-      break;
-    default:
-      break;
+  // Get the checkpoints.
+  vector<Cell> checkpoints = getCheckpoints();
+
+  // Start the clock of the time limits.
+  solvingStartTime = chrono::steady_clock::now();
+
+  // Load the results cached by the previous solutions of the same maze with the same checkpoints (if any).
+  SolutionCache cache(finalMaze, checkpoints, executablePath + SOLUTION_CACHE_FILE_PREFIX, SOLUTION_CACHE_MAX_FILES, SOLUTION_CACHE_MAX_BYTES);
+  bool isCacheChanged = false;
+  if (SOLUTION_CACHE_ENABLED && cache.load()) {
+    cout << colorString("Loaded the cached results from " + cache.filePath, "green", "black", "bold") << "\n\n";
+  }
+
+  // Look the route of a single agent up in the cache (found by the same algorithm, or proven optimal by any of them).
+  const SolutionCache::CachedTour* cachedTour = agentsCount == 1 ? cache.findTour(routeType, solvingAlgorithm) : nullptr;
+
+  // Find the distances between each pair of checkpoints (the paths are found later, only for the chosen legs).
+  // The Steiner tree solver walks the tree of a perfect maze itself, so it needs no distances (unless they split the checkpoints among the agents),
+  // and a cached route needs none either (the cached matrix is still loaded, as it keeps the predecessors that speed up the legs).
+  DistanceMatrix matrix;
+  if (cache.hasMatrix && (cachedTour != nullptr || solvingAlgorithm != SupportedSolvingAlgorithms::STEINER_TREE || !distanceOracle.isTree || agentsCount > 1)) {
+    cout << colorString("Loading the adjacency matrix from the cache...", "yellow", "black", "bold") << "\n";
+    matrix = cache.matrix;
+    checkpointNodeDistances = cache.nodeDistances;
+    checkpointPredecessorCorridors = cache.predecessorCorridors;
+    cout << colorString("DONE!", "green", "black", "bold");
+    timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
+    cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
+    stepStartTime = chrono::high_resolution_clock::now();
+  } else if (cachedTour == nullptr && (solvingAlgorithm != SupportedSolvingAlgorithms::STEINER_TREE || !distanceOracle.isTree || agentsCount > 1)) {
+    cout << colorString("Creating the adjacency matrix...", "yellow", "black", "bold") << "\n";
+    matrix = createAdjacencyMatrix(checkpoints);
+
+    // Cache the matrix if it is stored (the rows computed on demand are not kept).
+    if (SOLUTION_CACHE_ENABLED && !matrix.isOnDemand()) {
+      cache.setMatrix(matrix, checkpointNodeDistances, checkpointPredecessorCorridors);
+      isCacheChanged = true;
+    }
+    cout << colorString("DONE!", "green", "black", "bold");
+    timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
+    cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
+    stepStartTime = chrono::high_resolution_clock::now();
+  }
+
+  // Apply the chosen traveling salesman problem solving algorithm (to the share of each agent, if there are several), unless the route is cached.
+  vector<vector<Cell>> agentOrders;
+  if (cachedTour != nullptr) {
+    cout << colorString("Loading the route from the cache...", "yellow", "black", "bold") << "\n";
+    cout << "  - Route length: " << cachedTour->length << (cachedTour->isOptimal ? " (proven optimal)" : " (found by the same solving algorithm)") << "\n";
+    vector<Cell> cachedOrder;
+    for (unsigned int checkpointId : cachedTour->order) {
+      cachedOrder.push_back(checkpoints[checkpointId]);
+    }
+    agentOrders = {cachedOrder};
+  } else if (agentsCount > 1) {
+    cout << colorString("Splitting the checkpoints among the agents and applying the chosen TSP solving algorithm...", "yellow", "black", "bold") << "\n";
+    agentOrders = tspMultiAgent(matrix);
+  } else {
+    cout << colorString("Applying the chosen TSP solving algorithm...", "yellow", "black", "bold") << "\n";
+    agentOrders = {solveTsp(matrix)};
   }
   cout << colorString("DONE!", "green", "black", "bold");
   timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
   cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
   stepStartTime = chrono::high_resolution_clock::now();
 
-  // Construct the final path.
-  cout << colorString("Constructing the final path...", "yellow", "black", "bold") << "\n";
-  Path finalPath = constructFinalPath(tspResult, paths);
+  // Construct the final path of each agent.
+  cout << colorString(agentsCount > 1 ? "Constructing the final paths..." : "Constructing the final path...", "yellow", "black", "bold") << "\n";
+  legSearchesCount = 0;
+  legSearchExpandedNodes = 0;
+  vector<Path> finalPaths;
+  for (const vector<Cell>& agentOrder : agentOrders) {
+    finalPaths.push_back(constructFinalPath(agentOrder, checkpoints));
+  }
+  cout << getLegSearchesStatistics();
   cout << colorString("DONE!", "green", "black", "bold");
   timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
   cout << colorString(" (Took " + millisecondsToTimeString(timePerformance) + ")", "white", "black", "bold") << "\n\n";
 
-  // Set the minimum path length.
-  minPathLength = (unsigned int)finalPath.length;
-
-  // Get the checkpoints.
-  vector<Cell> checkpoints = getCheckpoints();
-
-  // Iterate over the path cells.
-  for (int i = 0; i < finalPath.path.size(); i++) {
-    // Get the current cell.
-    Cell currentCell = finalPath.path[i];
+  // Set the minimum path length (of the longest path, or of all the paths together, if the agents minimize their total length).
+  minPathLength = 0;
+  for (const Path& finalPath : finalPaths) {
+    if (agentObjective == AgentObjective::MIN_TOTAL_LENGTH) {
+      minPathLength += (unsigned int) finalPath.length;
+    } else {
+      minPathLength = max(minPathLength, (unsigned int) finalPath.length);
+    }
+  }
 
-    // If the current cell is not the last cell.
-    if (i != finalPath.path.size() - 1) {
-      // Mark the current cell.
-      finalMaze[currentCell.y][currentCell.x] = CURRENT_POSITION_ID;
+  // Cache the new route of a single agent (with the length it is solved for, which includes the way back of a closed tour)
+  // and write the cache if anything was added to it.
+  if (SOLUTION_CACHE_ENABLED && agentsCount == 1 && cachedTour == nullptr) {
+    vector<int> checkpointIds((size_t) width * height, -1);
+    for (int i = 0; i < checkpoints.size(); i++) {
+      checkpointIds[checkpoints[i].y * (int) width + checkpoints[i].x] = i;
+    }
+    vector<unsigned int> order;
+    for (const Cell& checkpoint : agentOrders[0]) {
+      order.push_back((unsigned int) checkpointIds[checkpoint.y * (int) width + checkpoint.x]);
+    }
+    cache.storeTour({routeType, solvingAlgorithm, isSolvingAlgorithmExact(), getRouteLength(order, checkpoints, matrix), order});
+    isCacheChanged = true;
+  }
+  if (isCacheChanged) {
+    if (cache.save()) {
+      cout << colorString("Saved the results to the cache file " + cache.filePath, "green", "black", "bold") << "\n\n";
     } else {
-      // Mark the current cell.
-      finalMaze[currentCell.y][currentCell.x] = END_ID;
+      cout << colorString("The cache file could not be written.", "white", "red", "bold") << "\n\n";
     }
+  }
 
-    // If the current cell is not the first cell.
-    if (i > 0) {
-      // Get the previous cell.
-      Cell previousCell = finalPath.path[i - 1];
-
-      // Check if the previous cell was a checkpoint.
-      bool isCheckpoint = false;
-      for (auto &checkpoint : checkpoints) {
-        if (previousCell.x == checkpoint.x && previousCell.y == checkpoint.y) {
-          isCheckpoint = true;
-          break;
-        }
+  // Keep the solution so that wall edits can repair it (the order of several agents is not kept, as their routes are solved again).
+  checkpointDistanceFields.clear();
+  solutionCheckpoints = checkpoints;
+  solutionMatrix = matrix;
+  solutionOrder = agentsCount == 1 ? agentOrders[0] : vector<Cell>();
+  solutionPaths.clear();
+  for (const Path& finalPath : finalPaths) {
+    solutionPaths.push_back(finalPath.path);
+  }
 
-        // Increment the number of iterations to generate the maze.
-        iterationsTookToGenerate++;
-      }
+  // Mark the paths on the maze.
+  markSolutionPaths(finalPaths, checkpoints);
+}
+
+// Method that marks the paths of the agents on the maze step by step, all the agents moving at once.
+void Maze::markSolutionPaths(const vector<Path>& paths, const vector<Cell>& checkpoints) {
+  // Index the cells of the checkpoints.
+  vector<bool> isCheckpointCell((size_t) width * height, false);
+  for (const Cell& checkpoint : checkpoints) {
+    isCheckpointCell[checkpoint.y * (size_t) width + checkpoint.x] = true;
+  }
+
+  // Find the number of steps (the length of the longest path).
+  size_t stepsCount = 0;
+  for (const Path& path : paths) {
+    stepsCount = max(stepsCount, path.path.size());
+  }
 
-      // Mark the current cell.
-      if (i - 1 == 0) {
-        // Mark the start cell.
-        finalMaze[previousCell.y][previousCell.x] = START_ID;
-      } else if (i - 1 == finalPath.path.size() - 1) {
-        // Mark the end cell.
-        finalMaze[previousCell.y][previousCell.x] = END_ID;
-      } else if (isCheckpoint) {
-        // Mark the checkpoint cell.
-        finalMaze[previousCell.y][previousCell.x] = PASSED_CHECKPOINT_ID;
-      } else {
-        // Mark the path cell.
-        finalMaze[previousCell.y][previousCell.x] = PASSED_PATH_ID;
+  // Iterate over the steps, moving every agent whose path is not over yet.
+  for (size_t i = 0; i < stepsCount; i++) {
+    for (unsigned int agent = 0; agent < paths.size(); agent++) {
+      const vector<Cell>& path = paths[agent].path;
+      if (i >= path.size()) continue;
+
+      // Mark the current cell (the end of the path once it is reached).
+      Cell currentCell = path[i];
+      finalMaze[currentCell.y][currentCell.x] = i != path.size() - 1 ? CURRENT_POSITION_ID : END_ID;
+
+      // Mark the previous cell as the start, a passed checkpoint or a passed path (in the color of the agent, if there are several).
+      if (i > 0) {
+        Cell previousCell = path[i - 1];
+        if (i - 1 == 0) {
+          finalMaze[previousCell.y][previousCell.x] = START_ID;
+        } else if (isCheckpointCell[previousCell.y * (size_t) width + previousCell.x]) {
+          finalMaze[previousCell.y][previousCell.x] = PASSED_CHECKPOINT_ID;
+        } else {
+          finalMaze[previousCell.y][previousCell.x] = paths.size() > 1 ? (unsigned int) (AGENT_PATH_ID + agent) : (unsigned int) PASSED_PATH_ID;
+        }
       }
+
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
     }
 
     // Add the current maze state to the list of maze states.
     generationSteps.push_back(finalMaze);
+  }
+}
 
-    // Increment the number of iterations to generate the maze.
-    iterationsTookToGenerate++;
+// Method that applies the chosen traveling salesman problem solving algorithm to the adjacency matrix.
+vector<Cell> Maze::solveTsp(const DistanceMatrix& matrix) {
+  switch (solvingAlgorithm) {
+    case SupportedSolvingAlgorithms::HELD_KARP_PARALLEL:
+      return tspHeldKarpParallel(matrix);
+    case SupportedSolvingAlgorithms::HELD_KARP:
+      return tspHeldKarp(matrix);
+    case SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE:
+      return tspHeldKarpOutOfCore(matrix);
+    case SupportedSolvingAlgorithms::BRUTE_FORCE:
+      return tspBruteForce(matrix);
+    case SupportedSolvingAlgorithms::NEAREST_NEIGHBOR:
+      return tspLocalSearch(matrix, false);
+    case SupportedSolvingAlgorithms::GREEDY_EDGE:
+      return tspLocalSearch(matrix, true);
+    case SupportedSolvingAlgorithms::SIMULATED_ANNEALING:
+      return tspAnnealing(matrix);
+    case SupportedSolvingAlgorithms::BRANCH_AND_BOUND:
+      return tspBranchAndBound(matrix);
+    case SupportedSolvingAlgorithms::ANYTIME:
+      return tspAnytime(matrix);
+    case SupportedSolvingAlgorithms::PORTFOLIO:
+      return tspPortfolio(matrix);
+    case SupportedSolvingAlgorithms::STEINER_TREE:
+      return tspSteinerTree(matrix);
+    default:
+      return {};
   }
 }
 
-// Method that returns the shortest path between each pair of checkpoints.
-vector<Path> Maze::findShortestPathsBetweenEachPairOfCheckpoints() {
+// Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in a single thread.
+vector<Cell> Maze::tspHeldKarp(const DistanceMatrix& adjacencyMatrix) {
   // Get all the checkpoints.
-  vector<Cell> checkpoints = getCheckpoints();
+  const vector<Cell> checkpoints = getCheckpoints();
 
-  // Declare a vector to store all the paths.
-  vector<Path> paths;
+  // Fill the table once, from a fixed start. An open path starts from a virtual checkpoint at zero distance from all the others
+  // (or the first checkpoint, with free edges back to it, if the route starts there), and a closed tour from the first checkpoint.
+  HeldKarp heldKarp(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  heldKarp.solve();
 
-  // Find the shortest path between each pair of checkpoints.
-  for (int i = 0; i < checkpoints.size() - 1; i++) {
-    for (int j = i + 1; j < checkpoints.size(); j++) {
-      Path path = findShortestPathBetweenCells(checkpoints[i], checkpoints[j]);
-      paths.push_back(path);
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) (((unsigned long long) 1 << heldKarp.nodes) * heldKarp.nodes);
 
-      // Increment the number of iterations to generate the maze.
-      iterationsTookToGenerate++;
-    }
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : heldKarp.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
   }
 
-  // Return the paths.
-  return paths;
+  return shortestPath;
 }
 
-// Method that returns the shortest path between two cells.
-Path Maze::findShortestPathBetweenCells(Cell startCell, Cell endCell) {
-  // Declare a path to store the result.
-  vector<Cell> path;
-
-  // Declare a variable to store the length of the path.
-  double length = 0;
+// Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in multiple threads.
+vector<Cell> Maze::tspHeldKarpParallel(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
+  const vector<Cell> checkpoints = getCheckpoints();
 
-  // Declare a flag to indicate if the end cell was found.
-  bool isFound = false;
+  // Display the stats of the threads.
+  unsigned int numThreadsAvailable = thread::hardware_concurrency();
+  cout << "  - Number of threads available: " << numThreadsAvailable << "\n";
+  cout << "  - Number of threads to be used: " << max(1u, numThreadsAvailable) << "\n";
 
-  // Create a 2D array to store the distance from the start cell to each visited cell.
-  vector<vector<double>> distances(height, vector<double>(width, INFINITY));
+  // Fill a single shared table layer by layer (subsets of the same size), with the subsets of each layer split among the threads.
+  ThreadPool pool(numThreadsAvailable);
+  HeldKarp heldKarp(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  heldKarp.solve(&pool);
 
-  // Create a 2D array to store the previous cell in the shortest path to each visited cell.
-  vector<vector<Cell>> previous(height, vector<Cell>(width, {-1, -1}));
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) (((unsigned long long) 1 << heldKarp.nodes) * heldKarp.nodes);
 
-  // Initialize the distance from the start cell to itself to 0.
-  distances[startCell.y][startCell.x] = 0;
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : heldKarp.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
+  }
 
-  // Create a queue for BFS and add the start cell to it.
-  queue<Cell> cells;
-  cells.push(startCell);
+  return shortestPath;
+}
 
-  // Perform BFS until the end cell is found or the queue is empty.
-  while (!cells.empty()) {
-    Cell current = cells.front();
-    cells.pop();
+// Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm with the table kept in a file.
+vector<Cell> Maze::tspHeldKarpOutOfCore(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
+  const vector<Cell> checkpoints = getCheckpoints();
 
-    // Stop BFS if the end cell is found.
-    if (current.y == endCell.y && current.x == endCell.x) {
-      isFound = true;
-      break;
+  // Map the table file of this problem next to the executable (a stopped run of the same problem resumes from its last completed layer).
+  HeldKarp heldKarp(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  stringstream fileName;
+  fileName << HELD_KARP_TABLE_FILE_PREFIX << hex << heldKarp.getFingerprint() << ".table";
+  const string filePath = executablePath + fileName.str();
+  cout << "  - Table file: " << colorString(filePath, "yellow", "black", "bold") << " (" << heldKarp.getTableBytes() / (1024 * 1024) << " MB)\n";
+  if (!heldKarp.mapTable(filePath)) {
+    // Keep the table in memory only if it fits the memory cap, and otherwise solve with branch and bound, which needs no table.
+    if (heldKarp.getTableBytes() > HELD_KARP_MAX_IN_MEMORY_TABLE_BYTES) {
+      cout << colorString("  - The table file could not be mapped and the table is too large for the memory, solving with branch and bound instead.", "white", "red", "bold") << "\n";
+      return tspBranchAndBound(adjacencyMatrix);
     }
+    cout << colorString("  - The table file could not be mapped, the table is kept in memory.", "white", "red", "bold") << "\n";
+  } else if (heldKarp.resumedLayers > 0) {
+    cout << "  - Resuming after layer " << heldKarp.resumedLayers << " of " << heldKarp.nodes << "\n";
+  }
 
-    // Check the neighbors of the current cell.
-    vector<Cell> neighbors = {
-        {current.x, current.y - 1},
-        {current.x, current.y + 1},
-        {current.x - 1, current.y},
-        {current.x + 1, current.y},
-    };
-
-    // Iterate over the neighbors.
-    for (Cell neighbor : neighbors) {
-      // Check if the neighbor is a valid cell and can be visited.
-      if (isValidPath(neighbor.x, neighbor.y)) {
-        // Calculate the distance to the neighbor cell.
-        double newDistance = distances[current.y][current.x] + 1;
-
-        // Check if the new distance is shorter than the previous distance to the neighbor cell.
-        if (newDistance < distances[neighbor.y][neighbor.x]) {
-          distances[neighbor.y][neighbor.x] = newDistance;
-          previous[neighbor.y][neighbor.x] = current;
-          cells.push(neighbor);
-        }
-      }
+  // Fill the table layer by layer with all the threads.
+  ThreadPool pool(thread::hardware_concurrency());
+  heldKarp.solve(&pool);
 
-      // Increment the number of iterations to generate the maze.
-      iterationsTookToGenerate++;
-    }
-  }
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) (((unsigned long long) 1 << heldKarp.nodes) * heldKarp.nodes);
 
-  // Construct the path and calculate its length if the end cell was found.
-  if (isFound) {
-    Cell current = endCell;
-    while (current.y != startCell.y || current.x != startCell.x) {
-      path.insert(path.begin(), current);
-      length++;
-      current = previous[current.y][current.x];
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : heldKarp.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
+  }
 
-      // Increment the number of iterations to generate the maze.
-      iterationsTookToGenerate++;
-    }
-    path.insert(path.begin(), current);
+  // The run is complete, so its table file is no longer needed.
+  if (heldKarp.mappedTable != nullptr) {
+    remove(filePath.c_str());
   }
 
-  // Return the result.
-  return {path, length, {startCell, endCell}};
+  return shortestPath;
 }
 
-// Method that creates an adjacency matrix from a list of paths.
-vector<vector<double>> Maze::createAdjacencyMatrix(const vector<Path> &paths) {
+// Method that implements the traveling salesman problem using a construction heuristic (nearest neighbor or greedy edge) improved by 2-opt and Or-opt.
+vector<Cell> Maze::tspLocalSearch(const DistanceMatrix& adjacencyMatrix, bool isGreedyEdge) {
   // Get all the checkpoints.
-  vector<Cell> checkpoints = getCheckpoints();
+  const vector<Cell> checkpoints = getCheckpoints();
 
-  // Define a matrix to store the adjacency matrix.
-  vector<vector<double>> matrix(checkpoints.size(), vector<double>(checkpoints.size(), 0));
+  // Build the tour (an open path goes through a virtual checkpoint that closes it).
+  auto stepStartTime = chrono::high_resolution_clock::now();
+  Tour tour(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  if (isGreedyEdge) {
+    tour.buildGreedyEdge();
+  } else {
+    tour.buildNearestNeighbor();
+  }
+  unsigned long long timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
+  cout << "  - Constructed tour length: " << tour.getLength() << " (Took " << millisecondsToTimeString(timePerformance) << ")\n";
 
-  // Fill the matrix with the lengths of the paths.
-  for (Path p : paths) {
-    int i = getCheckpointId(p.checkpoints[0]);
-    int j = getCheckpointId(p.checkpoints[1]);
-    matrix[i][j] = p.length;
-    matrix[j][i] = p.length;
+  // Improve the tour with the local search.
+  stepStartTime = chrono::high_resolution_clock::now();
+  unsigned long long movesCount = tour.improve();
+  timePerformance = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - stepStartTime).count();
+  cout << "  - Improved tour length: " << tour.getLength() << " after " << movesCount << " moves (Took " << millisecondsToTimeString(timePerformance) << ")\n";
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) ((unsigned long long) tour.size * tour.size + movesCount);
 
-    // Increment the number of iterations to generate the maze.
-    iterationsTookToGenerate++;
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : tour.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
   }
 
-  // Return the matrix.
-  return matrix;
+  return shortestPath;
 }
 
-// Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in a single thread.
-vector<Cell> Maze::tspHeldKarp(vector<vector<double>> adjacencyMatrix) {
-  // Get all the checkpoints and their quantity.
+// Method that implements the traveling salesman problem using simulated annealing on an island per thread.
+vector<Cell> Maze::tspAnnealing(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
   const vector<Cell> checkpoints = getCheckpoints();
-  const unsigned int checkpointsQuantity = adjacencyMatrix.size();
 
-  // Define a memoization matrix.
-  auto** memoizationMatrix = new double*[checkpointsQuantity];
-  for (int i = 0; i < checkpointsQuantity; i++) {
-    memoizationMatrix[i] = new double[1 << checkpointsQuantity];
-  }
-
-  // Define a matrix to reconstruct the path.
-  auto** parentMatrix = new int*[checkpointsQuantity];
-  for (int i = 0; i < checkpointsQuantity; i++) {
-    parentMatrix[i] = new int[1 << checkpointsQuantity];
-  }
-
-  // Iterate over all the checkpoints and find the shortest path starting from each checkpoint.
+  // Start every island from the same locally optimal tour (an open path goes through a virtual checkpoint).
+  Tour tour(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  tour.buildGreedyEdge();
+  unsigned long long movesCount = tour.improve();
+  cout << "  - Starting tour length: " << tour.getLength() << "\n";
+
+  // Anneal the islands, one per thread (or a single one if the rows of the matrix are computed on demand, since every thread would compute them again).
+  unsigned int islandsCount = adjacencyMatrix.isOnDemand() ? 1 : max(1u, thread::hardware_concurrency());
+  cout << "  - Number of islands: " << islandsCount << "\n";
+  ThreadPool pool(islandsCount);
+  Annealing annealing(tour, islandsCount, ANNEALING_SEED);
+  movesCount += annealing.run(&pool, ANNEALING_MOVES_PER_ISLAND, ANNEALING_TIME_LIMIT_MS);
+  cout << "  - Annealed tour length: " << annealing.getBestLength() << "\n";
+
+  // Polish the best tour of the islands with the local search.
+  tour.setOrder(annealing.getBestOrder());
+  movesCount += tour.improve();
+  cout << "  - Final tour length: " << tour.getLength() << "\n";
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) movesCount;
+
+  // Convert the order of the checkpoint IDs to the checkpoints.
   vector<Cell> shortestPath;
-  double shortestPathLength = numeric_limits<double>::max();
-  for (int startPoint = 0; startPoint < checkpointsQuantity; startPoint++) {
-    // Initialize the memoization table with default values.
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      for (int j = 0; j < (1 << checkpointsQuantity); j++) {
-        memoizationMatrix[i][j] = -1;
-        parentMatrix[i][j] = -1;
-      }
-    }
-
-    // Set the path that starts and ends at the current checkpoint.
-    memoizationMatrix[startPoint][1 << startPoint] = 0;
-
-    // Iterate over all the possible subsets of checkpoints.
-    for (int mask = 1; mask < (1 << checkpointsQuantity); mask++) {
-      // Iterate over all the checkpoints.
-      for (int i = 0; i < checkpointsQuantity; i++) {
-        // If the current checkpoint is not in the current subset, skip it.
-        if (!(mask & (1 << i))) continue;
-
-        // Iterate over all the checkpoints.
-        for (int j = 0; j < checkpointsQuantity; j++) {
-          // If the current checkpoint is in the current subset or is the same as the current checkpoint, skip it.
-          if (mask & (1 << j) || i == j) continue;
-
-          // Calculate the new mask.
-          int newMask = mask | (1 << j);
-
-          // Check if the new mask is valid and if the path between the current and the next checkpoint exists.
-          if (memoizationMatrix[j][newMask] == -1 || memoizationMatrix[j][newMask] > memoizationMatrix[i][mask] + adjacencyMatrix[i][j]) {
-            // Update the memoization table and the parent matrix.
-            memoizationMatrix[j][newMask] = memoizationMatrix[i][mask] + adjacencyMatrix[i][j];
-            parentMatrix[j][newMask] = i;
-          }
-        }
-      }
-    }
-
-    // Find the shortest path that starts and ends at the current checkpoint.
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      if (i == startPoint) continue;
-      if (shortestPathLength > memoizationMatrix[i][(1 << checkpointsQuantity) - 1] + adjacencyMatrix[i][startPoint]) {
-        shortestPathLength = memoizationMatrix[i][(1 << checkpointsQuantity) - 1] + adjacencyMatrix[i][startPoint];
-        shortestPath.clear();
-
-        // Reconstruct the shortest path.
-        int currentCheckpoint = i;
-        int currentMask = (1 << checkpointsQuantity) - 1;
-        while (currentCheckpoint != -1) {
-          shortestPath.push_back(checkpoints[currentCheckpoint]);
-          int parentCheckpoint = parentMatrix[currentCheckpoint][currentMask];
-          int parentMask = currentMask ^ (1 << currentCheckpoint);
-          currentCheckpoint = parentCheckpoint;
-          currentMask = parentMask;
-        }
-        reverse(shortestPath.begin(), shortestPath.end());
-      }
-    }
+  for (unsigned int checkpointId : tour.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
   }
 
-  // Delete the memoization matrix and the parent matrix.
-  for (int i = 0; i < checkpointsQuantity; i++) {
-    delete[] memoizationMatrix[i];
-    delete[] parentMatrix[i];
-  }
-  delete[] memoizationMatrix;
-  delete[] parentMatrix;
-
   return shortestPath;
 }
 
-// Method that implements the traveling salesman problem using Held-Karp (dynamic programming) algorithm and runs it in multiple threads.
-vector<Cell> Maze::tspHeldKarpParallel(vector<vector<double>> adjacencyMatrix) {
-  // Get all the checkpoints and their quantity.
+// Method that implements the traveling salesman problem using branch and bound with 1-tree bounds and runs it in multiple threads.
+vector<Cell> Maze::tspBranchAndBound(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
   const vector<Cell> checkpoints = getCheckpoints();
-  const unsigned int checkpointsQuantity = adjacencyMatrix.size();
 
   // Display the stats of the threads.
   unsigned int numThreadsAvailable = thread::hardware_concurrency();
   cout << "  - Number of threads available: " << numThreadsAvailable << "\n";
-  cout << "  - Number of threads to be used: " << checkpointsQuantity << "\n";
+  cout << "  - Number of threads to be used: " << max(1u, numThreadsAvailable) << "\n";
+
+  // Start from the tour of the local search (an open path goes through a virtual checkpoint), so that most of the nodes are pruned early.
+  Tour tour(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  tour.buildGreedyEdge();
+  tour.improve();
+  cout << "  - Starting tour length: " << tour.getLength() << "\n";
+
+  // Search the nodes in parallel, all the threads sharing the open nodes and the best tour.
+  ThreadPool pool(numThreadsAvailable);
+  BranchAndBound branchAndBound(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  branchAndBound.setIncumbent(tour.order);
+  branchAndBound.solve(&pool);
+  cout << "  - Root lower bound: " << ceil(branchAndBound.rootBound - 1e-6) << "\n";
+  cout << "  - Nodes explored: " << branchAndBound.nodesCount << "\n";
+  cout << "  - Shortest tour length: " << branchAndBound.getLength() << "\n";
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) branchAndBound.nodesCount;
+
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : branchAndBound.getOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
+  }
+
+  return shortestPath;
+}
+
+// Method that implements the traveling salesman problem exactly on a perfect maze by walking the Steiner subtree of the checkpoints.
+vector<Cell> Maze::tspSteinerTree(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
+  const vector<Cell> checkpoints = getCheckpoints();
+
+  // The subtree needs the maze to be a tree (the wall edits drop the distance oracle, so it is rebuilt first).
+  if (!distanceOracle.isTree) buildDistanceOracle();
+  if (!distanceOracle.isTree) {
+    cout << colorString("  - The maze is not perfect, the portfolio of the other solvers is used instead.", "white", "red", "bold") << "\n";
+    return tspPortfolio(adjacencyMatrix);
+  }
 
-  // Define a vector to store all the threads.
-  vector<thread> threads;
+  // Find the subtree that spans the checkpoints and walk it from one end of the route to the other.
+  SteinerTree steinerTree(distanceOracle, checkpoints, routeType == RouteType::OPEN_FIXED_START);
+  steinerTree.solve();
+  cout << "  - Steiner subtree edges: " << steinerTree.edgesCount << "\n";
+  cout << "  - Shortest closed walk length: " << steinerTree.getClosedLength() << "\n";
+  cout << "  - Shortest open walk length: " << steinerTree.length << " (from checkpoint " << steinerTree.startId << " to checkpoint " << steinerTree.endId << ")\n";
 
-  // Define a mutex to lock the shortest path and shortest path length.
-  mutex shortestPathMutex;
-  mutex shortestPathLengthMutex;
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) width * height;
 
-  // Define variables to store the shortest path and shortest path length.
+  // Convert the order of the checkpoint IDs to the checkpoints.
   vector<Cell> shortestPath;
-  double shortestPathLength = numeric_limits<double>::max();
-
-  // Define a function to be run by each thread.
-  auto threadFunction = [&](int startPoint) {
-    // Define a memoization matrix.
-    auto** memoizationMatrix = new double*[checkpointsQuantity];
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      memoizationMatrix[i] = new double[1 << checkpointsQuantity];
-    }
+  for (unsigned int checkpointId : steinerTree.order) {
+    shortestPath.push_back(checkpoints[checkpointId]);
+  }
 
-    // Define a matrix to reconstruct the path.
-    auto** parentMatrix = new int*[checkpointsQuantity];
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      parentMatrix[i] = new int[1 << checkpointsQuantity];
-    }
+  return shortestPath;
+}
 
-    // Initialize the memoization table with default values.
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      for (int j = 0; j < (1 << checkpointsQuantity); j++) {
-        memoizationMatrix[i][j] = -1;
-        parentMatrix[i][j] = -1;
-      }
-    }
+// Method that implements the traveling salesman problem as an anytime search that has a route at once and improves it until the time limit.
+vector<Cell> Maze::tspAnytime(const DistanceMatrix& adjacencyMatrix) {
+  return tspRace(adjacencyMatrix, ANYTIME_TIME_LIMIT_MS, false);
+}
 
-    // Set the path that starts and ends at the current checkpoint.
-    memoizationMatrix[startPoint][1 << startPoint] = 0;
-
-    // Iterate over all the possible subsets of checkpoints.
-    for (int mask = 1; mask < (1 << checkpointsQuantity); mask++) {
-      // Iterate over all the checkpoints.
-      for (int i = 0; i < checkpointsQuantity; i++) {
-        // If the current checkpoint is not in the current subset, skip it.
-        if (!(mask & (1 << i))) continue;
-
-        // Iterate over all the checkpoints.
-        for (int j = 0; j < checkpointsQuantity; j++) {
-          // If the current checkpoint is in the current subset or is the same as the current checkpoint, skip it.
-          if (mask & (1 << j) || i == j) continue;
-
-          // Calculate the new mask.
-          int newMask = mask | (1 << j);
-
-          // Check if the new mask is valid and if the path between the current and the next checkpoint exists.
-          if (memoizationMatrix[j][newMask] == -1 || memoizationMatrix[j][newMask] > memoizationMatrix[i][mask] + adjacencyMatrix[i][j]) {
-            // Update the memoization table and the parent matrix.
-            memoizationMatrix[j][newMask] = memoizationMatrix[i][mask] + adjacencyMatrix[i][j];
-            parentMatrix[j][newMask] = i;
-          }
-        }
-      }
-    }
+// Method that implements the traveling salesman problem as a portfolio of the solvers that fit the number of checkpoints, raced against each other.
+vector<Cell> Maze::tspPortfolio(const DistanceMatrix& adjacencyMatrix) {
+  return tspRace(adjacencyMatrix, PORTFOLIO_TIME_LIMIT_MS, true);
+}
 
-    // Find the shortest path that starts and ends at the current checkpoint.
-    vector<Cell> currentShortestPath;
-    double currentShortestPathLength = numeric_limits<double>::max();
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      if (i == startPoint) continue;
-      if (currentShortestPathLength > memoizationMatrix[i][(1 << checkpointsQuantity) - 1] + adjacencyMatrix[i][startPoint]) {
-        currentShortestPathLength = memoizationMatrix[i][(1 << checkpointsQuantity) - 1] + adjacencyMatrix[i][startPoint];
-        currentShortestPath.clear();
-
-        // Reconstruct the shortest path.
-        int currentCheckpoint = i;
-        int currentMask = (1 << checkpointsQuantity) - 1;
-        while (currentCheckpoint != -1) {
-          currentShortestPath.push_back(checkpoints[currentCheckpoint]);
-          int parentCheckpoint = parentMatrix[currentCheckpoint][currentMask];
-          int parentMask = currentMask ^ (1 << currentCheckpoint);
-          currentCheckpoint = parentCheckpoint;
-          currentMask = parentMask;
-        }
-        reverse(currentShortestPath.begin(), currentShortestPath.end());
-      }
-    }
+// Method that races the solvers on the same matrix, sharing the best route between them, until one of them proves a route optimal
+// (and the others are cancelled) or the time limit runs out.
+vector<Cell> Maze::tspRace(const DistanceMatrix& adjacencyMatrix, long long timeLimitMs, bool isPortfolio) {
+  // Get all the checkpoints.
+  const vector<Cell> checkpoints = getCheckpoints();
+  const bool isOpen = isRouteOpen();
+  const bool isStartFixed = routeType == RouteType::OPEN_FIXED_START;
+
+  // Report every shorter route and every larger lower bound as they are found, with the optimality gap between them.
+  SolverContext context(timeLimitMs, solvingStartTime);
+  context.onProgress = [](const SolverContext::Progress& progress) {
+    stringstream gap;
+    gap << fixed << setprecision(2) << SolverContext::computeGap(progress.length, progress.lowerBound) * 100 << "%";
+    cout << "  - [" << progress.elapsedMs << " ms] Length: " << progress.length << ", lower bound: " << progress.lowerBound
+         << ", gap: " << gap.str() << " (" << progress.source << ")\n";
+  };
+
+  // Build a route at once, so that there is a valid one whatever the time limit (an open path goes through a virtual checkpoint).
+  // The time limit counts from the start of the adjacency matrix, so the neighbor lists, the joining of the greedy paths and the local search
+  // take shortcuts as soon as it runs out.
+  Tour tour(adjacencyMatrix, isOpen, isStartFixed, &context);
+  tour.buildGreedyEdge(&context);
+  context.offerOrder(tour.getOrder(), tour.getLength(), "greedy edge");
+  unsigned long long movesCount = tour.improve(&context);
+  context.offerOrder(tour.getOrder(), tour.getLength(), "2-opt/Or-opt");
+
+  // Race the other solvers only if the time limit did not run out while the route was built.
+  const bool isRaced = !context.shouldStop();
+
+  // Choose the solvers: the annealing shortens the route, and the exact solvers prove it optimal (the branch and bound also raises
+  // the lower bound on the way). The exact solvers need the whole matrix in memory (and Held-Karp its table, within the memory cap), so they are skipped for the largest problems.
+  const unsigned int checkpointsCount = adjacencyMatrix.size;
+  const bool isStored = !adjacencyMatrix.isOnDemand();
+  const bool isBranchAndBoundUsed = isRaced && isStored && checkpointsCount <= ANYTIME_MAX_BOUNDED_CHECKPOINTS;
+  unique_ptr<HeldKarp> heldKarp;
+  if (isRaced && isPortfolio && isStored && checkpointsCount <= MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) {
+    heldKarp = make_unique<HeldKarp>(adjacencyMatrix, isOpen, isStartFixed);
+    if (heldKarp->getTableBytes() > HELD_KARP_MAX_IN_MEMORY_TABLE_BYTES) heldKarp.reset();
+  }
+  const bool isHeldKarpUsed = heldKarp != nullptr;
+  const bool isBruteForceUsed = isRaced && isPortfolio && isStored && checkpointsCount <= MAZE_MAX_CHECKPOINTS_NUMBER_BRUTE_FORCE;
+
+  // Split the threads evenly between the solvers (the annealing takes what is left, or a single island if the rows of the matrix are computed on demand).
+  const unsigned int numThreadsAvailable = max(1u, thread::hardware_concurrency());
+  const unsigned int solversCount = 1 + isBranchAndBoundUsed + isHeldKarpUsed + isBruteForceUsed;
+  const unsigned int exactThreads = max(1u, numThreadsAvailable / solversCount);
+  const unsigned int exactThreadsCount = exactThreads * (solversCount - 1);
+  const unsigned int islandsCount = isStored && numThreadsAvailable > exactThreadsCount ? numThreadsAvailable - exactThreadsCount : 1;
+  if (isRaced) {
+    cout << "  - Solvers: simulated annealing (" << islandsCount << " islands)";
+    if (isBranchAndBoundUsed) cout << ", branch and bound";
+    if (isHeldKarpUsed) cout << ", Held-Karp";
+    if (isBruteForceUsed) cout << ", brute force";
+    if (solversCount > 1) cout << " (" << exactThreads << " threads each)";
+    cout << "\n";
+  } else {
+    cout << "  - Solvers: none (the time limit ran out while the route was built)\n";
+  }
 
-    // Lock the shortest path and shortest path length and update them if the current path is shorter.
-    shortestPathMutex.lock();
-    if (currentShortestPathLength < shortestPathLength) {
-      shortestPathLength = currentShortestPathLength;
-      shortestPath = currentShortestPath;
+  // Set up the solvers and their threads, each solver its own pool (so that a solver that is cancelled leaves the others running).
+  unique_ptr<Annealing> annealing;
+  unique_ptr<BranchAndBound> branchAndBound;
+  unique_ptr<BruteForce> bruteForce;
+  if (isRaced) annealing = make_unique<Annealing>(tour, islandsCount, ANNEALING_SEED);
+  if (isBranchAndBoundUsed) {
+    branchAndBound = make_unique<BranchAndBound>(adjacencyMatrix, isOpen, isStartFixed);
+    branchAndBound->setIncumbent(tour.order);
+  }
+  if (isBruteForceUsed) bruteForce = make_unique<BruteForce>(adjacencyMatrix, isOpen, isStartFixed);
+  vector<unique_ptr<ThreadPool>> pools;
+  if (isRaced) {
+    pools.push_back(make_unique<ThreadPool>(islandsCount));
+    for (unsigned int i = 1; i < solversCount; i++) {
+      pools.push_back(make_unique<ThreadPool>(exactThreads));
     }
-    shortestPathMutex.unlock();
+  }
 
-    // Delete the memoization matrix and the parent matrix.
-    for (int i = 0; i < checkpointsQuantity; i++) {
-      delete[] memoizationMatrix[i];
-      delete[] parentMatrix[i];
+  // Race the solvers, one per thread of the race. The first exact solver to finish its search proves the best route optimal
+  // and cancels the others.
+  vector<function<void(ThreadPool*)>> solvers;
+  if (annealing != nullptr) {
+    solvers.push_back([&](ThreadPool* pool) {
+      movesCount += annealing->run(pool, ULLONG_MAX, context.getRemainingMs(), &context);
+    });
+  }
+  if (branchAndBound != nullptr) {
+    solvers.push_back([&](ThreadPool* pool) {
+      branchAndBound->solve(pool, &context);
+      if (!branchAndBound->isInterrupted) context.requestStop();
+    });
+  }
+  if (heldKarp != nullptr) {
+    solvers.push_back([&](ThreadPool* pool) {
+      // The table is allocated at once, which cannot be interrupted, so Held-Karp starts only if the others have not closed the gap by then.
+      if (context.waitUnlessStopped(PORTFOLIO_HELD_KARP_DELAY_MS)) return;
+      heldKarp->solve(pool, &context);
+      if (!heldKarp->isInterrupted) context.requestStop();
+    });
+  }
+  if (bruteForce != nullptr) {
+    solvers.push_back([&](ThreadPool* pool) {
+      bruteForce->solve(pool, &context);
+      if (!bruteForce->isInterrupted) context.requestStop();
+    });
+  }
+  ThreadPool pool(solversCount);
+  pool.parallelFor(0, solvers.size(), 1, [&](size_t firstSolver, size_t lastSolver) {
+    for (size_t solver = firstSolver; solver < lastSolver; solver++) {
+      solvers[solver](pools[solver].get());
     }
-    delete[] memoizationMatrix;
-    delete[] parentMatrix;
-  };
+  });
 
-  // Start a thread for each starting point.
-  threads.reserve(checkpointsQuantity);
-  for (int startPoint = 0; startPoint < checkpointsQuantity; startPoint++) {
-    threads.emplace_back(threadFunction, startPoint);
+  // Polish the best route with the local search (the annealing may have stopped in the middle of an epoch), unless the time limit has run out.
+  if (!context.shouldStop()) {
+    tour.setOrder(context.getBestOrder());
+    movesCount += tour.improve(&context);
+    context.offerOrder(tour.getOrder(), tour.getLength(), "2-opt/Or-opt");
   }
 
-  // Wait for all the threads to finish.
-  for (auto& thread : threads) {
-    thread.join();
+  stringstream gap;
+  gap << fixed << setprecision(2) << context.getGap() * 100 << "%";
+  cout << "  - Best tour length: " << context.bestLength << " (found by " << context.bestOrderSource << ")\n";
+  cout << "  - Lower bound: " << context.lowerBound << (context.lowerBound > 0 ? " (from " + context.lowerBoundSource + ")" : "") << ", optimality gap: " << gap.str() << "\n";
+  cout << "  - Stopped " << (context.isStopRequested ? "after proving the route optimal" : "at the time limit") << " after " << context.getElapsedMs() << " ms (including the adjacency matrix)\n";
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) movesCount;
+  if (branchAndBound != nullptr) iterationsTookToGenerate += (long long) branchAndBound->nodesCount;
+  if (bruteForce != nullptr) iterationsTookToGenerate += (long long) bruteForce->visitedPrefixes;
+
+  // Convert the order of the checkpoint IDs to the checkpoints.
+  vector<Cell> shortestPath;
+  for (unsigned int checkpointId : context.getBestOrder()) {
+    shortestPath.push_back(checkpoints[checkpointId]);
   }
 
   return shortestPath;
 }
 
-// Method that implements the traveling salesman problem using brute force algorithm.
-vector<Cell> Maze::tspBruteForce(vector<vector<double>> adjacencyMatrix) {
+// Method that splits the checkpoints among the agents and routes each agent with the chosen solving algorithm. Returns the order of each agent.
+vector<vector<Cell>> Maze::tspMultiAgent(const DistanceMatrix& adjacencyMatrix) {
   // Get all the checkpoints.
-  vector<Cell> checkpoints = getCheckpoints();
+  const vector<Cell> checkpoints = getCheckpoints();
+
+  // Display the stats of the threads.
+  unsigned int numThreadsAvailable = thread::hardware_concurrency();
+  cout << "  - Number of threads available: " << numThreadsAvailable << "\n";
+  cout << "  - Number of threads to be used: " << max(1u, min(numThreadsAvailable, agentsCount)) << " (one per agent)\n";
+
+  // Cluster the checkpoints, route the agents in parallel (each of them with a single thread) and rebalance the routes.
+  ThreadPool pool(max(1u, min(numThreadsAvailable, agentsCount)));
+  AgentPartition partition(adjacencyMatrix, agentsCount, routeType == RouteType::OPEN_FIXED_START, agentObjective == AgentObjective::MIN_LONGEST_ROUTE);
+  atomic<unsigned long long> routingIterations{0};
+  partition.solve(&pool, [&](const vector<unsigned int>& checkpointIds, const DistanceMatrix& agentMatrix) {
+    vector<Cell> agentCheckpoints;
+    for (unsigned int checkpointId : checkpointIds) {
+      agentCheckpoints.push_back(checkpoints[checkpointId]);
+    }
+    unsigned long long iterations = 0;
+    vector<unsigned int> order = solveAgentRoute(agentCheckpoints, agentMatrix, iterations);
+    routingIterations += iterations;
+    return order;
+  });
+  cout << "  - K-medoids iterations: " << partition.iterationsCount << "\n";
+  cout << "  - Checkpoints moved between the agents: " << partition.movesCount << "\n";
+  for (unsigned int agent = 0; agent < partition.routes.size(); agent++) {
+    cout << "  - Agent " << agent + 1 << ": " << partition.routes[agent].size() << " checkpoints, route length " << partition.lengths[agent] << "\n";
+  }
+  cout << "  - Longest route length: " << partition.getLongestLength() << ", total length: " << partition.getTotalLength() << "\n";
 
-  // Get the number of checkpoints.
-  unsigned int numberOfCheckpoints = adjacencyMatrix.size();
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) ((unsigned long long) partition.iterationsCount * adjacencyMatrix.size * partition.routes.size() + partition.movesCount + routingIterations);
 
-  // Create a vector to store the order of the checkpoints and initialize it.
-  vector<int> order(numberOfCheckpoints);
-  for (int i = 0; i < numberOfCheckpoints; i++) {
-    order[i] = i;
+  // Convert the orders of the checkpoint IDs to the checkpoints.
+  vector<vector<Cell>> agentOrders;
+  for (const vector<unsigned int>& route : partition.routes) {
+    vector<Cell> agentOrder;
+    for (unsigned int checkpointId : route) {
+      agentOrder.push_back(checkpoints[checkpointId]);
+    }
+    agentOrders.push_back(agentOrder);
   }
 
-  // Define a variable to store the shortest length and the order of the checkpoints.
-  double shortestLength = INFINITY;
-  vector<int> shortestOrder;
+  return agentOrders;
+}
 
-  // While there are more permutations of the order of the checkpoints.
-  do {
-    // Calculate the length of the current order.
-    double length = 0;
+// Method that routes a single agent through its checkpoints with the chosen solving algorithm, in a single thread and without any output
+// (the agents are routed in parallel). Returns the order of the indices of the checkpoints.
+vector<unsigned int> Maze::solveAgentRoute(const vector<Cell>& agentCheckpoints, const DistanceMatrix& agentMatrix, unsigned long long& iterations) const {
+  const bool isStartFixed = routeType == RouteType::OPEN_FIXED_START;
 
-    // Set a flag to indicate if the current order is valid.
-    bool isValid = true;
+  // Up to two checkpoints, the order is the only one (or either of the two).
+  if (agentCheckpoints.size() <= 2) {
+    vector<unsigned int> order(agentCheckpoints.size());
+    iota(order.begin(), order.end(), 0);
+    return order;
+  }
 
-    // Set the current checkpoint to the first checkpoint in the order.
-    int currentCheckpoint = order[0];
+  // The Steiner tree needs no distances, only the tree of a perfect maze.
+  if (solvingAlgorithm == SupportedSolvingAlgorithms::STEINER_TREE && distanceOracle.isTree) {
+    SteinerTree steinerTree(distanceOracle, agentCheckpoints, isStartFixed);
+    steinerTree.solve();
+    iterations += (unsigned long long) width * height;
+    return steinerTree.order;
+  }
 
-    // Iterate over the rest of the checkpoints in the order.
-    for (int i = 1; i < numberOfCheckpoints; i++) {
-      // Get the next checkpoint.
-      int nextCheckpoint = order[i];
+  // Every other solver starts from the tour of the local search (as an open path, through a virtual checkpoint).
+  Tour tour(agentMatrix, true, isStartFixed);
+  if (solvingAlgorithm == SupportedSolvingAlgorithms::NEAREST_NEIGHBOR) {
+    tour.buildNearestNeighbor();
+  } else {
+    tour.buildGreedyEdge();
+  }
+  iterations += tour.improve();
+  const unsigned int size = agentMatrix.size;
+  const bool isStored = !agentMatrix.isOnDemand();
 
-      // Check if the path between the current and the next checkpoint exists.
-      if (adjacencyMatrix[currentCheckpoint][nextCheckpoint] == 0) {
-        isValid = false;
-        break;
+  switch (solvingAlgorithm) {
+    case SupportedSolvingAlgorithms::HELD_KARP:
+    case SupportedSolvingAlgorithms::HELD_KARP_PARALLEL:
+    case SupportedSolvingAlgorithms::HELD_KARP_OUT_OF_CORE:
+      // The table is kept in memory, so the shares whose table is over the memory cap are solved by branch and bound instead,
+      // and the agents fill their tables one at a time (so that the tables of all the agents are never in memory together).
+      if (size <= MAZE_MAX_CHECKPOINTS_NUMBER_HELD_KARP) {
+        HeldKarp heldKarp(agentMatrix, true, isStartFixed);
+        if (heldKarp.getTableBytes() > HELD_KARP_MAX_IN_MEMORY_TABLE_BYTES) break;
+        static mutex heldKarpMutex;
+        lock_guard<mutex> lock(heldKarpMutex);
+        heldKarp.solve();
+        iterations += ((unsigned long long) 1 << heldKarp.nodes) * heldKarp.nodes;
+        return heldKarp.getOrder();
       }
+      break;
+    case SupportedSolvingAlgorithms::BRUTE_FORCE: {
+      BruteForce bruteForce(agentMatrix, true, isStartFixed);
+      bruteForce.solve();
+      iterations += bruteForce.visitedPrefixes;
+      return bruteForce.getOrder();
+    }
+    case SupportedSolvingAlgorithms::NEAREST_NEIGHBOR:
+    case SupportedSolvingAlgorithms::GREEDY_EDGE:
+      return tour.getOrder();
+    case SupportedSolvingAlgorithms::SIMULATED_ANNEALING: {
+      Annealing annealing(tour, 1, ANNEALING_SEED);
+      iterations += annealing.run(nullptr, ANNEALING_MOVES_PER_ISLAND, ANNEALING_TIME_LIMIT_MS);
+      tour.setOrder(annealing.getBestOrder());
+      iterations += tour.improve();
+      return tour.getOrder();
+    }
+    default:
+      break;
+  }
 
-      // Add the length of the path between the current and the next checkpoint to the total length.
-      length += adjacencyMatrix[currentCheckpoint][nextCheckpoint];
+  // The branch and bound improves the tour of the local search if the share of the agent fits it. The anytime and portfolio modes
+  // (and the Steiner tree on a maze that is not perfect, which falls back to the portfolio) run it within their time limits.
+  if (!isStored || size > ANYTIME_MAX_BOUNDED_CHECKPOINTS) return tour.getOrder();
+  long long timeLimitMs = 0;
+  if (solvingAlgorithm == SupportedSolvingAlgorithms::ANYTIME) {
+    timeLimitMs = ANYTIME_TIME_LIMIT_MS;
+  } else if (solvingAlgorithm == SupportedSolvingAlgorithms::PORTFOLIO || solvingAlgorithm == SupportedSolvingAlgorithms::STEINER_TREE) {
+    timeLimitMs = PORTFOLIO_TIME_LIMIT_MS;
+  } else if (size > MAZE_MAX_CHECKPOINTS_NUMBER_BRANCH_AND_BOUND) {
+    return tour.getOrder();
+  }
+  SolverContext context(timeLimitMs);
+  context.offerOrder(tour.getOrder(), tour.getLength(), "2-opt/Or-opt");
+  BranchAndBound branchAndBound(agentMatrix, true, isStartFixed);
+  branchAndBound.setIncumbent(tour.order);
+  branchAndBound.solve(nullptr, &context);
+  iterations += branchAndBound.nodesCount;
+  return context.getBestOrder();
+}
 
-      // Set the next checkpoint as the current checkpoint.
-      currentCheckpoint = nextCheckpoint;
+// Method that implements the traveling salesman problem using brute force algorithm (a pruned depth-first search) and runs it in multiple threads.
+vector<Cell> Maze::tspBruteForce(const DistanceMatrix& adjacencyMatrix) {
+  // Get all the checkpoints.
+  vector<Cell> checkpoints = getCheckpoints();
 
-      // Increment the number of iterations to generate the maze.
-      iterationsTookToGenerate++;
-    }
+  // Display the stats of the threads.
+  unsigned int numThreadsAvailable = thread::hardware_concurrency();
+  cout << "  - Number of threads available: " << numThreadsAvailable << "\n";
+  cout << "  - Number of threads to be used: " << max(1u, numThreadsAvailable) << "\n";
 
-    // Check if the current order is valid and if the path between the last and the first checkpoint exists.
-    if (isValid && adjacencyMatrix[currentCheckpoint][order[0]] != 0) {
-      // Check if the current order is the shortest order.
-      if (length < shortestLength) {
-        shortestLength = length;
-        shortestOrder = order;
-      }
-    }
-  } while (next_permutation(order.begin(), order.end()));
+  // Enumerate the orders from a fixed start, with the first checkpoints split among the threads.
+  // An open path starts from a virtual checkpoint at zero distance from all the others (or the first checkpoint, if the route starts there), and a closed tour from the first checkpoint.
+  ThreadPool pool(numThreadsAvailable);
+  BruteForce bruteForce(adjacencyMatrix, isRouteOpen(), routeType == RouteType::OPEN_FIXED_START);
+  bruteForce.solve(&pool);
+  cout << "  - Prefixes searched: " << bruteForce.visitedPrefixes << "\n";
+
+  // Increment the number of iterations to generate the maze.
+  iterationsTookToGenerate += (long long) bruteForce.visitedPrefixes;
 
   // Construct the final order of the checkpoints.
   vector<Cell> result;
-
-  // Reserve the size of the result vector.
-  result.reserve(shortestOrder.size());
-
-  // Add the checkpoints in the shortest order to the result vector.
-  for (int i : shortestOrder) {
-    result.push_back(checkpoints[i]);
-
-    // Increment the number of iterations to generate the maze.
-    iterationsTookToGenerate++;
+  for (unsigned int checkpointId : bruteForce.getOrder()) {
+    result.push_back(checkpoints[checkpointId]);
   }
 
-  // Return the result.
   return result;
 }
 
-// Method that constructs the final path from the order of the checkpoints and the paths.
-Path Maze::constructFinalPath(vector<Cell> checkpointsOrder, const vector<Path> &paths) {
-  // Define a vector to store the final path.
-  vector<Cell> finalPath;
-
-  // Iterate over the checkpoints in the order.
-  for (int i = 0; i < checkpointsOrder.size() - 1; i++) {
-    // Get the current and the next checkpoint.
-    Cell checkpoint1 = checkpointsOrder[i];
-    Cell checkpoint2 = checkpointsOrder[i + 1];
-
-    // Iterate over the paths.
-    for (Path path : paths) {
-      // Check if the path has the same checkpoints as the current and the next checkpoint.
-      if ((path.checkpoints[0] == checkpoint1 && path.checkpoints[1] == checkpoint2)
-          || (path.checkpoints[0] == checkpoint2 && path.checkpoints[1] == checkpoint1)) {
-        // Add the path to the final path.
-        if (path.checkpoints[0] == checkpoint1) {
-          finalPath.push_back(path.checkpoints[0]);
-          for (Cell cell : path.path) {
-            finalPath.push_back(cell);
-
-            // Increment the number of iterations to generate the maze.
-            iterationsTookToGenerate++;
-          }
-          finalPath.push_back(path.checkpoints[1]);
-        } else {
-          finalPath.push_back(path.checkpoints[1]);
-          for (int j = (int) path.path.size() - 1; j >= 0; j--) {
-            finalPath.push_back(path.path[j]);
-
-            // Increment the number of iterations to generate the maze.
-            iterationsTookToGenerate++;
-          }
-          finalPath.push_back(path.checkpoints[0]);
-        }
-
-        // Stop iterating over the paths.
-        break;
-      }
-    }
+// Method that constructs the final path from the order of the checkpoints, finding the path of each leg on demand.
+Path Maze::constructFinalPath(const vector<Cell>& checkpointsOrder, const vector<Cell>& checkpoints) {
+  // Index the checkpoint IDs by their cell index.
+  vector<int> checkpointIds((size_t) width * height, -1);
+  for (int i = 0; i < checkpoints.size(); i++) {
+    checkpointIds[checkpoints[i].y * (int) width + checkpoints[i].x] = i;
   }
 
-  // Filter out duplicate consecutive cells
-  vector<Cell> filteredFinalPath;
-  for (int i = 0; i < finalPath.size(); i++) {
-    if (i == 0 || finalPath[i] != finalPath[i - 1]) {
-      filteredFinalPath.push_back(finalPath[i]);
-    }
-
-    // Increment the number of iterations to generate the maze.
-    iterationsTookToGenerate++;
+  // Define a vector to store the final path and a flag for each checkpoint that was passed (the checkpoints of the other agents count as passed).
+  vector<Cell> finalPath;
+  vector<bool> isPassed(checkpoints.size(), true);
+  for (const Cell& checkpoint : checkpointsOrder) {
+    isPassed[checkpointIds[checkpoint.y * (int) width + checkpoint.x]] = false;
   }
+  unsigned int passedCheckpointsCount = 0;
 
-  // Filter out cells when the path passed through all the checkpoints.
-  vector<Cell> passedCheckpoints;
-  for (int i = 0; i < filteredFinalPath.size(); i++) {
-    // Get the current cell.
-    Cell currentCell = filteredFinalPath[i];
+  // A single checkpoint is a path of its own.
+  if (checkpointsOrder.size() == 1) {
+    finalPath.push_back(checkpointsOrder[0]);
+  }
 
-    // Check if the current cell is a checkpoint and if it was not passed before.
-    if (find(checkpointsOrder.begin(), checkpointsOrder.end(), currentCell) != checkpointsOrder.end()
-        && find(passedCheckpoints.begin(), passedCheckpoints.end(), currentCell) == passedCheckpoints.end()) {
-      // Add the current cell to the passed checkpoints.
-      passedCheckpoints.push_back(currentCell);
-    }
+  // Iterate over the consecutive checkpoints in the order.
+  for (int i = 0; i + 1 < checkpointsOrder.size() && passedCheckpointsCount < checkpointsOrder.size(); i++) {
+    // Find the path of the leg between the current and the next checkpoint.
+    int currentId = checkpointIds[checkpointsOrder[i].y * (int) width + checkpointsOrder[i].x];
+    int nextId = checkpointIds[checkpointsOrder[i + 1].y * (int) width + checkpointsOrder[i + 1].x];
+    CompactPath leg = findShortestPathBetweenCheckpoints(currentId, nextId, checkpoints);
+
+    // Append the cells of the leg, decoding them on the fly and skipping the cell shared with the previous leg.
+    auto legCell = leg.begin();
+    if (!finalPath.empty()) ++legCell;
+    for (; legCell != leg.end(); ++legCell) {
+      const Cell cell = *legCell;
+      finalPath.push_back(cell);
+
+      // Stop when the path passed through all the checkpoints.
+      int checkpointId = checkpointIds[cell.y * (int) width + cell.x];
+      if (checkpointId != -1 && !isPassed[checkpointId]) {
+        isPassed[checkpointId] = true;
+        passedCheckpointsCount++;
+        if (passedCheckpointsCount == checkpointsOrder.size()) break;
+      }
 
-    // Check if the path passed through all the checkpoints.
-    if (passedCheckpoints.size() == checkpointsOrder.size()) {
-      // Erase the cells after the current cell and break from the loop.
-      filteredFinalPath.erase(filteredFinalPath.begin() + i + 1, filteredFinalPath.end());
-      break;
+      // Increment the number of iterations to generate the maze.
+      iterationsTookToGenerate++;
     }
   }
 
   // Return the final path.
-  return {filteredFinalPath, (double) (filteredFinalPath.size() - 1), checkpointsOrder};
+  return {finalPath, (double) (finalPath.empty() ? 0 : finalPath.size() - 1), checkpointsOrder};
+}
+
+// Method that returns the length of a route through the checkpoints (including the way back to the first checkpoint, if the route is a closed tour),
+// read from the matrix, or from the distance oracle if no matrix was needed.
+unsigned long long Maze::getRouteLength(const vector<unsigned int>& order, const vector<Cell>& checkpoints, const DistanceMatrix& matrix) const {
+  auto getDistance = [&](unsigned int i, unsigned int j) -> unsigned long long {
+    return matrix.size == checkpoints.size() ? matrix.get(i, j) : distanceOracle.getDistance(checkpoints[i], checkpoints[j]);
+  };
+  unsigned long long length = 0;
+  for (size_t i = 0; i + 1 < order.size(); i++) {
+    length += getDistance(order[i], order[i + 1]);
+  }
+  if (!isRouteOpen() && order.size() > 1) length += getDistance(order.back(), order[0]);
+  return length;
 }
@@ -0,0 +1,6 @@
+#include "search_result.h"
+
+#include <utility>
+
+// Constructor.
+SearchResult::SearchResult(Path _path, unsigned long long _expandedNodes) : path(std::move(_path)), expandedNodes(_expandedNodes) {}
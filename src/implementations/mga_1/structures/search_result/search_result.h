@@ -0,0 +1,20 @@
+#ifndef SEARCH_RESULT_H
+#define SEARCH_RESULT_H
+
+#include "../path/path.h"
+
+using namespace std;
+
+// Structure that represents the result of a point-to-point path search.
+struct SearchResult {
+  // The path found (empty if the cells are not connected).
+  Path path;
+
+  // The number of cells expanded by the search.
+  unsigned long long expandedNodes;
+
+  // Constructor.
+  SearchResult(Path _path, unsigned long long _expandedNodes);
+};
+
+#endif
@@ -0,0 +1,303 @@
+#include "solution_cache.h"
+
+// Constructor.
+SolutionCache::SolutionCache(const vector<vector<unsigned int>>& maze, const vector<Cell>& checkpoints, const string& _filePathPrefix, size_t _maxFiles, unsigned long long _maxBytes)
+    : filePathPrefix(_filePathPrefix), maxFiles(_maxFiles), maxBytes(_maxBytes) {
+  key = computeKey(maze, checkpoints);
+  height = (unsigned int) maze.size();
+  width = maze.empty() ? 0 : (unsigned int) maze[0].size();
+  checkpointsCount = (unsigned int) checkpoints.size();
+
+  stringstream fileName;
+  fileName << filePathPrefix << hex << key << ".cache";
+  filePath = fileName.str();
+}
+
+// Method that computes the key of a maze and its checkpoints.
+uint64_t SolutionCache::computeKey(const vector<vector<unsigned int>>& maze, const vector<Cell>& checkpoints) {
+  // FNV-1a over the size of the maze, the walls (a bit per cell) and the cells of the checkpoints.
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  auto addWord = [&hash](uint64_t word) {
+    for (unsigned int byte = 0; byte < 8; byte++) {
+      hash = (hash ^ ((word >> (byte * 8)) & 0xFF)) * 0x100000001B3ULL;
+    }
+  };
+  const uint64_t width = maze.empty() ? 0 : maze[0].size();
+  addWord(width);
+  addWord(maze.size());
+
+  uint64_t walls = 0;
+  unsigned int wallsCount = 0;
+  for (const auto& row : maze) {
+    for (unsigned int cell : row) {
+      walls |= (uint64_t) (cell == WALL_ID) << wallsCount;
+      if (++wallsCount == 64) {
+        addWord(walls);
+        walls = 0;
+        wallsCount = 0;
+      }
+    }
+  }
+  addWord(walls);
+
+  addWord(checkpoints.size());
+  for (const Cell& checkpoint : checkpoints) {
+    addWord((uint64_t) checkpoint.y * width + checkpoint.x);
+  }
+  return hash;
+}
+
+// Method that reads the cached results from the file. Returns false if there is no valid file for this maze and checkpoints.
+bool SolutionCache::load() {
+  ifstream file(filePath, ios::binary);
+  if (!file) return false;
+
+  // Check that the file is of this format and of this maze.
+  uint64_t magic = 0;
+  uint64_t fileKey = 0;
+  uint32_t fileWidth = 0;
+  uint32_t fileHeight = 0;
+  uint32_t fileCheckpointsCount = 0;
+  uint32_t toursCount = 0;
+  uint8_t matrixType = MATRIX_NONE;
+  uint8_t hasPredecessors = 0;
+  if (!readValue(file, magic) || !readValue(file, fileKey) || !readValue(file, fileWidth) || !readValue(file, fileHeight)
+      || !readValue(file, fileCheckpointsCount) || !readValue(file, toursCount) || !readValue(file, matrixType) || !readValue(file, hasPredecessors)) {
+    return false;
+  }
+  if (magic != FILE_MAGIC || fileKey != key || fileWidth != width || fileHeight != height || fileCheckpointsCount != checkpointsCount || toursCount > MAX_TOURS) {
+    return false;
+  }
+
+  // Read the stored upper triangle of the matrix.
+  const unsigned long long pairs = (unsigned long long) checkpointsCount * (checkpointsCount - (checkpointsCount > 0)) / 2;
+  DistanceMatrix loadedMatrix;
+  if (matrixType == MATRIX_COMPACT) {
+    loadedMatrix = DistanceMatrix(checkpointsCount, 0);
+    if (!readVector(file, loadedMatrix.compactDistances, pairs) || loadedMatrix.compactDistances.size() != pairs) return false;
+  } else if (matrixType == MATRIX_WIDE) {
+    loadedMatrix = DistanceMatrix(checkpointsCount, ULLONG_MAX);
+    if (!readVector(file, loadedMatrix.distances, pairs) || loadedMatrix.distances.size() != pairs) return false;
+  } else if (matrixType != MATRIX_NONE) {
+    return false;
+  }
+
+  // Read the predecessors of each checkpoint (there are at most as many junctions as cells).
+  const unsigned long long cellsCount = (unsigned long long) width * height;
+  vector<vector<unsigned int>> loadedNodeDistances;
+  vector<vector<int>> loadedPredecessorCorridors;
+  if (hasPredecessors) {
+    loadedNodeDistances.resize(checkpointsCount);
+    loadedPredecessorCorridors.resize(checkpointsCount);
+    for (unsigned int i = 0; i < checkpointsCount; i++) {
+      if (!readVector(file, loadedNodeDistances[i], cellsCount) || !readVector(file, loadedPredecessorCorridors[i], cellsCount)) return false;
+    }
+  }
+
+  // Read the routes (each has to visit every checkpoint once).
+  vector<CachedTour> loadedTours;
+  for (uint32_t t = 0; t < toursCount; t++) {
+    uint32_t routeType = 0;
+    uint32_t solvingAlgorithm = 0;
+    uint8_t isOptimal = 0;
+    uint64_t length = 0;
+    vector<unsigned int> order;
+    if (!readValue(file, routeType) || !readValue(file, solvingAlgorithm) || !readValue(file, isOptimal) || !readValue(file, length)
+        || !readVector(file, order, checkpointsCount) || order.size() != checkpointsCount) {
+      return false;
+    }
+    vector<bool> isVisited(checkpointsCount, false);
+    for (unsigned int checkpointId : order) {
+      if (checkpointId >= checkpointsCount || isVisited[checkpointId]) return false;
+      isVisited[checkpointId] = true;
+    }
+    loadedTours.push_back({(RouteType) routeType, (SupportedSolvingAlgorithms) solvingAlgorithm, isOptimal != 0, length, order});
+  }
+
+  // The file has to end here.
+  if (file.peek() != char_traits<char>::eof()) return false;
+
+  // Mark the file as the most recently used one.
+  error_code error;
+  filesystem::last_write_time(filePath, filesystem::file_time_type::clock::now(), error);
+
+  hasMatrix = matrixType != MATRIX_NONE;
+  matrix = std::move(loadedMatrix);
+  nodeDistances = std::move(loadedNodeDistances);
+  predecessorCorridors = std::move(loadedPredecessorCorridors);
+  tours = std::move(loadedTours);
+  return true;
+}
+
+// Method that writes the cached results to the file atomically. Returns false if the file could not be written.
+bool SolutionCache::save() const {
+  // Write the whole file under a temporary name next to it first.
+  const string temporaryPath = filePath + "." + to_string(chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+  {
+    ofstream file(temporaryPath, ios::binary | ios::trunc);
+    if (!file) return false;
+
+    // Leave out the predecessors, and then the matrix, if the file would not fit the cache.
+    bool arePredecessorsWritten = !nodeDistances.empty();
+    bool isMatrixWritten = hasMatrix;
+    if (getFileBytes(isMatrixWritten, arePredecessorsWritten) > maxBytes) arePredecessorsWritten = false;
+    if (getFileBytes(isMatrixWritten, arePredecessorsWritten) > maxBytes) isMatrixWritten = false;
+
+    const uint8_t matrixType = !isMatrixWritten ? MATRIX_NONE : matrix.isCompact ? MATRIX_COMPACT : MATRIX_WIDE;
+    writeValue(file, FILE_MAGIC);
+    writeValue(file, key);
+    writeValue(file, (uint32_t) width);
+    writeValue(file, (uint32_t) height);
+    writeValue(file, (uint32_t) checkpointsCount);
+    writeValue(file, (uint32_t) tours.size());
+    writeValue(file, matrixType);
+    writeValue(file, (uint8_t) arePredecessorsWritten);
+
+    if (matrixType == MATRIX_COMPACT) {
+      writeVector(file, matrix.compactDistances);
+    } else if (matrixType == MATRIX_WIDE) {
+      writeVector(file, matrix.distances);
+    }
+    for (unsigned int i = 0; arePredecessorsWritten && i < nodeDistances.size(); i++) {
+      writeVector(file, nodeDistances[i]);
+      writeVector(file, predecessorCorridors[i]);
+    }
+    for (const CachedTour& tour : tours) {
+      writeValue(file, (uint32_t) tour.routeType);
+      writeValue(file, (uint32_t) tour.solvingAlgorithm);
+      writeValue(file, (uint8_t) tour.isOptimal);
+      writeValue(file, (uint64_t) tour.length);
+      writeVector(file, tour.order);
+    }
+
+    file.flush();
+    if (!file) {
+      file.close();
+      remove(temporaryPath.c_str());
+      return false;
+    }
+  }
+
+  // Replace the file with the complete one (the rename replaces it atomically on POSIX, elsewhere the old file has to be removed first).
+  if (rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+    remove(filePath.c_str());
+    if (rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+      remove(temporaryPath.c_str());
+      return false;
+    }
+  }
+  evictFiles();
+  return true;
+}
+
+// Method that returns the size of the file with or without the matrix and the predecessors.
+unsigned long long SolutionCache::getFileBytes(bool isMatrixWritten, bool arePredecessorsWritten) const {
+  // The header, then every vector with its size in front.
+  unsigned long long bytes = 2 * sizeof(uint64_t) + 4 * sizeof(uint32_t) + 2 * sizeof(uint8_t);
+  if (isMatrixWritten) {
+    bytes += sizeof(uint64_t) + (matrix.isCompact ? matrix.compactDistances.size() * sizeof(uint16_t) : matrix.distances.size() * sizeof(uint32_t));
+  }
+  for (unsigned int i = 0; arePredecessorsWritten && i < nodeDistances.size(); i++) {
+    bytes += 2 * sizeof(uint64_t) + nodeDistances[i].size() * sizeof(unsigned int) + predecessorCorridors[i].size() * sizeof(int);
+  }
+  for (const CachedTour& tour : tours) {
+    bytes += 2 * sizeof(uint32_t) + sizeof(uint8_t) + 2 * sizeof(uint64_t) + tour.order.size() * sizeof(unsigned int);
+  }
+  return bytes;
+}
+
+// Method that removes the least recently used cache files (but not this one) until the rest fit the limits.
+void SolutionCache::evictFiles() const {
+  // List the cache files next to this one (the files named with the same prefix).
+  error_code error;
+  const filesystem::path prefixPath(filePathPrefix);
+  const filesystem::path directory = prefixPath.has_parent_path() ? prefixPath.parent_path() : filesystem::path(".");
+  const string namePrefix = prefixPath.filename().string();
+  vector<pair<filesystem::file_time_type, filesystem::path>> files;
+  unsigned long long totalBytes = 0;
+  size_t filesCount = 0;
+  for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+    const string name = entry.path().filename().string();
+    if (name.compare(0, namePrefix.size(), namePrefix) != 0 || entry.path().extension() != ".cache") continue;
+    const unsigned long long bytes = entry.file_size(error);
+    if (error) continue;
+    totalBytes += bytes;
+    filesCount++;
+    if (!filesystem::equivalent(entry.path(), filePath, error)) {
+      files.emplace_back(entry.last_write_time(error), entry.path());
+    }
+  }
+
+  // Remove the oldest files first.
+  sort(files.begin(), files.end());
+  for (const auto& [writeTime, path] : files) {
+    if (filesCount <= maxFiles && totalBytes <= maxBytes) break;
+    error_code sizeError;
+    const unsigned long long bytes = filesystem::file_size(path, sizeError);
+    if (filesystem::remove(path, error)) {
+      totalBytes -= sizeError ? 0 : min(bytes, totalBytes);
+      filesCount--;
+    }
+  }
+}
+
+// Method that caches the distance matrix (only a stored one) and the predecessors kept for the checkpoints.
+void SolutionCache::setMatrix(const DistanceMatrix& _matrix, const vector<vector<unsigned int>>& _nodeDistances, const vector<vector<int>>& _predecessorCorridors) {
+  if (_matrix.isOnDemand() || _matrix.size != checkpointsCount) return;
+  hasMatrix = true;
+  matrix = _matrix;
+  const bool isPredecessorDataKept = _nodeDistances.size() == checkpointsCount && _predecessorCorridors.size() == checkpointsCount;
+  nodeDistances = isPredecessorDataKept ? _nodeDistances : vector<vector<unsigned int>>();
+  predecessorCorridors = isPredecessorDataKept ? _predecessorCorridors : vector<vector<int>>();
+}
+
+// Method that returns the cached route found by the given algorithm, or a route proven optimal by any of them (nullptr if there is none).
+const SolutionCache::CachedTour* SolutionCache::findTour(RouteType routeType, SupportedSolvingAlgorithms solvingAlgorithm) const {
+  const CachedTour* optimalTour = nullptr;
+  for (const CachedTour& tour : tours) {
+    if (tour.routeType != routeType) continue;
+    if (tour.solvingAlgorithm == solvingAlgorithm) return &tour;
+    if (tour.isOptimal && optimalTour == nullptr) optimalTour = &tour;
+  }
+  return optimalTour;
+}
+
+// Method that caches a route, replacing the one found by the same algorithm for the same route type.
+void SolutionCache::storeTour(const CachedTour& tour) {
+  if (tour.order.size() != checkpointsCount) return;
+  for (CachedTour& cachedTour : tours) {
+    if (cachedTour.routeType == tour.routeType && cachedTour.solvingAlgorithm == tour.solvingAlgorithm) {
+      cachedTour = tour;
+      return;
+    }
+  }
+  if (tours.size() < MAX_TOURS) tours.push_back(tour);
+}
+
+// Method that writes a value in the binary format (in the byte order of the machine).
+template<typename T>
+void SolutionCache::writeValue(ofstream& file, const T& value) {
+  file.write((const char*) &value, sizeof(T));
+}
+
+// Method that writes a vector of values in the binary format (its size, then the values).
+template<typename T>
+void SolutionCache::writeVector(ofstream& file, const vector<T>& values) {
+  writeValue(file, (uint64_t) values.size());
+  file.write((const char*) values.data(), (streamsize) (values.size() * sizeof(T)));
+}
+
+// Method that reads a value in the binary format.
+template<typename T>
+bool SolutionCache::readValue(ifstream& file, T& value) {
+  return (bool) file.read((char*) &value, sizeof(T));
+}
+
+// Method that reads a vector of values in the binary format (of at most the given size).
+template<typename T>
+bool SolutionCache::readVector(ifstream& file, vector<T>& values, unsigned long long maxSize) {
+  uint64_t size = 0;
+  if (!readValue(file, size) || size > maxSize) return false;
+  values.resize(size);
+  return (bool) file.read((char*) values.data(), (streamsize) (size * sizeof(T)));
+}
@@ -0,0 +1,110 @@
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+#include <filesystem>
+#include <algorithm>
+#include "../cell/cell.h"
+#include "../distance_matrix/distance_matrix.h"
+#include "../../models/models.h"
+
+using namespace std;
+
+// Structure that keeps the results of solving a maze in a file, so that solving the same maze with the same checkpoints again
+// (with another solving algorithm, for example) skips the stages whose results are already known.
+// The file is named after its key: an FNV-1a hash of the size of the maze, the walls and the cells of the checkpoints. It holds the
+// stored distance matrix (in the same 16-bit or 32-bit integers), the junction graph predecessors kept for each checkpoint,
+// and the best route found by each solving algorithm for each route type (in the byte order of the machine).
+// The file is written in full to a temporary file next to it, which is then renamed over it, so a reader never sees a partial file.
+// A file of another format version, of another maze (a hash collision) or that ends early is ignored.
+// The cache is bounded: a file that would not fit it leaves out the predecessors (and then the matrix), and after a file is written,
+// the least recently used files are removed until both the number of the files and their total size fit.
+struct SolutionCache {
+  // The magic number of the file (with the format version).
+  static constexpr uint64_t FILE_MAGIC = 0x534F4C4341434801ULL;
+
+  // The types of the stored matrix.
+  static constexpr uint8_t MATRIX_NONE = 0;
+  static constexpr uint8_t MATRIX_COMPACT = 1;
+  static constexpr uint8_t MATRIX_WIDE = 2;
+
+  // The largest number of the routes kept in the file.
+  static constexpr uint32_t MAX_TOURS = 64;
+
+  // Structure that represents a cached route: the checkpoint IDs in its order, its length, and the algorithm that found it.
+  struct CachedTour {
+    RouteType routeType;
+    SupportedSolvingAlgorithms solvingAlgorithm;
+    bool isOptimal;
+    unsigned long long length;
+    vector<unsigned int> order;
+  };
+
+  // The key of the maze and the checkpoints, and the file that keeps their results.
+  uint64_t key = 0;
+  string filePath;
+  string filePathPrefix;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int checkpointsCount = 0;
+
+  // The distances between the checkpoints (if they were cached) and the junction graph predecessors of each checkpoint (if any were kept).
+  bool hasMatrix = false;
+  DistanceMatrix matrix;
+  vector<vector<unsigned int>> nodeDistances;
+  vector<vector<int>> predecessorCorridors;
+
+  // The cached routes.
+  vector<CachedTour> tours;
+
+  // The largest number of the cache files and their largest total size.
+  size_t maxFiles = 0;
+  unsigned long long maxBytes = 0;
+
+  // Constructors.
+  SolutionCache() = default;
+  SolutionCache(const vector<vector<unsigned int>>& maze, const vector<Cell>& checkpoints, const string& _filePathPrefix, size_t _maxFiles, unsigned long long _maxBytes);
+
+  // Method that computes the key of a maze and its checkpoints.
+  static uint64_t computeKey(const vector<vector<unsigned int>>& maze, const vector<Cell>& checkpoints);
+
+  // Method that reads the cached results from the file. Returns false if there is no valid file for this maze and checkpoints.
+  bool load();
+
+  // Method that writes the cached results to the file atomically. Returns false if the file could not be written.
+  bool save() const;
+
+  // Method that returns the size of the file with or without the matrix and the predecessors.
+  unsigned long long getFileBytes(bool isMatrixWritten, bool arePredecessorsWritten) const;
+
+  // Method that removes the least recently used cache files (but not this one) until the rest fit the limits.
+  void evictFiles() const;
+
+  // Method that caches the distance matrix (only a stored one) and the predecessors kept for the checkpoints.
+  void setMatrix(const DistanceMatrix& _matrix, const vector<vector<unsigned int>>& _nodeDistances, const vector<vector<int>>& _predecessorCorridors);
+
+  // Method that returns the cached route found by the given algorithm, or a route proven optimal by any of them (nullptr if there is none).
+  const CachedTour* findTour(RouteType routeType, SupportedSolvingAlgorithms solvingAlgorithm) const;
+
+  // Method that caches a route, replacing the one found by the same algorithm for the same route type.
+  void storeTour(const CachedTour& tour);
+
+  // Methods that write and read a value or a vector of values in the binary format.
+  template<typename T>
+  static void writeValue(ofstream& file, const T& value);
+  template<typename T>
+  static void writeVector(ofstream& file, const vector<T>& values);
+  template<typename T>
+  static bool readValue(ifstream& file, T& value);
+  template<typename T>
+  static bool readVector(ifstream& file, vector<T>& values, unsigned long long maxSize);
+};
+
+#endif
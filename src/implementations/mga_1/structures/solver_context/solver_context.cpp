@@ -0,0 +1,93 @@
+#include "solver_context.h"
+
+// Constructor (0 for no time limit, counted from the start time, which may be earlier than now if the time limit covers earlier steps too).
+SolverContext::SolverContext(long long timeLimitMs, chrono::steady_clock::time_point _startTime) {
+  startTime = _startTime;
+  hasDeadline = timeLimitMs > 0;
+  deadline = startTime + chrono::milliseconds(max(0LL, timeLimitMs));
+}
+
+// Method that asks the solvers to stop.
+void SolverContext::requestStop() {
+  isStopRequested = true;
+}
+
+// Method that checks whether the solvers should stop (they were asked to, or the deadline has passed).
+bool SolverContext::shouldStop() const {
+  return isStopRequested || (hasDeadline && chrono::steady_clock::now() >= deadline);
+}
+
+// Method that waits for the given milliseconds or until the solvers should stop. Returns whether they should.
+bool SolverContext::waitUnlessStopped(long long delayMs) const {
+  const auto waitEnd = chrono::steady_clock::now() + chrono::milliseconds(max(0LL, delayMs));
+  while (!shouldStop() && chrono::steady_clock::now() < waitEnd) {
+    this_thread::sleep_for(chrono::milliseconds(STOP_CHECK_INTERVAL_MS));
+  }
+  return shouldStop();
+}
+
+// Method that returns the milliseconds since the start.
+long long SolverContext::getElapsedMs() const {
+  return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+// Method that returns the milliseconds left until the deadline (0 if it has passed, LLONG_MAX if there is none).
+long long SolverContext::getRemainingMs() const {
+  if (!hasDeadline) return LLONG_MAX;
+  return max(0LL, (long long) chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count());
+}
+
+// Method that records a route if it is shorter than the best one. Returns whether it was.
+bool SolverContext::offerOrder(const vector<unsigned int>& order, unsigned long long length, const string& source) {
+  if (length >= bestLength) return false;
+
+  lock_guard<mutex> lock(bestOrderMutex);
+  if (length >= bestLength) return false;
+  bestOrder = order;
+  bestLength = length;
+  bestOrderSource = source;
+  reportProgress(source);
+  stopIfOptimal();
+  return true;
+}
+
+// Method that records a lower bound of the length if it is larger than the best one. Returns whether it was.
+bool SolverContext::offerLowerBound(unsigned long long bound, const string& source) {
+  if (bound <= lowerBound) return false;
+
+  lock_guard<mutex> lock(bestOrderMutex);
+  if (bound <= lowerBound) return false;
+  lowerBound = bound;
+  lowerBoundSource = source;
+  reportProgress(source);
+  stopIfOptimal();
+  return true;
+}
+
+// Method that returns the best route found so far.
+vector<unsigned int> SolverContext::getBestOrder() {
+  lock_guard<mutex> lock(bestOrderMutex);
+  return bestOrder;
+}
+
+// Method that returns the optimality gap of the best route (the share of its length that may be above the optimum).
+double SolverContext::getGap() const {
+  return computeGap(bestLength, lowerBound);
+}
+
+// Method that returns the optimality gap of a route length with a lower bound.
+double SolverContext::computeGap(unsigned long long length, unsigned long long bound) {
+  if (length == ULLONG_MAX) return 1.0;
+  if (length == 0 || bound >= length) return 0.0;
+  return (double) (length - bound) / (double) length;
+}
+
+// Method that asks the solvers to stop if the best route is proven optimal (the best order mutex must be held).
+void SolverContext::stopIfOptimal() {
+  if (bestLength != ULLONG_MAX && lowerBound >= bestLength) requestStop();
+}
+
+// Method that reports the progress to the callback (the best order mutex must be held).
+void SolverContext::reportProgress(const string& source) {
+  if (onProgress) onProgress({getElapsedMs(), source, bestLength, lowerBound});
+}
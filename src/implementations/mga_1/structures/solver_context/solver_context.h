@@ -0,0 +1,93 @@
+#ifndef SOLVER_CONTEXT_H
+#define SOLVER_CONTEXT_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+// Structure that is shared by the solvers that run against a time budget.
+// It holds the deadline and the stop flag the solvers poll, the best route any of them has found so far (the checkpoint IDs
+// along the route) and the best lower bound of its length, so that a valid route and its optimality gap are known at any time.
+// Every new best route or lower bound is reported to the progress callback (one at a time, so the callback needs no locking).
+// The exact solvers also read the best length to prune their search, so every solver gains from the routes the others find.
+// Once the lower bound reaches the best length the route is proven optimal, and the solvers are asked to stop.
+struct SolverContext {
+  // The milliseconds between two checks of the stop condition while a solver waits.
+  static constexpr long long STOP_CHECK_INTERVAL_MS = 5;
+
+  // Structure that represents a progress report: when it was made, by which solver, and the best length and lower bound at that time.
+  struct Progress {
+    long long elapsedMs;
+    string source;
+    unsigned long long length;
+    unsigned long long lowerBound;
+  };
+
+  // The time the solving started and its deadline (ignored if there is no time limit).
+  chrono::steady_clock::time_point startTime;
+  chrono::steady_clock::time_point deadline;
+  bool hasDeadline = false;
+
+  // Whether the solvers were asked to stop before the deadline.
+  atomic<bool> isStopRequested{false};
+
+  // The best route found so far and its length, and the largest lower bound of the length (with the solvers that found them).
+  vector<unsigned int> bestOrder;
+  atomic<unsigned long long> bestLength{ULLONG_MAX};
+  atomic<unsigned long long> lowerBound{0};
+  string bestOrderSource;
+  string lowerBoundSource;
+  mutex bestOrderMutex;
+
+  // The callback that receives the progress reports.
+  function<void(const Progress&)> onProgress;
+
+  // Constructor (0 for no time limit, counted from the start time, which may be earlier than now if the time limit covers earlier steps too).
+  explicit SolverContext(long long timeLimitMs = 0, chrono::steady_clock::time_point _startTime = chrono::steady_clock::now());
+
+  // Method that asks the solvers to stop.
+  void requestStop();
+
+  // Method that checks whether the solvers should stop (they were asked to, or the deadline has passed).
+  bool shouldStop() const;
+
+  // Method that waits for the given milliseconds or until the solvers should stop. Returns whether they should.
+  bool waitUnlessStopped(long long delayMs) const;
+
+  // Method that returns the milliseconds since the start.
+  long long getElapsedMs() const;
+
+  // Method that returns the milliseconds left until the deadline (0 if it has passed, LLONG_MAX if there is none).
+  long long getRemainingMs() const;
+
+  // Method that records a route if it is shorter than the best one. Returns whether it was.
+  bool offerOrder(const vector<unsigned int>& order, unsigned long long length, const string& source);
+
+  // Method that records a lower bound of the length if it is larger than the best one. Returns whether it was.
+  bool offerLowerBound(unsigned long long bound, const string& source);
+
+  // Method that returns the best route found so far.
+  vector<unsigned int> getBestOrder();
+
+  // Method that returns the optimality gap of the best route (the share of its length that may be above the optimum).
+  double getGap() const;
+
+  // Method that returns the optimality gap of a route length with a lower bound.
+  static double computeGap(unsigned long long length, unsigned long long bound);
+
+  // Method that asks the solvers to stop if the best route is proven optimal (the best order mutex must be held).
+  void stopIfOptimal();
+
+  // Method that reports the progress to the callback (the best order mutex must be held).
+  void reportProgress(const string& source);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "steiner_tree.h"
+
+// Constructor.
+SteinerTree::SteinerTree(const DistanceOracle& _oracle, const vector<Cell>& checkpoints, bool _isStartFixed) : oracle(&_oracle), isStartFixed(_isStartFixed) {
+  for (const Cell& checkpoint : checkpoints) {
+    checkpointCells.push_back(checkpoint.y * (int) oracle->width + checkpoint.x);
+  }
+}
+
+// Method that finds the Steiner subtree, the ends of the walk and the order of the checkpoints.
+void SteinerTree::solve() {
+  order.clear();
+  if (checkpointCells.empty()) return;
+
+  // Count the checkpoints below each cell, from the last cell of the DFS order up to the root.
+  const vector<int>& cells = oracle->getCellsInDfsOrder();
+  checkpointsBelow.assign((size_t) oracle->width * oracle->height, 0);
+  for (int cell : checkpointCells) {
+    checkpointsBelow[cell]++;
+  }
+  for (auto cell = cells.rbegin(); cell != cells.rend(); ++cell) {
+    if (oracle->parent[*cell] != -1) checkpointsBelow[oracle->parent[*cell]] += checkpointsBelow[*cell];
+  }
+
+  // The edge above a cell is in the subtree if it separates some of the checkpoints from the others.
+  edgesCount = 0;
+  for (int cell : cells) {
+    edgesCount += isInSubtree(cell);
+  }
+
+  // In a tree, the checkpoint farthest from any checkpoint is an end of the longest path between two checkpoints.
+  startId = isStartFixed ? 0 : getFarthestCheckpoint(0);
+  endId = getFarthestCheckpoint(startId);
+  const int width = (int) oracle->width;
+  const unsigned int endsDistance = oracle->getDistance(Cell(checkpointCells[startId] % width, checkpointCells[startId] / width),
+                                                        Cell(checkpointCells[endId] % width, checkpointCells[endId] / width));
+  length = 2 * edgesCount - endsDistance;
+
+  buildOrder();
+}
+
+// Method that returns the length of the shortest closed walk through all the checkpoints.
+unsigned long long SteinerTree::getClosedLength() const {
+  return 2 * edgesCount;
+}
+
+// Method that checks whether the edge between a cell and its parent in the DFS tree belongs to the Steiner subtree.
+bool SteinerTree::isInSubtree(int cell) const {
+  return oracle->parent[cell] != -1 && checkpointsBelow[cell] > 0 && checkpointsBelow[cell] < checkpointCells.size();
+}
+
+// Method that returns the checkpoint farthest from the given one.
+unsigned int SteinerTree::getFarthestCheckpoint(unsigned int checkpointId) const {
+  const int width = (int) oracle->width;
+  const Cell from(checkpointCells[checkpointId] % width, checkpointCells[checkpointId] / width);
+  unsigned int farthestId = checkpointId;
+  unsigned int farthestDistance = 0;
+  for (unsigned int i = 0; i < checkpointCells.size(); i++) {
+    const unsigned int distance = oracle->getDistance(from, Cell(checkpointCells[i] % width, checkpointCells[i] / width));
+    if (distance > farthestDistance) {
+      farthestDistance = distance;
+      farthestId = i;
+    }
+  }
+  return farthestId;
+}
+
+// Method that walks the Steiner subtree from the start, going towards the end last, and lists the checkpoints in the order they are reached.
+void SteinerTree::buildOrder() {
+  const int width = (int) oracle->width;
+  const int height = (int) oracle->height;
+  const int startCell = checkpointCells[startId];
+  const int endCell = checkpointCells[endId];
+
+  // Mark the path between the ends, which climbs from both of them to their lowest common ancestor.
+  vector<bool> isOnPath(checkpointsBelow.size(), false);
+  const int ancestor = oracle->getLowestCommonAncestor(startCell, endCell);
+  for (int cell : {startCell, endCell}) {
+    for (; cell != ancestor; cell = oracle->parent[cell]) {
+      isOnPath[cell] = true;
+    }
+  }
+  isOnPath[ancestor] = true;
+
+  // Index the checkpoint IDs by their cell index.
+  vector<int> checkpointIds(checkpointsBelow.size(), -1);
+  for (unsigned int i = 0; i < checkpointCells.size(); i++) {
+    checkpointIds[checkpointCells[i]] = (int) i;
+  }
+
+  // Walk the subtree depth first (each cell with the cell it was entered from). The next cell of the path to the end is pushed
+  // before the other branches, so it is entered only after all of them are done.
+  vector<pair<int, int>> stack = {{startCell, -1}};
+  vector<int> branches;
+  while (!stack.empty()) {
+    const int cell = stack.back().first;
+    const int previous = stack.back().second;
+    stack.pop_back();
+    if (checkpointIds[cell] != -1) order.push_back((unsigned int) checkpointIds[cell]);
+
+    const int x = cell % width;
+    const int y = cell / width;
+    const int neighbors[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+    int pathCell = -1;
+    branches.clear();
+    for (const auto& neighbor : neighbors) {
+      if (neighbor[0] < 0 || neighbor[1] < 0 || neighbor[0] >= width || neighbor[1] >= height) continue;
+      const int next = neighbor[1] * width + neighbor[0];
+      if (next == previous) continue;
+
+      // Follow only the edges of the subtree, whichever of the two cells is the parent of the other.
+      const bool isSubtreeEdge = (oracle->parent[next] == cell && isInSubtree(next)) || (oracle->parent[cell] == next && isInSubtree(cell));
+      if (!isSubtreeEdge) continue;
+      if (isOnPath[next]) {
+        pathCell = next;
+      } else {
+        branches.push_back(next);
+      }
+    }
+    if (pathCell != -1) stack.emplace_back(pathCell, cell);
+    for (int branch : branches) {
+      stack.emplace_back(branch, cell);
+    }
+  }
+}
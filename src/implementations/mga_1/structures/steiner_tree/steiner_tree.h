@@ -0,0 +1,57 @@
+#ifndef STEINER_TREE_H
+#define STEINER_TREE_H
+
+#include <vector>
+#include <climits>
+#include "../cell/cell.h"
+#include "../distance_oracle/distance_oracle.h"
+
+using namespace std;
+
+// Structure that solves the shortest walk through all the checkpoints exactly on a perfect maze (the open cells form a tree).
+// Any walk through the checkpoints covers their Steiner subtree (the union of the paths between them), and the shortest closed walk
+// goes along each of its edges exactly twice. An open walk saves the path between its ends, so the shortest one runs between the two
+// checkpoints farthest apart (or from the fixed start to the checkpoint farthest from it) and is 2 * edges - distance(start, end) long.
+// The order of the checkpoints is the DFS order of the subtree from the start that goes towards the end only after all the other
+// branches of each cell. The subtree is found by counting the checkpoints below each cell of the DFS tree of the distance oracle,
+// so everything takes time linear in the number of cells.
+struct SteinerTree {
+  // The distance oracle of the maze and the cell index of each checkpoint.
+  const DistanceOracle* oracle = nullptr;
+  vector<int> checkpointCells;
+
+  // Whether the walk has to start from checkpoint 0.
+  bool isStartFixed = false;
+
+  // The number of checkpoints below each cell of the DFS tree (with the cell itself).
+  vector<unsigned int> checkpointsBelow;
+
+  // The number of edges of the Steiner subtree, the checkpoints at the ends of the walk and its length.
+  unsigned long long edgesCount = 0;
+  unsigned int startId = 0;
+  unsigned int endId = 0;
+  unsigned long long length = 0;
+
+  // The checkpoint IDs in the order of the walk.
+  vector<unsigned int> order;
+
+  // Constructor.
+  SteinerTree(const DistanceOracle& _oracle, const vector<Cell>& checkpoints, bool _isStartFixed = false);
+
+  // Method that finds the Steiner subtree, the ends of the walk and the order of the checkpoints.
+  void solve();
+
+  // Method that returns the length of the shortest closed walk through all the checkpoints.
+  unsigned long long getClosedLength() const;
+
+  // Method that checks whether the edge between a cell and its parent in the DFS tree belongs to the Steiner subtree.
+  bool isInSubtree(int cell) const;
+
+  // Method that returns the checkpoint farthest from the given one.
+  unsigned int getFarthestCheckpoint(unsigned int checkpointId) const;
+
+  // Method that walks the Steiner subtree from the start, going towards the end last, and lists the checkpoints in the order they are reached.
+  void buildOrder();
+};
+
+#endif
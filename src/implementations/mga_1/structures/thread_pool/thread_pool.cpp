@@ -0,0 +1,110 @@
+#include "thread_pool.h"
+
+// Constructor.
+ThreadPool::ThreadPool(unsigned int numThreads) {
+  numThreads = max(1u, numThreads);
+  for (unsigned int i = 0; i < numThreads; i++) {
+    workers.push_back(make_unique<Worker>());
+  }
+  threads.reserve(numThreads - 1);
+  for (unsigned int i = 1; i < numThreads; i++) {
+    threads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+// Destructor.
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(stateMutex);
+    isStopping = true;
+  }
+  workAvailable.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Method that returns the number of threads that run the loops (including the calling thread).
+unsigned int ThreadPool::getNumThreads() const {
+  return (unsigned int) workers.size();
+}
+
+// Method that runs the body on the chunks of [begin, end) of at most the given size and waits for all of them to finish.
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t chunkSize, const function<void(size_t, size_t)>& body) {
+  if (begin >= end) return;
+  chunkSize = max((size_t) 1, chunkSize);
+
+  // Deal the chunks to the workers in turn.
+  currentBody = &body;
+  size_t chunksCount = 0;
+  for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize, chunksCount++) {
+    Worker& worker = *workers[chunksCount % workers.size()];
+    lock_guard<mutex> lock(worker.chunksMutex);
+    worker.chunks.emplace_back(chunkBegin, min(chunkBegin + chunkSize, end));
+  }
+  pendingChunks += chunksCount;
+
+  // Wake the workers up and work along with them.
+  {
+    lock_guard<mutex> lock(stateMutex);
+    generation++;
+  }
+  workAvailable.notify_all();
+  while (runChunk(0)) {}
+
+  // Wait for the chunks still running on the other threads.
+  unique_lock<mutex> lock(stateMutex);
+  workDone.wait(lock, [&]() { return pendingChunks == 0; });
+  currentBody = nullptr;
+}
+
+// Method that runs one chunk from the worker's own deque or stolen from another worker.
+bool ThreadPool::runChunk(unsigned int workerId) {
+  pair<size_t, size_t> chunk;
+  bool isFound = false;
+
+  // Take the most recently added chunk of the worker's own deque.
+  {
+    Worker& worker = *workers[workerId];
+    lock_guard<mutex> lock(worker.chunksMutex);
+    if (!worker.chunks.empty()) {
+      chunk = worker.chunks.back();
+      worker.chunks.pop_back();
+      isFound = true;
+    }
+  }
+
+  // Otherwise steal the oldest chunk of another worker.
+  for (unsigned int offset = 1; !isFound && offset < workers.size(); offset++) {
+    Worker& victim = *workers[(workerId + offset) % workers.size()];
+    lock_guard<mutex> lock(victim.chunksMutex);
+    if (!victim.chunks.empty()) {
+      chunk = victim.chunks.front();
+      victim.chunks.pop_front();
+      isFound = true;
+    }
+  }
+  if (!isFound) return false;
+
+  // Run the chunk and wake the caller up after the last one.
+  (*currentBody)(chunk.first, chunk.second);
+  if (--pendingChunks == 0) {
+    lock_guard<mutex> lock(stateMutex);
+    workDone.notify_all();
+  }
+  return true;
+}
+
+// Method that is run by each worker thread.
+void ThreadPool::workerLoop(unsigned int workerId) {
+  unsigned long long seenGeneration = 0;
+  while (true) {
+    {
+      unique_lock<mutex> lock(stateMutex);
+      workAvailable.wait(lock, [&]() { return isStopping || generation != seenGeneration; });
+      if (isStopping) return;
+      seenGeneration = generation;
+    }
+    while (runChunk(workerId)) {}
+  }
+}
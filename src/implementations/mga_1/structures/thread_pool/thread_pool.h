@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+// Structure that represents a pool of worker threads that run the chunks of parallel loops with work stealing.
+// Every worker has its own deque of chunks: it takes the chunks from the back of its own deque and, once that is empty,
+// steals from the front of the others. The thread that starts a loop works on it as well, so the pool starts one thread less.
+struct ThreadPool {
+  // Structure that represents the deque of chunks of a worker.
+  struct Worker {
+    deque<pair<size_t, size_t>> chunks;
+    mutex chunksMutex;
+  };
+
+  // The workers (the first one is the calling thread) and the threads of the others.
+  vector<unique_ptr<Worker>> workers;
+  vector<thread> threads;
+
+  // The body of the current loop and the number of its chunks that are not finished yet.
+  const function<void(size_t, size_t)>* currentBody = nullptr;
+  atomic<size_t> pendingChunks{0};
+
+  // The state shared with the waiting workers.
+  mutex stateMutex;
+  condition_variable workAvailable;
+  condition_variable workDone;
+  unsigned long long generation = 0;
+  bool isStopping = false;
+
+  // Constructor and destructor.
+  explicit ThreadPool(unsigned int numThreads = thread::hardware_concurrency());
+  ~ThreadPool();
+
+  // Method that returns the number of threads that run the loops (including the calling thread).
+  unsigned int getNumThreads() const;
+
+  // Method that runs the body on the chunks of [begin, end) of at most the given size and waits for all of them to finish.
+  void parallelFor(size_t begin, size_t end, size_t chunkSize, const function<void(size_t, size_t)>& body);
+
+  // Method that runs one chunk from the worker's own deque or stolen from another worker. Returns false if there was none.
+  bool runChunk(unsigned int workerId);
+
+  // Method that is run by each worker thread.
+  void workerLoop(unsigned int workerId);
+};
+
+#endif
@@ -0,0 +1,349 @@
+#include "tour.h"
+
+// Constructor.
+Tour::Tour(const DistanceMatrix& _matrix, bool _isOpen, bool _isStartFixed, const SolverContext* context) : matrix(&_matrix), isOpen(_isOpen), isStartFixed(_isOpen && _isStartFixed) {
+  size = matrix->size + (isOpen && matrix->size > 0);
+  positions.assign(size, 0);
+  isActive.assign(size, false);
+  buildNeighbors(context);
+}
+
+// Method that builds the tour by always going to the nearest unvisited checkpoint.
+void Tour::buildNearestNeighbor(const SolverContext* context) {
+  const unsigned int checkpointsCount = matrix->size;
+  if (checkpointsCount == 0) return;
+
+  // Keep the unvisited checkpoints packed, so that each step only scans them.
+  vector<unsigned int> unvisited(checkpointsCount - 1);
+  iota(unvisited.begin(), unvisited.end(), 1);
+  vector<unsigned int> checkpointsOrder = {0};
+  while (!unvisited.empty()) {
+    // Once the solvers should stop, take the rest of the checkpoints in the order they are left in.
+    if (context != nullptr && context->shouldStop()) {
+      checkpointsOrder.insert(checkpointsOrder.end(), unvisited.begin(), unvisited.end());
+      break;
+    }
+
+    const unsigned int current = checkpointsOrder.back();
+    size_t nearest = 0;
+    for (size_t k = 1; k < unvisited.size(); k++) {
+      if (getDistance(current, unvisited[k]) < getDistance(current, unvisited[nearest])) nearest = k;
+    }
+    checkpointsOrder.push_back(unvisited[nearest]);
+    unvisited[nearest] = unvisited.back();
+    unvisited.pop_back();
+  }
+
+  closeTour(checkpointsOrder, context);
+}
+
+// Method that builds the tour by adding the shortest edges that keep it a set of paths, and then joining the paths.
+void Tour::buildGreedyEdge(const SolverContext* context) {
+  const unsigned int checkpointsCount = matrix->size;
+  if (checkpointsCount == 0) return;
+
+  // Take the candidate edges from the neighbor lists (the virtual checkpoint is added only when the tour is closed),
+  // until the solvers should stop (the paths are then joined in the order of the IDs of their ends).
+  vector<pair<unsigned long long, pair<unsigned int, unsigned int>>> edges;
+  for (unsigned int i = 0; i < checkpointsCount && (context == nullptr || !context->shouldStop()); i++) {
+    for (unsigned int k = 0; k < neighborsCount; k++) {
+      const unsigned int j = neighbors[(size_t) i * neighborsCount + k];
+      if (j < checkpointsCount) edges.push_back({getDistance(i, j), {min(i, j), max(i, j)}});
+    }
+  }
+  sort(edges.begin(), edges.end());
+  edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+  // Add the edges in the order of their length, unless they would give a checkpoint a third edge or close a cycle.
+  vector<unsigned int> parents(checkpointsCount);
+  iota(parents.begin(), parents.end(), 0);
+  auto findRoot = [&parents](unsigned int checkpoint) {
+    while (parents[checkpoint] != checkpoint) {
+      parents[checkpoint] = parents[parents[checkpoint]];
+      checkpoint = parents[checkpoint];
+    }
+    return checkpoint;
+  };
+  vector<vector<unsigned int>> links(checkpointsCount);
+  for (auto& edge : edges) {
+    const unsigned int i = edge.second.first;
+    const unsigned int j = edge.second.second;
+    if (links[i].size() == 2 || links[j].size() == 2 || findRoot(i) == findRoot(j)) continue;
+    parents[findRoot(i)] = findRoot(j);
+    links[i].push_back(j);
+    links[j].push_back(i);
+  }
+
+  // Join the paths: walk each path to its other end and continue with the nearest end of a path that was not walked yet.
+  vector<unsigned int> ends;
+  for (unsigned int i = 0; i < checkpointsCount; i++) {
+    if (links[i].size() < 2) ends.push_back(i);
+  }
+  vector<bool> isVisited(checkpointsCount, false);
+  vector<unsigned int> checkpointsOrder;
+  unsigned int current = ends.empty() ? 0 : ends[0];
+  while (true) {
+    // Walk the path of the current end.
+    unsigned int previous = current;
+    while (true) {
+      checkpointsOrder.push_back(current);
+      isVisited[current] = true;
+      unsigned int next = current;
+      for (unsigned int link : links[current]) {
+        if (link != previous && !isVisited[link]) next = link;
+      }
+      if (next == current) break;
+      previous = current;
+      current = next;
+    }
+
+    // Find the nearest end of the remaining paths (or take the first one, once the solvers should stop).
+    ends.erase(remove_if(ends.begin(), ends.end(), [&isVisited](unsigned int end) { return isVisited[end]; }), ends.end());
+    if (ends.empty()) break;
+    size_t nearest = 0;
+    for (size_t k = 1; k < ends.size() && (context == nullptr || !context->shouldStop()); k++) {
+      if (getDistance(current, ends[k]) < getDistance(current, ends[nearest])) nearest = k;
+    }
+    current = ends[nearest];
+  }
+
+  closeTour(checkpointsOrder, context);
+}
+
+// Method that sets the order of the checkpoints (without the virtual checkpoint).
+void Tour::setOrder(const vector<unsigned int>& checkpointsOrder) {
+  order = checkpointsOrder;
+  if (isOpen && !order.empty()) order.push_back(size - 1);
+  for (unsigned int i = 0; i < order.size(); i++) {
+    positions[order[i]] = i;
+  }
+}
+
+// Method that improves the tour with 2-opt and Or-opt moves until none of them helps (or the solvers of the context should stop). Returns the number of moves made.
+unsigned long long Tour::improve(const SolverContext* context) {
+  for (unsigned int checkpoint : order) {
+    activate(checkpoint);
+  }
+
+  unsigned long long movesCount = 0;
+  unsigned long long checksCount = 0;
+  while (!activeCheckpoints.empty()) {
+    // Leave the rest of the checkpoints active, so that a later call picks up where this one stopped.
+    if (context != nullptr && ++checksCount % STOP_CHECK_INTERVAL == 0 && context->shouldStop()) break;
+
+    const unsigned int checkpoint = activeCheckpoints.front();
+    activeCheckpoints.pop_front();
+    isActive[checkpoint] = false;
+
+    // Keep the checkpoint active while its moves improve the tour (the moves activate the ends of the edges they change).
+    if (tryTwoOpt(checkpoint) || tryOrOpt(checkpoint)) {
+      activate(checkpoint);
+      movesCount++;
+    }
+  }
+
+  return movesCount;
+}
+
+// Method that returns the length of the tour (of the path, if it is open).
+unsigned long long Tour::getLength() const {
+  unsigned long long length = 0;
+  for (unsigned int i = 0; i < order.size(); i++) {
+    length += getDistance(order[i], order[(i + 1) % order.size()]);
+  }
+
+  // Leave out the penalty of the edge from the end of the path to the virtual checkpoint.
+  if (isStartFixed && size > 2) length -= FIXED_START_PENALTY;
+  return length;
+}
+
+// Method that returns the checkpoint IDs in the order of the tour, starting from checkpoint 0 (or along the path, if it is open, from checkpoint 0 if its start is fixed).
+vector<unsigned int> Tour::getOrder() const {
+  if (order.empty()) return {};
+  const unsigned int first = isOpen ? positions[size - 1] + 1 : positions[0];
+  vector<unsigned int> checkpointsOrder;
+  for (unsigned int i = 0; i < size - isOpen; i++) {
+    checkpointsOrder.push_back(order[(first + i) % size]);
+  }
+
+  // The tour may run from the virtual checkpoint to the end of the path rather than to its start.
+  if (isStartFixed && checkpointsOrder[0] != 0) std::reverse(checkpointsOrder.begin(), checkpointsOrder.end());
+  return checkpointsOrder;
+}
+
+// Method that returns the distance between two checkpoints (zero to the virtual checkpoint, unless the start is fixed).
+unsigned long long Tour::getDistance(unsigned int i, unsigned int j) const {
+  if (isOpen && (i == size - 1 || j == size - 1)) return isStartFixed && i != 0 && j != 0 ? FIXED_START_PENALTY : 0;
+  return matrix->get(i, j);
+}
+
+// Method that returns the checkpoint after the given one in the tour.
+unsigned int Tour::getNext(unsigned int checkpoint) const {
+  return order[positions[checkpoint] + 1 == size ? 0 : positions[checkpoint] + 1];
+}
+
+// Method that returns the checkpoint before the given one in the tour.
+unsigned int Tour::getPrevious(unsigned int checkpoint) const {
+  return order[positions[checkpoint] == 0 ? size - 1 : positions[checkpoint] - 1];
+}
+
+// Method that finds the nearest neighbors of each checkpoint (until the solvers of the context should stop).
+void Tour::buildNeighbors(const SolverContext* context) {
+  neighborsCount = size > 0 ? min(NEIGHBORS_COUNT, size - 1) : 0;
+  neighbors.assign((size_t) size * neighborsCount, 0);
+  vector<pair<unsigned long long, unsigned int>> candidates;
+  for (unsigned int i = 0; i < size; i++) {
+    // Once the solvers should stop, take the next checkpoints by ID instead (the moves then find fewer improvements, but stay valid).
+    if (context != nullptr && context->shouldStop()) {
+      for (unsigned int k = 0; k < neighborsCount; k++) {
+        neighbors[(size_t) i * neighborsCount + k] = (i + 1 + k) % size;
+      }
+      continue;
+    }
+
+    candidates.clear();
+    for (unsigned int j = 0; j < size; j++) {
+      if (j != i) candidates.emplace_back(getDistance(i, j), j);
+    }
+    partial_sort(candidates.begin(), candidates.begin() + neighborsCount, candidates.end());
+    for (unsigned int k = 0; k < neighborsCount; k++) {
+      neighbors[(size_t) i * neighborsCount + k] = candidates[k].second;
+    }
+  }
+}
+
+// Method that closes a tour built over the real checkpoints: the virtual checkpoint of an open path replaces its longest edge
+// (or the last edge, once the solvers of the context should stop; or the longer edge of checkpoint 0, if the start is fixed).
+void Tour::closeTour(vector<unsigned int>& checkpointsOrder, const SolverContext* context) {
+  if (isStartFixed) {
+    // Turn the tour so that the longer edge of checkpoint 0 is the one to the checkpoint before it, and start the path from it.
+    size_t start = find(checkpointsOrder.begin(), checkpointsOrder.end(), 0) - checkpointsOrder.begin();
+    const unsigned int previous = checkpointsOrder[(start + checkpointsOrder.size() - 1) % checkpointsOrder.size()];
+    const unsigned int next = checkpointsOrder[(start + 1) % checkpointsOrder.size()];
+    if (getDistance(0, next) > getDistance(previous, 0)) {
+      std::reverse(checkpointsOrder.begin(), checkpointsOrder.end());
+      start = checkpointsOrder.size() - 1 - start;
+    }
+    rotate(checkpointsOrder.begin(), checkpointsOrder.begin() + start, checkpointsOrder.end());
+  } else if (isOpen) {
+    size_t longestEdge = checkpointsOrder.size() - 1;
+    for (size_t i = 0; i + 1 < checkpointsOrder.size() && (context == nullptr || !context->shouldStop()); i++) {
+      if (getDistance(checkpointsOrder[i], checkpointsOrder[i + 1]) > getDistance(checkpointsOrder[longestEdge], checkpointsOrder[(longestEdge + 1) % checkpointsOrder.size()])) longestEdge = i;
+    }
+    rotate(checkpointsOrder.begin(), checkpointsOrder.begin() + (longestEdge + 1) % checkpointsOrder.size(), checkpointsOrder.end());
+  }
+  setOrder(checkpointsOrder);
+}
+
+// Method that tries the 2-opt moves that replace an edge of the given checkpoint, and makes the first improving one.
+bool Tour::tryTwoOpt(unsigned int checkpoint) {
+  if (size < 4) return false;
+
+  // Replace the edge to the next checkpoint, and then the edge to the previous one.
+  for (unsigned int direction = 0; direction < 2; direction++) {
+    const unsigned int neighbor = direction == 0 ? getNext(checkpoint) : getPrevious(checkpoint);
+    const unsigned long long removedDistance = getDistance(checkpoint, neighbor);
+    for (unsigned int k = 0; k < neighborsCount; k++) {
+      // The new edge to a candidate must be shorter than the removed one for the move to improve the tour.
+      const unsigned int candidate = neighbors[(size_t) checkpoint * neighborsCount + k];
+      const unsigned long long addedDistance = getDistance(checkpoint, candidate);
+      if (addedDistance >= removedDistance) break;
+
+      const unsigned int candidateNeighbor = direction == 0 ? getNext(candidate) : getPrevious(candidate);
+      if (candidate == neighbor || candidateNeighbor == checkpoint) continue;
+      if (removedDistance + getDistance(candidate, candidateNeighbor) > addedDistance + getDistance(neighbor, candidateNeighbor)) {
+        makeTwoOptMove(checkpoint, neighbor, candidate, candidateNeighbor);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Method that tries the Or-opt moves of the segments that start at the given checkpoint, and makes the first improving one.
+bool Tour::tryOrOpt(unsigned int checkpoint) {
+  unsigned int segmentEnd = checkpoint;
+  for (unsigned int segmentLength = 1; segmentLength <= MAX_SEGMENT_LENGTH && segmentLength + 3 <= size; segmentLength++, segmentEnd = getNext(segmentEnd)) {
+    // Cut the segment out and join its neighbors.
+    const unsigned int before = getPrevious(checkpoint);
+    const unsigned int after = getNext(segmentEnd);
+    const long long removalGain = (long long) (getDistance(before, checkpoint) + getDistance(segmentEnd, after)) - (long long) getDistance(before, after);
+    if (removalGain <= 0) continue;
+
+    // Insert the segment (either way round) into an edge next to a near neighbor of one of its ends.
+    for (unsigned int end : {checkpoint, segmentEnd}) {
+      for (unsigned int k = 0; k < neighborsCount; k++) {
+        const unsigned int candidate = neighbors[(size_t) end * neighborsCount + k];
+        if ((long long) getDistance(end, candidate) >= removalGain) break;
+        if ((positions[candidate] + size - positions[checkpoint]) % size < segmentLength) continue;
+
+        for (unsigned int edgeStart : {candidate, getPrevious(candidate)}) {
+          const unsigned int edgeEnd = getNext(edgeStart);
+          if (edgeStart == segmentEnd || edgeEnd == checkpoint || edgeEnd == before) continue;
+
+          const unsigned long long forwardCost = getDistance(edgeStart, checkpoint) + getDistance(segmentEnd, edgeEnd);
+          const unsigned long long reversedCost = getDistance(edgeStart, segmentEnd) + getDistance(checkpoint, edgeEnd);
+          const long long gain = removalGain + (long long) getDistance(edgeStart, edgeEnd) - (long long) min(forwardCost, reversedCost);
+          if (gain <= 0) continue;
+
+          makeOrOptMove(checkpoint, segmentEnd, edgeStart, reversedCost <= forwardCost);
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+// Method that moves a segment (from its start forward to its end) into the edge that leaves the given checkpoint, reversed or not.
+void Tour::makeOrOptMove(unsigned int segmentStart, unsigned int segmentEnd, unsigned int edgeStart, bool isReversed) {
+  const unsigned int before = getPrevious(segmentStart);
+  const unsigned int after = getNext(segmentEnd);
+  const unsigned int edgeEnd = getNext(edgeStart);
+
+  // Move the segment with 2-opt moves: first into the edge reversed, then the other way round if needed.
+  makeTwoOptMove(before, segmentStart, edgeStart, edgeEnd);
+  if (edgeStart != after) makeTwoOptMove(before, edgeStart, after, segmentEnd);
+  if (!isReversed) makeTwoOptMove(edgeStart, segmentEnd, segmentStart, edgeEnd);
+}
+
+// Method that replaces two edges with the two edges that connect their tails and their heads (in the current direction of the tour).
+void Tour::makeTwoOptMove(unsigned int firstFrom, unsigned int firstTo, unsigned int secondFrom, unsigned int secondTo) {
+  if (getNext(firstFrom) != firstTo) swap(firstFrom, firstTo);
+  if (getNext(secondFrom) != secondTo) swap(secondFrom, secondTo);
+  reverse(firstTo, secondFrom);
+
+  for (unsigned int checkpoint : {firstFrom, firstTo, secondFrom, secondTo}) {
+    activate(checkpoint);
+  }
+}
+
+// Method that reverses the part of the tour from one checkpoint to another (or the rest of the tour, whichever is shorter).
+void Tour::reverse(unsigned int from, unsigned int to) {
+  unsigned int i = positions[from];
+  unsigned int j = positions[to];
+  unsigned int length = (j + size - i) % size + 1;
+  if (length * 2 > size) {
+    const unsigned int restStart = (j + 1) % size;
+    j = (i + size - 1) % size;
+    i = restStart;
+    length = size - length;
+  }
+
+  for (unsigned int k = 0; k < length / 2; k++) {
+    swap(order[i], order[j]);
+    positions[order[i]] = i;
+    positions[order[j]] = j;
+    i = i + 1 == size ? 0 : i + 1;
+    j = j == 0 ? size - 1 : j - 1;
+  }
+}
+
+// Method that turns the don't-look bit of a checkpoint off.
+void Tour::activate(unsigned int checkpoint) {
+  if (isActive[checkpoint]) return;
+  isActive[checkpoint] = true;
+  activeCheckpoints.push_back(checkpoint);
+}
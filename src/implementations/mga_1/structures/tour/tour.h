@@ -0,0 +1,111 @@
+#ifndef TOUR_H
+#define TOUR_H
+
+#include <vector>
+#include <deque>
+#include <numeric>
+#include <cstdint>
+#include <algorithm>
+#include "../distance_matrix/distance_matrix.h"
+#include "../solver_context/solver_context.h"
+
+using namespace std;
+
+// Structure that represents a tour through the checkpoints that is built by a construction heuristic and improved by local search.
+// The tour is an array of checkpoint IDs with the position of each checkpoint, and every move is made of 2-opt moves that reverse
+// the shorter side of the tour. The moves are searched only among the nearest neighbors of each checkpoint, and the checkpoints
+// whose neighborhood did not change since they last failed to improve are skipped (don't-look bits).
+// For an open path an extra virtual checkpoint at zero distance from all the others closes the tour, so the tour through it is the path.
+// If the path has to start from checkpoint 0, every other edge of the virtual checkpoint costs FIXED_START_PENALTY, so that no move
+// ever separates the two (every tour pays the penalty once, for the edge to the end of the path, and it is left out of the length).
+struct Tour {
+  // The number of nearest neighbors of each checkpoint searched for the moves and the longest segment moved by Or-opt.
+  static constexpr unsigned int NEIGHBORS_COUNT = 10;
+  static constexpr unsigned int MAX_SEGMENT_LENGTH = 3;
+
+  // The length of the edges of the virtual checkpoint to the checkpoints other than the fixed start (longer than any path).
+  static constexpr unsigned long long FIXED_START_PENALTY = 1ULL << 48;
+
+  // The number of checkpoints improved between two checks of the time limit (reading the clock is slower than a move).
+  static constexpr unsigned int STOP_CHECK_INTERVAL = 64;
+
+  // The distances between the checkpoints.
+  const DistanceMatrix* matrix = nullptr;
+
+  // Whether the tour is an open path (through the virtual checkpoint, the last ID) and the number of checkpoints (including it).
+  bool isOpen = false;
+  unsigned int size = 0;
+
+  // Whether the open path has to start from checkpoint 0.
+  bool isStartFixed = false;
+
+  // The checkpoint IDs in the order of the tour and the position of each checkpoint in it.
+  vector<unsigned int> order;
+  vector<unsigned int> positions;
+
+  // The nearest neighbors of each checkpoint (NEIGHBORS_COUNT per checkpoint, or all the others if there are fewer), closest first.
+  unsigned int neighborsCount = 0;
+  vector<unsigned int> neighbors;
+
+  // The checkpoints waiting to be improved (their don't-look bits are off) and the flags of the ones in the queue.
+  deque<unsigned int> activeCheckpoints;
+  vector<bool> isActive;
+
+  // Constructor (the nearest neighbors found after the solvers of the context should stop are replaced by the next checkpoints by ID).
+  Tour(const DistanceMatrix& _matrix, bool _isOpen, bool _isStartFixed = false, const SolverContext* context = nullptr);
+
+  // Method that builds the tour by always going to the nearest unvisited checkpoint (or, once the solvers of the context should stop, to the next one by ID).
+  void buildNearestNeighbor(const SolverContext* context = nullptr);
+
+  // Method that builds the tour by adding the shortest edges that keep it a set of paths, and then joining the paths
+  // (each to the nearest end of another path, or, once the solvers of the context should stop, to any of them).
+  void buildGreedyEdge(const SolverContext* context = nullptr);
+
+  // Method that sets the order of the checkpoints (without the virtual checkpoint).
+  void setOrder(const vector<unsigned int>& checkpointsOrder);
+
+  // Method that improves the tour with 2-opt and Or-opt moves until none of them helps (or the solvers of the context should stop). Returns the number of moves made.
+  unsigned long long improve(const SolverContext* context = nullptr);
+
+  // Method that returns the length of the tour (of the path, if it is open).
+  unsigned long long getLength() const;
+
+  // Method that returns the checkpoint IDs in the order of the tour, starting from checkpoint 0 (or along the path, if it is open, from checkpoint 0 if its start is fixed).
+  vector<unsigned int> getOrder() const;
+
+  // Method that returns the distance between two checkpoints (zero to the virtual checkpoint, unless the start is fixed).
+  unsigned long long getDistance(unsigned int i, unsigned int j) const;
+
+  // Method that returns the checkpoint after the given one in the tour.
+  unsigned int getNext(unsigned int checkpoint) const;
+
+  // Method that returns the checkpoint before the given one in the tour.
+  unsigned int getPrevious(unsigned int checkpoint) const;
+
+  // Method that finds the nearest neighbors of each checkpoint (until the solvers of the context should stop).
+  void buildNeighbors(const SolverContext* context);
+
+  // Method that closes a tour built over the real checkpoints: the virtual checkpoint of an open path replaces its longest edge
+  // (or the last edge, once the solvers of the context should stop; or the longer edge of checkpoint 0, if the start is fixed).
+  void closeTour(vector<unsigned int>& checkpointsOrder, const SolverContext* context);
+
+  // Method that tries the 2-opt moves that replace an edge of the given checkpoint, and makes the first improving one.
+  bool tryTwoOpt(unsigned int checkpoint);
+
+  // Method that tries the Or-opt moves of the segments that start at the given checkpoint, and makes the first improving one.
+  bool tryOrOpt(unsigned int checkpoint);
+
+  // Method that moves a segment (from its start forward to its end) into the edge that leaves the given checkpoint, reversed or not.
+  void makeOrOptMove(unsigned int segmentStart, unsigned int segmentEnd, unsigned int edgeStart, bool isReversed);
+
+  // Method that replaces two edges with the two edges that connect their tails and their heads (in the current direction of the tour).
+  void makeTwoOptMove(unsigned int firstFrom, unsigned int firstTo, unsigned int secondFrom, unsigned int secondTo);
+
+  // Method that reverses the part of the tour from one checkpoint to another (or the rest of the tour, whichever is shorter).
+  void reverse(unsigned int from, unsigned int to);
+
+  // Method that turns the don't-look bit of a checkpoint off.
+  void activate(unsigned int checkpoint);
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include <utility>
 #include <climits>
 #include "../../helpers/helpers.h"
+#include "../../helpers/bitboard.h"
 
 using namespace std;
 
@@ -22,26 +23,6 @@ int N, res, reslast;
 
 int m, n, maxpoints, matrix[300][300], indexes[1000], matrix2[300][300];
 
-// new function to find the accessible cells
-void ddfs(int ii, int jj) {
-  if (ii - 1 >= 0 && matrix[ii - 1][jj] == 0) {
-    matrix[ii - 1][jj] = 3;
-    ddfs(ii - 1, jj);
-  }
-  if (jj - 1 >= 0 && matrix[ii][jj - 1] == 0) {
-    matrix[ii][jj - 1] = 3;
-    ddfs(ii, jj - 1);
-  }
-  if (ii + 1 < n && matrix[ii + 1][jj] == 0) {
-    matrix[ii + 1][jj] = 3;
-    ddfs(ii + 1, jj);
-  }
-  if (jj + 1 < m && matrix[ii][jj + 1] == 0) {
-    matrix[ii][jj + 1] = 3;
-    ddfs(ii, jj + 1);
-  }
-}
-
 // generate the matrix
 void generate_matrix(int n, int m) {
   auto seed = chrono::high_resolution_clock::now().time_since_epoch().count();
@@ -55,8 +36,21 @@ void generate_matrix(int n, int m) {
       } else matrix[i][j] = 0;
     }
   }
-  //find accessible cells
-  ddfs(0, 0);
+  //find accessible cells (flood fill whole rows of the bitboard at once, marking them with 3)
+  Bitboard open(m, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j++) {
+      if (matrix[i][j] == 0)
+        open.set(j, i);
+    }
+  }
+  Bitboard accessible = floodFillBitboard(open, 0, 0);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j++) {
+      if (accessible.test(j, i))
+        matrix[i][j] = 3;
+    }
+  }
   //fill non-accessible cells with obstacles
   for (int i = 0; i < n; i++) {
     for (int j = 0; j < m; j++) {
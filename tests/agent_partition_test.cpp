@@ -0,0 +1,75 @@
+#include <random>
+#include "test.h"
+#include "../src/implementations/mga_1/structures/agent_partition/agent_partition.h"
+
+int main() {
+  mt19937 generator(11);
+  ThreadPool pool(2);
+
+  // Split random checkpoints among every number of agents, with and without a fixed start, for both objectives.
+  for (unsigned int trial = 0; trial < 120; trial++) {
+    const unsigned int checkpointsCount = 1 + (unsigned int) (generator() % 60);
+    const unsigned int agentsCount = 1 + trial % 7;
+    const bool isStartFixed = trial % 2 == 0;
+    const bool isMinMax = trial % 4 < 2;
+    const string message = to_string(checkpointsCount) + " checkpoints among " + to_string(agentsCount) + " agents" + (isStartFixed ? " from a fixed start" : "")
+                           + (isMinMax ? " (longest route)" : " (total length)");
+
+    vector<int> xs(checkpointsCount), ys(checkpointsCount);
+    for (unsigned int i = 0; i < checkpointsCount; i++) {
+      xs[i] = (int) (generator() % 100);
+      ys[i] = (int) (generator() % 100);
+    }
+    DistanceMatrix matrix(checkpointsCount, 200);
+    for (unsigned int i = 0; i < checkpointsCount; i++) {
+      for (unsigned int j = i + 1; j < checkpointsCount; j++) {
+        matrix.set(i, j, abs(xs[i] - xs[j]) + abs(ys[i] - ys[j]));
+      }
+    }
+
+    // Route every agent through its checkpoints as given (backwards, if the start is free, so that the order is not the one of the IDs).
+    AgentPartition partition(matrix, agentsCount, isStartFixed, isMinMax);
+    partition.solve(&pool, [&](const vector<unsigned int>& checkpointIds, const DistanceMatrix& agentMatrix) {
+      check(agentMatrix.size == checkpointIds.size(), message + ": the matrix of a route has another size");
+      vector<unsigned int> order(checkpointIds.size());
+      for (unsigned int i = 0; i < order.size(); i++) {
+        order[i] = isStartFixed ? i : (unsigned int) order.size() - 1 - i;
+      }
+      return order;
+    });
+
+    // Every checkpoint is on exactly one route (the fixed start begins every route), and no agent is left without checkpoints.
+    const unsigned int splitCheckpointsCount = checkpointsCount - (isStartFixed ? 1 : 0);
+    check(partition.routes.size() == max(1u, min(agentsCount, splitCheckpointsCount)), message + ": " + to_string(partition.routes.size()) + " routes");
+    vector<unsigned int> visitsCount(checkpointsCount, 0);
+    for (const vector<unsigned int>& route : partition.routes) {
+      check(!isStartFixed || (!route.empty() && route[0] == 0), message + ": a route does not begin at the fixed start");
+      check(splitCheckpointsCount == 0 || route.size() > (isStartFixed ? 1 : 0), message + ": an agent has no checkpoints");
+      for (size_t i = isStartFixed ? 1 : 0; i < route.size(); i++) {
+        check(route[i] < checkpointsCount, message + ": a route has an unknown checkpoint");
+        if (route[i] < checkpointsCount) visitsCount[route[i]]++;
+      }
+    }
+    for (unsigned int i = isStartFixed ? 1 : 0; i < checkpointsCount; i++) {
+      check(visitsCount[i] == 1, message + ": the checkpoint " + to_string(i) + " is on " + to_string(visitsCount[i]) + " routes");
+    }
+
+    // The lengths are the lengths of the open paths along the routes.
+    check(partition.lengths.size() == partition.routes.size(), message + ": the number of the lengths does not match the routes");
+    unsigned long long longestLength = 0;
+    unsigned long long totalLength = 0;
+    for (size_t agent = 0; agent < min(partition.routes.size(), partition.lengths.size()); agent++) {
+      const vector<unsigned int>& route = partition.routes[agent];
+      unsigned long long length = 0;
+      for (size_t i = 0; i + 1 < route.size(); i++) {
+        length += matrix.get(route[i], route[i + 1]);
+      }
+      check(partition.lengths[agent] == length, message + ": the length of a route does not match its checkpoints");
+      longestLength = max(longestLength, length);
+      totalLength += length;
+    }
+    check(partition.getLongestLength() == longestLength && partition.getTotalLength() == totalLength, message + ": the objective does not match the routes");
+  }
+
+  return finishTest("agent_partition_test");
+}
@@ -0,0 +1,79 @@
+#include <random>
+#include "maze_test.h"
+
+// Function that checks that the repaired distance fields equal the fields of a fresh BFS from each checkpoint.
+void checkDistanceFields(Maze& maze, const string& message) {
+  const vector<vector<unsigned int>> repairedFields = MazeTest::getCheckpointDistanceFields(maze);
+  maze.buildCheckpointDistanceFields();
+  check(MazeTest::getCheckpointDistanceFields(maze) == repairedFields, message);
+}
+
+// Function that checks that the marked paths walk through open cells, pass all the checkpoints, and are the only marks on the maze.
+void checkSolutionPaths(Maze& maze, const string& message) {
+  const vector<vector<unsigned int>>& finalMaze = MazeTest::getFinalMaze(maze);
+  const size_t height = finalMaze.size();
+  const size_t width = finalMaze[0].size();
+  vector<bool> isPathCell(width * height, false);
+  unsigned int longestLength = 0;
+  unsigned int totalLength = 0;
+  for (const vector<Cell>& path : MazeTest::getSolutionPaths(maze)) {
+    for (size_t i = 0; i < path.size(); i++) {
+      check(finalMaze[path[i].y][path[i].x] != WALL_ID, message + ": the path goes through a wall");
+      check(i == 0 || abs(path[i].x - path[i - 1].x) + abs(path[i].y - path[i - 1].y) == 1, message + ": the path jumps");
+      isPathCell[path[i].y * width + path[i].x] = true;
+    }
+    longestLength = max(longestLength, (unsigned int) (path.size() - 1));
+    totalLength += (unsigned int) (path.size() - 1);
+  }
+  for (const Cell& checkpoint : MazeTest::getSolutionCheckpoints(maze)) {
+    check(isPathCell[checkpoint.y * width + checkpoint.x], message + ": a checkpoint is not passed");
+  }
+  for (size_t y = 0; y < height; y++) {
+    for (size_t x = 0; x < width; x++) {
+      const bool isMarked = finalMaze[y][x] != WALL_ID && finalMaze[y][x] != PATH_ID;
+      check(isMarked == isPathCell[y * width + x], message + ": the marks of the paths are stale");
+    }
+  }
+  const unsigned int expectedLength = MazeTest::getAgentObjective(maze) == AgentObjective::MIN_TOTAL_LENGTH ? totalLength : longestLength;
+  check(MazeTest::getMinPathLength(maze) == expectedLength, message + ": the minimum path length does not match the paths");
+}
+
+// Function that opens the given number of walls inside the maze and then closes the given number of open cells, checking the solution after each edit.
+void editWalls(Maze& maze, unsigned int seed, unsigned int editsCount, bool isFieldChecked, const string& message) {
+  const vector<vector<unsigned int>>& finalMaze = MazeTest::getFinalMaze(maze);
+  const int height = (int) finalMaze.size();
+  const int width = (int) finalMaze[0].size();
+  mt19937 generator(seed);
+  for (bool isWall : {false, true}) {
+    unsigned int doneEditsCount = 0;
+    for (unsigned int attempt = 0; doneEditsCount < editsCount && attempt < 100 * editsCount; attempt++) {
+      const int x = 1 + (int) (generator() % (width - 2));
+      const int y = 1 + (int) (generator() % (height - 2));
+      if ((finalMaze[y][x] == WALL_ID) == isWall || !maze.setWall(x, y, isWall)) continue;
+      doneEditsCount++;
+
+      const string editMessage = message + (isWall ? " after closing (" : " after opening (") + to_string(x) + ", " + to_string(y) + ")";
+      if (isFieldChecked) checkDistanceFields(maze, editMessage);
+      checkSolutionPaths(maze, editMessage);
+    }
+    check(doneEditsCount == editsCount, message + ": too few edits were allowed");
+  }
+}
+
+int main() {
+  silenceMazePrompts();
+
+  // The distance fields of a single agent are repaired in place.
+  for (unsigned int seed = 1; seed <= 3; seed++) {
+    Maze maze(41, 41, 12, CheckpointSettingType::NUMBER, SupportedSolvingAlgorithms::GREEDY_EDGE, RouteType::OPEN_FREE_START, 1, AgentObjective::MIN_LONGEST_ROUTE, seed, "maze_editing_test");
+    editWalls(maze, seed, 40, true, "single agent, seed " + to_string(seed));
+  }
+
+  // The routes of several agents are solved again and drawn anew.
+  for (AgentObjective agentObjective : {AgentObjective::MIN_LONGEST_ROUTE, AgentObjective::MIN_TOTAL_LENGTH}) {
+    Maze maze(31, 31, 10, CheckpointSettingType::NUMBER, SupportedSolvingAlgorithms::GREEDY_EDGE, RouteType::OPEN_FREE_START, 3, agentObjective, 4 + agentObjective, "maze_editing_test");
+    editWalls(maze, 4 + agentObjective, 15, false, "three agents, objective " + to_string(agentObjective));
+  }
+
+  return finishTest("maze_editing_test");
+}
@@ -0,0 +1,59 @@
+#include <random>
+#include "maze_test.h"
+
+// Function that checks that a path leads from the start cell to the end cell through open cells, one step at a time.
+void checkPath(Maze& maze, const Path& path, Cell startCell, Cell endCell, const string& message) {
+  const vector<vector<unsigned int>>& finalMaze = MazeTest::getFinalMaze(maze);
+  check(!path.path.empty() && path.path.front() == startCell && path.path.back() == endCell, message + ": the path does not join the cells");
+  for (size_t i = 0; i < path.path.size(); i++) {
+    check(finalMaze[path.path[i].y][path.path[i].x] != WALL_ID, message + ": the path goes through a wall");
+    check(i == 0 || abs(path.path[i].x - path.path[i - 1].x) + abs(path.path[i].y - path.path[i - 1].y) == 1, message + ": the path jumps");
+  }
+}
+
+int main() {
+  silenceMazePrompts();
+
+  // Check every search algorithm against breadth-first search on perfect and braided mazes.
+  const vector<PathSearchAlgorithm> algorithms = {PathSearchAlgorithm::BIDIRECTIONAL_BREADTH_FIRST, PathSearchAlgorithm::A_STAR, PathSearchAlgorithm::JUNCTION_GRAPH, PathSearchAlgorithm::HIERARCHICAL};
+  for (unsigned int seed = 1; seed <= 3; seed++) {
+    Maze maze(61, 41, 0, CheckpointSettingType::NUMBER, SupportedSolvingAlgorithms::NONE, RouteType::OPEN_FREE_START, 1, AgentObjective::MIN_LONGEST_ROUTE, seed, "maze_search_test");
+    const vector<vector<unsigned int>>& finalMaze = MazeTest::getFinalMaze(maze);
+    const int height = (int) finalMaze.size();
+    const int width = (int) finalMaze[0].size();
+    mt19937 generator(seed);
+
+    for (unsigned int openedWallsCount : {0, 100, 400}) {
+      // Braid the maze by opening the walls between its cells.
+      for (unsigned int opened = 0; opened < openedWallsCount;) {
+        const int x = 1 + (int) (generator() % (width - 2));
+        const int y = 1 + (int) (generator() % (height - 2));
+        if (x % 2 != y % 2 && maze.setWall(x, y, false)) opened++;
+      }
+
+      // Search between random open cells.
+      vector<Cell> openCells;
+      for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+          if (finalMaze[y][x] != WALL_ID) openCells.emplace_back(x, y);
+        }
+      }
+      for (unsigned int query = 0; query < 50; query++) {
+        const Cell startCell = openCells[generator() % openCells.size()];
+        const Cell endCell = openCells[generator() % openCells.size()];
+        const SearchResult expected = maze.searchShortestPath(startCell, endCell, PathSearchAlgorithm::BREADTH_FIRST);
+        const string message = "seed " + to_string(seed) + ", " + to_string(openedWallsCount) + " opened walls, query " + to_string(query);
+        checkPath(maze, expected.path, startCell, endCell, message + ", " + Maze::getPathSearchAlgorithmName(PathSearchAlgorithm::BREADTH_FIRST));
+        for (PathSearchAlgorithm algorithm : algorithms) {
+          const SearchResult result = maze.searchShortestPath(startCell, endCell, algorithm);
+          const string algorithmMessage = message + ", " + Maze::getPathSearchAlgorithmName(algorithm);
+          checkPath(maze, result.path, startCell, endCell, algorithmMessage);
+          check(result.path.path.size() == expected.path.path.size(), algorithmMessage + ": the path is not the shortest");
+          check(startCell == endCell || result.expandedNodes > 0, algorithmMessage + ": no nodes were expanded");
+        }
+      }
+    }
+  }
+
+  return finishTest("maze_search_test");
+}
@@ -0,0 +1,29 @@
+#ifndef MAZE_TEST_H
+#define MAZE_TEST_H
+
+#include "../src/implementations/mga_1/structures/maze/maze.h"
+#include "test.h"
+
+// Class that gives the tests access to the internal structures of the maze.
+class MazeTest {
+ public:
+  // Method that returns the cells of the maze.
+  static vector<vector<unsigned int>>& getFinalMaze(Maze& maze) { return maze.finalMaze; }
+
+  // Method that returns the checkpoints of the kept solution.
+  static const vector<Cell>& getSolutionCheckpoints(const Maze& maze) { return maze.solutionCheckpoints; }
+
+  // Method that returns the kept paths of the agents.
+  static const vector<vector<Cell>>& getSolutionPaths(const Maze& maze) { return maze.solutionPaths; }
+
+  // Method that returns the distance field of each checkpoint.
+  static const vector<vector<unsigned int>>& getCheckpointDistanceFields(const Maze& maze) { return maze.checkpointDistanceFields; }
+
+  // Method that returns the minimum path length.
+  static unsigned int getMinPathLength(const Maze& maze) { return maze.minPathLength; }
+
+  // Method that returns the agent objective.
+  static AgentObjective getAgentObjective(const Maze& maze) { return maze.agentObjective; }
+};
+
+#endif
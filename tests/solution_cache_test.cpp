@@ -0,0 +1,136 @@
+#include <random>
+#include "test.h"
+#include "../src/implementations/mga_1/structures/solution_cache/solution_cache.h"
+
+// The prefix of the cache files written by the test.
+const string CACHE_FILE_PREFIX = "solution_cache_test_";
+
+// Function that fills a cache with a matrix, the predecessors of every checkpoint and two routes.
+void fillCache(SolutionCache& cache, unsigned int checkpointsCount, unsigned long long maxDistance, mt19937& generator) {
+  DistanceMatrix matrix(checkpointsCount, maxDistance);
+  for (unsigned int i = 0; i < checkpointsCount; i++) {
+    for (unsigned int j = i + 1; j < checkpointsCount; j++) {
+      matrix.set(i, j, (unsigned int) (generator() % maxDistance));
+    }
+  }
+  vector<vector<unsigned int>> nodeDistances(checkpointsCount);
+  vector<vector<int>> predecessorCorridors(checkpointsCount);
+  for (unsigned int i = 0; i < checkpointsCount; i++) {
+    for (unsigned int node = 0; node < 20; node++) {
+      nodeDistances[i].push_back((unsigned int) (generator() % 1000));
+      predecessorCorridors[i].push_back((int) (generator() % 40) - 1);
+    }
+  }
+  cache.setMatrix(matrix, nodeDistances, predecessorCorridors);
+
+  vector<unsigned int> order(checkpointsCount);
+  for (unsigned int i = 0; i < checkpointsCount; i++) order[i] = i;
+  shuffle(order.begin(), order.end(), generator);
+  cache.storeTour({RouteType::CLOSED_TOUR, SupportedSolvingAlgorithms::HELD_KARP, true, 1234, order});
+  shuffle(order.begin(), order.end(), generator);
+  cache.storeTour({RouteType::OPEN_FREE_START, SupportedSolvingAlgorithms::GREEDY_EDGE, false, 5678, order});
+}
+
+// Function that checks that a loaded cache holds the same results as the saved one.
+void checkLoadedCache(const SolutionCache& saved, const SolutionCache& loaded, const string& message) {
+  check(loaded.hasMatrix == saved.hasMatrix, message + ": the matrix was not loaded");
+  if (loaded.hasMatrix && saved.hasMatrix) {
+    check(loaded.matrix.size == saved.matrix.size && loaded.matrix.isCompact == saved.matrix.isCompact, message + ": the matrix has another size or storage");
+    bool areDistancesEqual = loaded.matrix.size == saved.matrix.size;
+    for (unsigned int i = 0; areDistancesEqual && i < saved.matrix.size; i++) {
+      for (unsigned int j = 0; j < saved.matrix.size; j++) {
+        if (loaded.matrix.get(i, j) != saved.matrix.get(i, j)) areDistancesEqual = false;
+      }
+    }
+    check(areDistancesEqual, message + ": the distances changed");
+  }
+  check(loaded.nodeDistances == saved.nodeDistances && loaded.predecessorCorridors == saved.predecessorCorridors, message + ": the predecessors changed");
+  check(loaded.tours.size() == saved.tours.size(), message + ": the number of the routes changed");
+  for (size_t t = 0; t < min(loaded.tours.size(), saved.tours.size()); t++) {
+    const SolutionCache::CachedTour& loadedTour = loaded.tours[t];
+    const SolutionCache::CachedTour& savedTour = saved.tours[t];
+    check(loadedTour.routeType == savedTour.routeType && loadedTour.solvingAlgorithm == savedTour.solvingAlgorithm && loadedTour.isOptimal == savedTour.isOptimal
+          && loadedTour.length == savedTour.length && loadedTour.order == savedTour.order, message + ": the route " + to_string(t) + " changed");
+  }
+}
+
+int main() {
+  mt19937 generator(7);
+
+  // Build a maze and its checkpoints (the cache only hashes them).
+  vector<vector<unsigned int>> maze(15, vector<unsigned int>(21, PATH_ID));
+  for (auto& row : maze) {
+    for (unsigned int& cell : row) {
+      if (generator() % 4 == 0) cell = WALL_ID;
+    }
+  }
+  vector<Cell> checkpoints;
+  for (int i = 0; i < 9; i++) {
+    checkpoints.emplace_back(2 * i + 1, i + 2);
+  }
+
+  // Save and load a cache with a 16-bit and with a 32-bit matrix.
+  for (unsigned long long maxDistance : {1000ULL, 1ULL << 20}) {
+    const string message = "matrix of distances below " + to_string(maxDistance);
+    SolutionCache savedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    fillCache(savedCache, (unsigned int) checkpoints.size(), maxDistance, generator);
+    check(savedCache.matrix.isCompact == (maxDistance < UINT16_MAX), message + ": the matrix has another storage");
+    check(savedCache.save(), message + ": the cache file could not be written");
+
+    SolutionCache loadedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    check(loadedCache.load(), message + ": the cache file could not be read");
+    checkLoadedCache(savedCache, loadedCache, message);
+
+    // A cached route is found by its algorithm, and a proven optimal one by any algorithm.
+    const SolutionCache::CachedTour* optimalTour = loadedCache.findTour(RouteType::CLOSED_TOUR, SupportedSolvingAlgorithms::ANYTIME);
+    check(optimalTour != nullptr && optimalTour->length == 1234, message + ": the optimal route was not found");
+    check(loadedCache.findTour(RouteType::OPEN_FREE_START, SupportedSolvingAlgorithms::ANYTIME) == nullptr, message + ": a route of another algorithm was found");
+
+    // A file that ends early is ignored.
+    filesystem::resize_file(savedCache.filePath, filesystem::file_size(savedCache.filePath) - 1);
+    SolutionCache truncatedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    check(!truncatedCache.load(), message + ": a truncated cache file was read");
+    remove(savedCache.filePath.c_str());
+  }
+
+  // The file of other checkpoints is not read.
+  {
+    SolutionCache savedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    fillCache(savedCache, (unsigned int) checkpoints.size(), 1000, generator);
+    check(savedCache.save(), "other checkpoints: the cache file could not be written");
+    vector<Cell> otherCheckpoints = checkpoints;
+    otherCheckpoints[0] = Cell(0, 0);
+    SolutionCache otherCache(maze, otherCheckpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    check(otherCache.filePath != savedCache.filePath && !otherCache.load(), "other checkpoints: the cache file of other checkpoints was read");
+    remove(savedCache.filePath.c_str());
+  }
+
+  // A file that would not fit the cache leaves out the predecessors first.
+  {
+    SolutionCache savedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 0);
+    fillCache(savedCache, (unsigned int) checkpoints.size(), 1000, generator);
+    savedCache.maxBytes = savedCache.getFileBytes(true, false);
+    check(savedCache.save(), "bounded cache: the cache file could not be written");
+    SolutionCache loadedCache(maze, checkpoints, CACHE_FILE_PREFIX, 8, 1ULL << 20);
+    check(loadedCache.load(), "bounded cache: the cache file could not be read");
+    check(loadedCache.hasMatrix && loadedCache.nodeDistances.empty() && loadedCache.tours.size() == savedCache.tours.size(), "bounded cache: the file did not leave out only the predecessors");
+    remove(savedCache.filePath.c_str());
+  }
+
+  // Writing a file removes the least recently used ones beyond the number of the files.
+  {
+    SolutionCache firstCache(maze, checkpoints, CACHE_FILE_PREFIX, 1, 1ULL << 20);
+    fillCache(firstCache, (unsigned int) checkpoints.size(), 1000, generator);
+    check(firstCache.save(), "eviction: the first cache file could not be written");
+    vector<Cell> otherCheckpoints = checkpoints;
+    otherCheckpoints.pop_back();
+    SolutionCache secondCache(maze, otherCheckpoints, CACHE_FILE_PREFIX, 1, 1ULL << 20);
+    fillCache(secondCache, (unsigned int) otherCheckpoints.size(), 1000, generator);
+    check(secondCache.save(), "eviction: the second cache file could not be written");
+    check(!filesystem::exists(firstCache.filePath) && filesystem::exists(secondCache.filePath), "eviction: the older cache file was not removed");
+    remove(firstCache.filePath.c_str());
+    remove(secondCache.filePath.c_str());
+  }
+
+  return finishTest("solution_cache_test");
+}
@@ -0,0 +1,37 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Function that returns the number of the failed checks of the test.
+inline unsigned int& getFailedChecksCount() {
+  static unsigned int failedChecksCount = 0;
+  return failedChecksCount;
+}
+
+// Function that checks a condition and reports it if it does not hold (the test fails if any check fails).
+inline void check(bool condition, const string& message) {
+  if (!condition) {
+    cerr << "FAILED: " << message << "\n";
+    getFailedChecksCount()++;
+  }
+}
+
+// Function that answers the prompts of the maze with the "Enter" key and hides its output.
+inline void silenceMazePrompts() {
+  static istringstream input(string(1024, '\n'));
+  cin.rdbuf(input.rdbuf());
+  cout.rdbuf(nullptr);
+}
+
+// Function that reports the result of the test and returns its exit code.
+inline int finishTest(const string& testName) {
+  cerr << testName << ": " << (getFailedChecksCount() == 0 ? "passed" : to_string(getFailedChecksCount()) + " checks failed") << "\n";
+  return getFailedChecksCount() == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <unistd.h>
+#include "maze_test.h"
+#include "../src/implementations/mga_1/structures/held_karp/held_karp.h"
+#include "../src/implementations/mga_1/structures/brute_force/brute_force.h"
+#include "../src/implementations/mga_1/structures/branch_and_bound/branch_and_bound.h"
+#include "../src/implementations/mga_1/structures/steiner_tree/steiner_tree.h"
+#include "../src/implementations/mga_1/structures/tour/tour.h"
+
+// Function that returns the length of an order of the checkpoints (with the way back to the first checkpoint, if the route is closed).
+template<typename GetDistance>
+unsigned long long getOrderLength(const vector<unsigned int>& order, bool isOpen, GetDistance getDistance) {
+  unsigned long long length = 0;
+  for (size_t i = 0; i + 1 < order.size(); i++) {
+    length += getDistance(order[i], order[i + 1]);
+  }
+  if (!isOpen && order.size() > 1) length += getDistance(order.back(), order[0]);
+  return length;
+}
+
+// Function that finds the length of the shortest route by trying every order of the checkpoints.
+template<typename GetDistance>
+unsigned long long getEnumeratedLength(unsigned int size, bool isOpen, bool isStartFixed, GetDistance getDistance) {
+  vector<unsigned int> order(size);
+  iota(order.begin(), order.end(), 0);
+  unsigned long long shortestLength = ULLONG_MAX;
+  do {
+    // A closed route and a route with a fixed start begin at checkpoint 0.
+    if ((!isOpen || isStartFixed) && order[0] != 0) continue;
+    shortestLength = min(shortestLength, getOrderLength(order, isOpen, getDistance));
+  } while (next_permutation(order.begin(), order.end()));
+  return shortestLength;
+}
+
+// Function that checks that a solver returned an order of all the checkpoints of the shortest length (starting from checkpoint 0, if it is fixed).
+template<typename GetDistance>
+void checkOrder(const vector<unsigned int>& order, unsigned long long length, unsigned int size, bool isOpen, bool isStartFixed, unsigned long long shortestLength,
+                GetDistance getDistance, const string& message) {
+  vector<unsigned int> sortedOrder = order;
+  sort(sortedOrder.begin(), sortedOrder.end());
+  vector<unsigned int> checkpointIds(size);
+  iota(checkpointIds.begin(), checkpointIds.end(), 0);
+  check(sortedOrder == checkpointIds, message + ": the order does not visit every checkpoint once");
+  check(!isStartFixed || order.empty() || order[0] == 0, message + ": the order does not start from the fixed start");
+  check(getOrderLength(order, isOpen, getDistance) == length, message + ": the length does not match the order");
+  check(length == shortestLength, message + ": " + to_string(length) + " instead of the shortest " + to_string(shortestLength));
+}
+
+int main() {
+  silenceMazePrompts();
+  ThreadPool pool(2);
+
+  // Check the exact solvers against the enumeration of all the orders on random matrices, for every route type.
+  mt19937 generator(42);
+  for (unsigned int trial = 0; trial < 60; trial++) {
+    const unsigned int size = 1 + trial % 8;
+    const bool isOpen = trial % 3 != 0;
+    const bool isStartFixed = trial % 3 == 2;
+    const string routeName = string(isOpen ? (isStartFixed ? "fixed start" : "free start") : "closed") + " route of " + to_string(size) + " checkpoints";
+
+    // Points on a grid with some noise, so that the triangle inequality mostly holds, as it does in a maze.
+    vector<int> xs(size), ys(size);
+    for (unsigned int i = 0; i < size; i++) {
+      xs[i] = (int) (generator() % 50);
+      ys[i] = (int) (generator() % 50);
+    }
+    DistanceMatrix matrix(size, 200);
+    for (unsigned int i = 0; i < size; i++) {
+      for (unsigned int j = i + 1; j < size; j++) {
+        matrix.set(i, j, abs(xs[i] - xs[j]) + abs(ys[i] - ys[j]) + generator() % 3);
+      }
+    }
+    auto getDistance = [&](unsigned int i, unsigned int j) { return (unsigned long long) matrix.get(i, j); };
+    const unsigned long long shortestLength = getEnumeratedLength(size, isOpen, isStartFixed, getDistance);
+
+    HeldKarp heldKarp(matrix, isOpen, isStartFixed);
+    heldKarp.solve();
+    checkOrder(heldKarp.getOrder(), heldKarp.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance, "Held-Karp, " + routeName);
+
+    HeldKarp parallelHeldKarp(matrix, isOpen, isStartFixed);
+    parallelHeldKarp.solve(&pool);
+    checkOrder(parallelHeldKarp.getOrder(), parallelHeldKarp.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance, "parallel Held-Karp, " + routeName);
+
+    HeldKarp outOfCoreHeldKarp(matrix, isOpen, isStartFixed);
+    const string tableFilePath = "tsp_solvers_test_" + to_string(trial) + ".table";
+    check(outOfCoreHeldKarp.mapTable(tableFilePath), "out-of-core Held-Karp, " + routeName + ": the table file could not be mapped");
+    outOfCoreHeldKarp.solve(&pool);
+    checkOrder(outOfCoreHeldKarp.getOrder(), outOfCoreHeldKarp.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance, "out-of-core Held-Karp, " + routeName);
+    unlink(tableFilePath.c_str());
+
+    BruteForce bruteForce(matrix, isOpen, isStartFixed);
+    bruteForce.solve(&pool);
+    checkOrder(bruteForce.getOrder(), bruteForce.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance, "brute force, " + routeName);
+
+    // Branch and bound on its own, and from the tour of the local search (as the maze runs it).
+    BranchAndBound branchAndBound(matrix, isOpen, isStartFixed);
+    branchAndBound.solve(&pool);
+    checkOrder(branchAndBound.getOrder(), branchAndBound.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance, "branch and bound, " + routeName);
+
+    Tour tour(matrix, isOpen, isStartFixed);
+    tour.buildGreedyEdge();
+    tour.improve();
+    BranchAndBound seededBranchAndBound(matrix, isOpen, isStartFixed);
+    seededBranchAndBound.setIncumbent(tour.order);
+    seededBranchAndBound.solve(&pool);
+    checkOrder(seededBranchAndBound.getOrder(), seededBranchAndBound.getLength(), size, isOpen, isStartFixed, shortestLength, getDistance,
+               "branch and bound from a tour, " + routeName);
+  }
+
+  // Check the Steiner tree solver against the enumeration of all the orders on perfect mazes.
+  for (unsigned int seed = 1; seed <= 4; seed++) {
+    Maze maze(41, 31, 0, CheckpointSettingType::NUMBER, SupportedSolvingAlgorithms::NONE, RouteType::OPEN_FREE_START, 1, AgentObjective::MIN_LONGEST_ROUTE, seed, "tsp_solvers_test");
+    const vector<vector<unsigned int>>& finalMaze = MazeTest::getFinalMaze(maze);
+    const DistanceOracle oracle(finalMaze);
+    check(oracle.isTree, "Steiner tree: the generated maze is not perfect");
+    vector<Cell> openCells;
+    for (int y = 0; y < (int) finalMaze.size(); y++) {
+      for (int x = 0; x < (int) finalMaze[y].size(); x++) {
+        if (finalMaze[y][x] != WALL_ID) openCells.emplace_back(x, y);
+      }
+    }
+
+    for (unsigned int size = 1; size <= 8; size++) {
+      shuffle(openCells.begin(), openCells.end(), generator);
+      const vector<Cell> checkpoints(openCells.begin(), openCells.begin() + size);
+      auto getDistance = [&](unsigned int i, unsigned int j) { return (unsigned long long) oracle.getDistance(checkpoints[i], checkpoints[j]); };
+      const string routeName = "route of " + to_string(size) + " checkpoints (seed " + to_string(seed) + ")";
+
+      for (bool isStartFixed : {false, true}) {
+        SteinerTree steinerTree(oracle, checkpoints, isStartFixed);
+        steinerTree.solve();
+        checkOrder(steinerTree.order, steinerTree.length, size, true, isStartFixed, getEnumeratedLength(size, true, isStartFixed, getDistance), getDistance,
+                   string("Steiner tree, ") + (isStartFixed ? "fixed start " : "free start ") + routeName);
+        check(steinerTree.getClosedLength() == getEnumeratedLength(size, false, false, getDistance), "Steiner tree, closed " + routeName + ": the closed length is not the shortest");
+      }
+    }
+  }
+
+  return finishTest("tsp_solvers_test");
+}